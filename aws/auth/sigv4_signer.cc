@@ -0,0 +1,156 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <aws/auth/sigv4_signer.h>
+
+#include <ctime>
+
+#include <openssl/hmac.h>
+#include <openssl/sha.h>
+
+#include <aws/mutex.h>
+#include <aws/utils/utils.h>
+
+namespace aws {
+namespace auth {
+
+namespace {
+
+const char kAlgorithm[] = "AWS4-HMAC-SHA256";
+
+std::string sha256_hex(boost::string_ref data) {
+  unsigned char digest[SHA256_DIGEST_LENGTH];
+  SHA256((const unsigned char*) data.data(), data.size(), digest);
+  return aws::utils::hex(digest, sizeof(digest));
+}
+
+std::string hmac(const std::string& key, const std::string& data) {
+  unsigned char digest[EVP_MAX_MD_SIZE];
+  unsigned int len = 0;
+  HMAC(EVP_sha256(),
+       key.data(),
+       (int) key.size(),
+       (const unsigned char*) data.data(),
+       data.size(),
+       digest,
+       &len);
+  return std::string((const char*) digest, len);
+}
+
+} //namespace
+
+SigV4Signer::SigV4Signer(std::string region, std::string service)
+    : region_(std::move(region)),
+      service_(std::move(service)) {}
+
+std::string SigV4Signer::authorization(const std::string& method,
+                                       const std::string& path,
+                                       const std::string& query,
+                                       const Headers& headers,
+                                       boost::string_ref payload,
+                                       const Aws::Auth::AWSCredentials& creds,
+                                       const std::string& amz_date) {
+  std::string signed_headers;
+  std::string canonical;
+  canonical.reserve(512);
+  canonical += method;
+  canonical += '\n';
+  canonical += path;
+  canonical += '\n';
+  canonical += query;
+  canonical += '\n';
+  for (auto& h : headers) {
+    canonical += h.first;
+    canonical += ':';
+    canonical += h.second;
+    canonical += '\n';
+    if (!signed_headers.empty()) {
+      signed_headers += ';';
+    }
+    signed_headers += h.first;
+  }
+  canonical += '\n';
+  canonical += signed_headers;
+  canonical += '\n';
+  canonical += sha256_hex(payload);
+
+  auto date = amz_date.substr(0, 8);
+  auto scope = date + "/" + region_ + "/" + service_ + "/aws4_request";
+
+  std::string to_sign;
+  to_sign.reserve(256);
+  to_sign += kAlgorithm;
+  to_sign += '\n';
+  to_sign += amz_date;
+  to_sign += '\n';
+  to_sign += scope;
+  to_sign += '\n';
+  to_sign += sha256_hex(canonical);
+
+  auto key = cached_signing_key(creds.GetAWSSecretKey(), date);
+  auto signature = hmac(key, to_sign);
+
+  std::string auth;
+  auth.reserve(256);
+  auth += kAlgorithm;
+  auth += " Credential=";
+  auth += creds.GetAWSAccessKeyId();
+  auth += '/';
+  auth += scope;
+  auth += ", SignedHeaders=";
+  auth += signed_headers;
+  auth += ", Signature=";
+  auth += aws::utils::hex((const unsigned char*) signature.data(),
+                          signature.size());
+  return auth;
+}
+
+std::string SigV4Signer::amz_date(std::chrono::system_clock::time_point t) {
+  auto tt = std::chrono::system_clock::to_time_t(t);
+  std::tm tm;
+  ::gmtime_r(&tt, &tm);
+  char buf[32];
+  std::strftime(buf, sizeof(buf), "%Y%m%dT%H%M%SZ", &tm);
+  return buf;
+}
+
+std::string SigV4Signer::signing_key(const std::string& secret_key,
+                                     const std::string& date,
+                                     const std::string& region,
+                                     const std::string& service) {
+  auto k = hmac("AWS4" + secret_key, date);
+  k = hmac(k, region);
+  k = hmac(k, service);
+  return hmac(k, "aws4_request");
+}
+
+std::string SigV4Signer::cached_signing_key(const std::string& secret_key,
+                                            const std::string& date) {
+  {
+    aws::lock_guard<aws::utils::SpinLock> lk(mutex_);
+    if (key_date_ == date && key_secret_ == secret_key) {
+      return key_;
+    }
+  }
+  auto key = signing_key(secret_key, date, region_, service_);
+  aws::lock_guard<aws::utils::SpinLock> lk(mutex_);
+  key_secret_ = secret_key;
+  key_date_ = date;
+  key_ = key;
+  return key;
+}
+
+} //namespace auth
+} //namespace aws
@@ -0,0 +1,84 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_AUTH_SIGV4_SIGNER_H_
+#define AWS_AUTH_SIGV4_SIGNER_H_
+
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+#include <boost/utility/string_ref.hpp>
+
+#include <aws/core/auth/AWSCredentialsProvider.h>
+#include <aws/utils/spin_lock.h>
+
+namespace aws {
+namespace auth {
+
+// Signs requests for one region and service with AWS Signature Version 4.
+//
+// The signing key only depends on the date and the secret key, so it's
+// derived once and reused until either changes, leaving two hashes and one
+// HMAC per request.
+//
+// Threadsafe.
+class SigV4Signer : boost::noncopyable {
+ public:
+  // Lower case names, sorted by name, with values trimmed.
+  using Headers = std::vector<std::pair<std::string, std::string>>;
+
+  SigV4Signer(std::string region, std::string service);
+
+  // Returns the value of the Authorization header for the request. headers
+  // are the ones to sign, and must include host and x-amz-date; amz_date is
+  // the value of the latter.
+  std::string authorization(const std::string& method,
+                            const std::string& path,
+                            const std::string& query,
+                            const Headers& headers,
+                            boost::string_ref payload,
+                            const Aws::Auth::AWSCredentials& creds,
+                            const std::string& amz_date);
+
+  // Formats t the way X-Amz-Date wants it, e.g. 20150830T123600Z.
+  static std::string amz_date(std::chrono::system_clock::time_point t);
+
+  // The raw bytes of the key requests made on date (e.g. 20150830) are
+  // signed with.
+  static std::string signing_key(const std::string& secret_key,
+                                 const std::string& date,
+                                 const std::string& region,
+                                 const std::string& service);
+
+ private:
+  std::string cached_signing_key(const std::string& secret_key,
+                                 const std::string& date);
+
+  const std::string region_;
+  const std::string service_;
+
+  aws::utils::SpinLock mutex_;
+  std::string key_secret_;
+  std::string key_date_;
+  std::string key_;
+};
+
+} //namespace auth
+} //namespace aws
+
+#endif //AWS_AUTH_SIGV4_SIGNER_H_
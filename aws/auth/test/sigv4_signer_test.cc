@@ -0,0 +1,107 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <aws/auth/sigv4_signer.h>
+#include <aws/utils/utils.h>
+
+namespace {
+
+// The credentials and date of the AWS Signature Version 4 test suite.
+const Aws::Auth::AWSCredentials kCreds(
+    "AKIDEXAMPLE",
+    "wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY");
+
+const std::string kDate = "20150830T123600Z";
+
+const std::string kPrefix =
+    "AWS4-HMAC-SHA256 Credential=AKIDEXAMPLE/20150830/us-east-1/service/"
+    "aws4_request, ";
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(SigV4Signer)
+
+// From the Signature Version 4 documentation
+BOOST_AUTO_TEST_CASE(SigningKey) {
+  auto key = aws::auth::SigV4Signer::signing_key(
+      "wJalrXUtnFEMI/K7MDENG+bPxRfiCYEXAMPLEKEY",
+      "20120215",
+      "us-east-1",
+      "iam");
+  BOOST_CHECK_EQUAL(
+      aws::utils::hex((const unsigned char*) key.data(), key.size()),
+      "f4780e2d9f65fa895f9c67b32ce1baf0b0d8a43505a000a1a9e090d414db404d");
+}
+
+// get-vanilla, post-vanilla and post-x-www-form-urlencoded from the test
+// suite
+BOOST_AUTO_TEST_CASE(TestSuite) {
+  aws::auth::SigV4Signer signer("us-east-1", "service");
+  aws::auth::SigV4Signer::Headers headers = {
+    { "host", "example.amazonaws.com" },
+    { "x-amz-date", kDate }
+  };
+
+  BOOST_CHECK_EQUAL(
+      signer.authorization("GET", "/", "", headers, "", kCreds, kDate),
+      kPrefix + "SignedHeaders=host;x-amz-date, Signature="
+          "5fa00fa31553b73ebf1942676e86291e8372ff2a2260956d9b8aae1d763fbf31");
+
+  BOOST_CHECK_EQUAL(
+      signer.authorization("POST", "/", "", headers, "", kCreds, kDate),
+      kPrefix + "SignedHeaders=host;x-amz-date, Signature="
+          "5da7c1a2acd57cee7505fc6676e4e544621c30862966e37dddb68e92efbe5d6b");
+
+  headers.insert(headers.begin(),
+                 { "content-type", "application/x-www-form-urlencoded" });
+  BOOST_CHECK_EQUAL(
+      signer.authorization("POST", "/", "", headers, "Param1=value1", kCreds,
+                           kDate),
+      kPrefix + "SignedHeaders=content-type;host;x-amz-date, Signature="
+          "ff11897932ad3f4e8b18135d722051e5ac45fc38421b1da7b9d196a0fe09473a");
+}
+
+// The cached key has to be replaced when the day or the secret key changes.
+BOOST_AUTO_TEST_CASE(KeyRotation) {
+  aws::auth::SigV4Signer signer("us-east-1", "service");
+  aws::auth::SigV4Signer::Headers headers = {
+    { "host", "example.amazonaws.com" },
+    { "x-amz-date", kDate }
+  };
+  auto a = signer.authorization("GET", "/", "", headers, "", kCreds, kDate);
+
+  Aws::Auth::AWSCredentials other("AKIDEXAMPLE", "other");
+  auto b = signer.authorization("GET", "/", "", headers, "", other, kDate);
+  BOOST_CHECK(a != b);
+
+  std::string next_day = "20150831T123600Z";
+  headers[1].second = next_day;
+  auto c = signer.authorization("GET", "/", "", headers, "", kCreds, next_day);
+  BOOST_CHECK(c.find("/20150831/") != std::string::npos);
+
+  headers[1].second = kDate;
+  BOOST_CHECK_EQUAL(
+      signer.authorization("GET", "/", "", headers, "", kCreds, kDate), a);
+}
+
+BOOST_AUTO_TEST_CASE(AmzDate) {
+  // 2015-08-30 12:36:00 UTC
+  auto t = std::chrono::system_clock::from_time_t(1440938160);
+  BOOST_CHECK_EQUAL(aws::auth::SigV4Signer::amz_date(t), kDate);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,111 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_KINESIS_CORE_ADAPTIVE_LINGER_H_
+#define AWS_KINESIS_CORE_ADAPTIVE_LINGER_H_
+
+#include <algorithm>
+#include <chrono>
+
+#include <boost/noncopyable.hpp>
+
+#include <aws/utils/spin_lock.h>
+#include <aws/utils/utils.h>
+#include <aws/mutex.h>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+// Decides how long the records of one shard wait to be aggregated, from the
+// rate they have been arriving at.
+//
+// Waiting only pays off if more records arrive in the meantime. When records
+// are on average further apart than the longest allowed wait, a record would
+// most likely be sent alone anyway, so it doesn't wait at all. Otherwise it
+// waits twice as long as an aggregated record is expected to take to fill,
+// up to the longest allowed wait. A record that fills the aggregated record
+// has it sent right away regardless; the allowance is for arrivals slowing
+// down.
+//
+// All methods are threadsafe.
+class AdaptiveLinger : boost::noncopyable {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using TimePoint = Clock::time_point;
+
+  // Weight of the newest sample in the moving averages.
+  static constexpr const double kWeight = 0.2;
+
+  static constexpr const double kFillAllowance = 2;
+
+  // Notes the arrival of a record of the given size, and returns how long it
+  // should wait for others to be aggregated with. count_limit and size_limit
+  // are those of the aggregated record.
+  Clock::duration arrived(size_t bytes,
+                          size_t count_limit,
+                          size_t size_limit,
+                          Clock::duration max_wait,
+                          TimePoint now = Clock::now()) {
+    aws::lock_guard<aws::utils::SpinLock> lk(mutex_);
+
+    if (!has_last_) {
+      has_last_ = true;
+      last_ = now;
+      mean_bytes_ = bytes;
+      return max_wait;
+    }
+
+    // Anything past the longest wait counts as idle; capping the gap lets
+    // the average recover quickly when records start flowing again.
+    double max_seconds = std::chrono::duration<double>(max_wait).count();
+    double gap = std::max(
+        0.0,
+        std::min(aws::utils::seconds_between(last_, now), 2 * max_seconds));
+    last_ = std::max(last_, now);
+    if (!has_gap_) {
+      has_gap_ = true;
+      mean_gap_ = gap;
+    } else {
+      mean_gap_ += kWeight * (gap - mean_gap_);
+    }
+    mean_bytes_ += kWeight * (bytes - mean_bytes_);
+
+    if (mean_gap_ >= max_seconds) {
+      return Clock::duration::zero();
+    }
+
+    double records_to_fill =
+        std::min((double) count_limit, size_limit / std::max(mean_bytes_, 1.0));
+    double wait = std::min(max_seconds,
+                           kFillAllowance * records_to_fill * mean_gap_);
+    return std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(wait));
+  }
+
+ private:
+  aws::utils::SpinLock mutex_;
+  bool has_last_ = false;
+  bool has_gap_ = false;
+  TimePoint last_;
+  double mean_gap_ = 0;
+  double mean_bytes_ = 0;
+};
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
+
+#endif //AWS_KINESIS_CORE_ADAPTIVE_LINGER_H_
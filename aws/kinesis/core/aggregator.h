@@ -20,6 +20,7 @@
 #include <mutex>
 #include <vector>
 
+#include <aws/kinesis/core/adaptive_linger.h>
 #include <aws/kinesis/core/shard_map.h>
 #include <aws/kinesis/core/kinesis_record.h>
 #include <aws/kinesis/core/reducer.h>
@@ -53,7 +54,8 @@ class Aggregator : boost::noncopyable {
         config_(config),
         flush_stats_(flush_stats),
         metrics_manager_(metrics_manager),
-        reducers_([this](auto) { return this->make_reducer(); }) {}
+        reducers_([this](auto) { return this->make_reducer(); }),
+        lingers_([](auto) { return new AdaptiveLinger(); }) {}
 
   std::shared_ptr<KinesisRecord> put(const std::shared_ptr<UserRecord>& ur) {
     // If shard map is not available, or aggregation is disabled, just send the
@@ -71,6 +73,9 @@ class Aggregator : boost::noncopyable {
       return kr;
     } else {
       ur->predicted_shard(*shard_id);
+      if (config_->adaptive_linger()) {
+        adapt_deadline(ur, *shard_id);
+      }
       return reducers_[*shard_id].add(ur);
     }
   }
@@ -80,14 +85,41 @@ class Aggregator : boost::noncopyable {
     reducers_.foreach([](auto&, auto v) { v->flush(); });
   }
 
+  // Applies the aggregation limits currently in the configuration to the
+  // existing reducers; new reducers pick them up when created.
+  void update_limits() {
+    auto t = config_->snapshot();
+    auto size_limit = t.aggregation_max_size;
+    auto count_limit = t.aggregation_max_count;
+    reducers_.foreach([=](auto&, auto v) {
+      v->set_limits(size_limit, count_limit);
+    });
+  }
+
  private:
+  // Brings the record's deadline forward to the wait its shard's recent
+  // traffic calls for.
+  void adapt_deadline(const std::shared_ptr<UserRecord>& ur,
+                      uint64_t shard_id) {
+    auto now = Clock::now();
+    auto t = config_->snapshot();
+    auto wait = lingers_[shard_id].arrived(
+        ur->partition_key().size() + ur->data().size(),
+        t.aggregation_max_count,
+        t.aggregation_max_size,
+        std::chrono::milliseconds(t.record_max_buffered_time),
+        now);
+    ur->set_deadline(std::min(ur->deadline(), now + wait));
+  }
+
   // This cannot be inlined in the lambda because msvc cannot compile that
   Reducer<UserRecord, KinesisRecord>* make_reducer() {
+    auto t = config_->snapshot();
     return new Reducer<UserRecord, KinesisRecord>(
         executor_,
         deadline_callback_,
-        config_->aggregation_max_size(),
-        config_->aggregation_max_count(),
+        t.aggregation_max_size,
+        t.aggregation_max_count,
         flush_stats_
     );
   }
@@ -99,6 +131,7 @@ class Aggregator : boost::noncopyable {
   std::shared_ptr<aws::metrics::MetricsManager> metrics_manager_;
   aws::utils::flush_statistics_aggregator& flush_stats_;
   ReducerMap reducers_;
+  aws::utils::ConcurrentHashMap<uint64_t, AdaptiveLinger> lingers_;
 };
 
 } //namespace core
@@ -16,9 +16,17 @@
 #ifndef AWS_KINESIS_CORE_COLLECTOR_H_
 #define AWS_KINESIS_CORE_COLLECTOR_H_
 
+#include <algorithm>
+#include <iterator>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include <aws/kinesis/core/put_records_request.h>
 #include <aws/kinesis/core/reducer.h>
 #include <aws/kinesis/core/configuration.h>
+#include <aws/metrics/metrics_manager.h>
+#include <aws/mutex.h>
 #include <aws/utils/concurrent_hash_map.h>
 #include <aws/utils/processing_statistics_logger.h>
 
@@ -26,19 +34,34 @@ namespace aws {
 namespace kinesis {
 namespace core {
 
+// Collects KinesisRecords into PutRecordsRequests.
+//
+// With shard_max_in_flight set, a request only takes records for a shard while
+// fewer than that many requests with records for the shard are in flight, and
+// none of the shard's records are held back. The other records are held back
+// in order, and sent in requests of their own as request_completed is called
+// for the shard's requests. Held records that expire are given to the expired
+// callback instead. The limit can change at any time; while it is 0 and
+// nothing is in flight or held, none of this bookkeeping is done.
 class Collector : boost::noncopyable {
  public:
   using FlushCallback =
       std::function<void (std::shared_ptr<PutRecordsRequest>)>;
+  using ExpiredCallback =
+      std::function<void (const std::shared_ptr<KinesisRecord>&)>;
 
   Collector(
       const std::shared_ptr<aws::utils::Executor>& executor,
       const FlushCallback& flush_callback,
+      const ExpiredCallback& expired_callback,
       const std::shared_ptr<aws::kinesis::core::Configuration>& config,
       aws::utils::flush_statistics_aggregator& flush_stats,
       const std::shared_ptr<aws::metrics::MetricsManager>& metrics_manager =
           std::make_shared<aws::metrics::NullMetricsManager>())
-      : flush_callback_(flush_callback),
+      : executor_(executor),
+        flush_callback_(flush_callback),
+        expired_callback_(expired_callback),
+        config_(config),
         reducer_(executor,
                  [this](auto prr) { this->handle_flush(std::move(prr)); },
                  config->collection_max_size(),
@@ -47,17 +70,88 @@ class Collector : boost::noncopyable {
                  [this](auto kr) { return this->should_flush(kr); }),
         buffered_data_([](auto) { return new std::atomic<size_t>(0); }) {}
 
+  ~Collector() {
+    if (scheduled_expiry_) {
+      scheduled_expiry_->cancel();
+    }
+  }
+
   std::shared_ptr<PutRecordsRequest>
   put(const std::shared_ptr<KinesisRecord>& kr) {
     auto prr = reducer_.add(kr);
     decrease_buffered_data(prr);
-    return prr;
+    return admit(std::move(prr));
   }
 
   void flush() {
     reducer_.flush();
   }
 
+  // Applies the collection limits currently in the configuration.
+  void update_limits() {
+    auto t = config_->snapshot();
+    reducer_.set_limits(t.collection_max_size, t.collection_max_count);
+  }
+
+  // The shards a request given to the flush callback or returned by put counts
+  // against; empty if there is no limit. Take them from the request's records
+  // before any are retried, since retrying can change their predicted shard.
+  std::vector<uint64_t> shards(
+      const std::vector<std::shared_ptr<KinesisRecord>>& records) const {
+    std::vector<uint64_t> result;
+    if (!limited()) {
+      return result;
+    }
+    for (auto& kr : records) {
+      auto shard_id = kr->items().front()->predicted_shard();
+      if (shard_id &&
+          std::find(result.begin(), result.end(), *shard_id) == result.end()) {
+        result.push_back(*shard_id);
+      }
+    }
+    return result;
+  }
+
+  // Must be called with the shards of each request once it has completed.
+  void request_completed(const std::vector<uint64_t>& shards) {
+    if (shards.empty()) {
+      return;
+    }
+    std::vector<std::shared_ptr<PutRecordsRequest>> released;
+    std::vector<std::shared_ptr<KinesisRecord>> expired;
+    {
+      aws::lock_guard<aws::mutex> lk(window_mutex_);
+      auto limit = config_->shard_max_in_flight();
+      for (auto shard_id : shards) {
+        auto it = in_flight_.find(shard_id);
+        if (it == in_flight_.end()) {
+          continue;
+        }
+        if (--it->second == 0) {
+          in_flight_.erase(it);
+        }
+        release(shard_id, limit, released, expired);
+      }
+      update_tracking();
+    }
+    for (auto& kr : expired) {
+      expired_callback_(kr);
+    }
+    for (auto& prr : released) {
+      flush_callback_(std::move(prr));
+    }
+  }
+
+  // Records held back because their shard's window is full.
+  size_t held() {
+    aws::lock_guard<aws::mutex> lk(window_mutex_);
+    size_t n = 0;
+    for (auto& p : held_) {
+      n += p.second.size();
+    }
+    return n;
+  }
+
  private:
   // We don't want any individual shard to accumulate too much data
   // because that makes traffic to that shard bursty, and might cause
@@ -88,13 +182,177 @@ class Collector : boost::noncopyable {
 
   void handle_flush(std::shared_ptr<PutRecordsRequest> prr) {
     decrease_buffered_data(prr);
-    flush_callback_(std::move(prr));
+    prr = admit(std::move(prr));
+    if (prr) {
+      flush_callback_(std::move(prr));
+    }
+  }
+
+  // Counts the request as in flight for each of its shards, taking out the
+  // records of shards whose window is full.
+  std::shared_ptr<PutRecordsRequest>
+  admit(std::shared_ptr<PutRecordsRequest> prr) {
+    if (!prr || !limited()) {
+      return prr;
+    }
+
+    std::vector<std::shared_ptr<KinesisRecord>> admitted;
+    bool held = false;
+    {
+      aws::lock_guard<aws::mutex> lk(window_mutex_);
+      auto limit = config_->shard_max_in_flight();
+      std::unordered_set<uint64_t> counted;
+      for (auto& kr : prr->items()) {
+        auto shard_id = kr->items().front()->predicted_shard();
+        if (shard_id && !counted.count(*shard_id)) {
+          if (window_open(*shard_id, limit) && !held_.count(*shard_id)) {
+            in_flight_[*shard_id]++;
+            counted.insert(*shard_id);
+          } else {
+            held_[*shard_id].push_back(kr);
+            expire_held_at(kr->expiration());
+            held = true;
+            continue;
+          }
+        }
+        admitted.push_back(kr);
+      }
+      update_tracking();
+    }
+
+    if (!held) {
+      return prr;
+    }
+    if (admitted.empty()) {
+      return nullptr;
+    }
+    auto result = std::make_shared<PutRecordsRequest>();
+    for (auto& kr : admitted) {
+      result->add(kr);
+    }
+    return result;
+  }
+
+  // Whether requests are counted against their shards. Once the limit is
+  // lowered to 0, that goes on until every counted request has completed and
+  // every held record has been released.
+  bool limited() const {
+    return config_->shard_max_in_flight() != 0 || tracking_;
+  }
+
+  // Must be called with window_mutex_ held.
+  void update_tracking() {
+    tracking_ = !in_flight_.empty() || !held_.empty();
+  }
+
+  // A limit of 0 leaves every window open. Must be called with window_mutex_
+  // held.
+  bool window_open(uint64_t shard_id, uint64_t limit) {
+    if (limit == 0) {
+      return true;
+    }
+    auto it = in_flight_.find(shard_id);
+    return it == in_flight_.end() || it->second < limit;
+  }
+
+  // Takes the shard's held records, oldest first, into requests of their own
+  // for as long as its window is open, passing over those that have expired.
+  // They don't go back through the reducer, where newer records for the shard
+  // could get ahead of them. Must be called with window_mutex_ held.
+  void release(uint64_t shard_id,
+               uint64_t limit,
+               std::vector<std::shared_ptr<PutRecordsRequest>>& released,
+               std::vector<std::shared_ptr<KinesisRecord>>& expired) {
+    auto held = held_.find(shard_id);
+    if (held == held_.end()) {
+      return;
+    }
+    auto limits = config_->snapshot();
+    auto& records = held->second;
+    take_expired(records, expired);
+    auto next = records.begin();
+    while (next != records.end() && window_open(shard_id, limit)) {
+      auto prr = std::make_shared<PutRecordsRequest>();
+      do {
+        prr->add(*next++);
+      } while (next != records.end() &&
+               prr->size() < limits.collection_max_count &&
+               prr->accurate_size() + (*next)->partition_key().length() +
+                       (*next)->accurate_size() <=
+                   limits.collection_max_size);
+      in_flight_[shard_id]++;
+      released.push_back(std::move(prr));
+    }
+    records.erase(records.begin(), next);
+    if (records.empty()) {
+      held_.erase(held);
+    }
+  }
+
+  // Moves the expired records out of records, keeping the rest in order.
+  static void take_expired(
+      std::vector<std::shared_ptr<KinesisRecord>>& records,
+      std::vector<std::shared_ptr<KinesisRecord>>& expired) {
+    auto kept = std::stable_partition(
+        records.begin(),
+        records.end(),
+        [](auto& kr) { return !kr->expired(); });
+    std::move(kept, records.end(), std::back_inserter(expired));
+    records.erase(kept, records.end());
+  }
+
+  void expire_held() {
+    std::vector<std::shared_ptr<KinesisRecord>> expired;
+    {
+      aws::lock_guard<aws::mutex> lk(window_mutex_);
+      auto next = TimePoint::max();
+      for (auto it = held_.begin(); it != held_.end();) {
+        take_expired(it->second, expired);
+        if (it->second.empty()) {
+          it = held_.erase(it);
+          continue;
+        }
+        for (auto& kr : it->second) {
+          next = std::min(next, kr->expiration());
+        }
+        ++it;
+      }
+      if (next != TimePoint::max()) {
+        expire_held_at(next);
+      }
+      update_tracking();
+    }
+    for (auto& kr : expired) {
+      expired_callback_(kr);
+    }
+  }
+
+  // Moves the expiry check earlier if needed. Must be called with
+  // window_mutex_ held.
+  void expire_held_at(TimePoint at) {
+    if (!scheduled_expiry_) {
+      scheduled_expiry_ = executor_->schedule([this] { this->expire_held(); },
+                                              at,
+                                              aws::utils::Priority::High);
+    } else if (scheduled_expiry_->completed() ||
+               at < scheduled_expiry_->expiration()) {
+      scheduled_expiry_->reschedule(at);
+    }
   }
 
+  std::shared_ptr<aws::utils::Executor> executor_;
   FlushCallback flush_callback_;
+  ExpiredCallback expired_callback_;
+  std::shared_ptr<aws::kinesis::core::Configuration> config_;
   std::shared_ptr<aws::metrics::MetricsManager> metrics_manager_;
   Reducer<KinesisRecord, PutRecordsRequest> reducer_;
   aws::utils::ConcurrentHashMap<uint64_t, std::atomic<size_t>> buffered_data_;
+  aws::mutex window_mutex_;
+  std::unordered_map<uint64_t, size_t> in_flight_;
+  std::unordered_map<uint64_t, std::vector<std::shared_ptr<KinesisRecord>>>
+      held_;
+  std::atomic<bool> tracking_{false};
+  std::shared_ptr<aws::utils::ScheduledCallback> scheduled_expiry_;
 };
 
 } //namespace core
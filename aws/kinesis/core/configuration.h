@@ -16,12 +16,16 @@
 #ifndef AWS_KINESIS_CORE_CONFIGURATION_H_
 #define AWS_KINESIS_CORE_CONFIGURATION_H_
 
+#include <atomic>
+#include <memory>
 #include <regex>
 
 #include <boost/noncopyable.hpp>
 #include <boost/optional.hpp>
 
 #include <aws/kinesis/protobuf/messages.pb.h>
+#include <aws/mutex.h>
+#include <aws/utils/cpu_affinity.h>
 
 namespace aws {
 namespace kinesis {
@@ -53,7 +57,7 @@ class Configuration : private boost::noncopyable {
   // Minimum: 1
   // Maximum (inclusive): 9223372036854775807
   size_t aggregation_max_count() const noexcept {
-    return aggregation_max_count_;
+    return tunables_.aggregation_max_count.load(std::memory_order_relaxed);
   }
 
   // Maximum number of bytes to pack into an aggregated Kinesis record.
@@ -70,7 +74,7 @@ class Configuration : private boost::noncopyable {
   // Minimum: 64
   // Maximum (inclusive): 10485760
   size_t aggregation_max_size() const noexcept {
-    return aggregation_max_size_;
+    return tunables_.aggregation_max_size.load(std::memory_order_relaxed);
   }
 
   // Use a custom CloudWatch endpoint.
@@ -102,7 +106,7 @@ class Configuration : private boost::noncopyable {
   // Minimum: 1
   // Maximum (inclusive): 500
   size_t collection_max_count() const noexcept {
-    return collection_max_count_;
+    return tunables_.collection_max_count.load(std::memory_order_relaxed);
   }
 
   // Maximum amount of data to send with a PutRecords request.
@@ -117,7 +121,7 @@ class Configuration : private boost::noncopyable {
   // Minimum: 52224
   // Maximum (inclusive): 9223372036854775807
   size_t collection_max_size() const noexcept {
-    return collection_max_size_;
+    return tunables_.collection_max_size.load(std::memory_order_relaxed);
   }
 
   // Timeout (milliseconds) for establishing TLS connections.
@@ -286,6 +290,10 @@ class Configuration : private boost::noncopyable {
 
   // Minimum number of connections to keep open to the backend.
   //
+  // When the producer is idle, it sends lightweight requests every 30 seconds
+  // to keep this many connections established, so that the next burst of
+  // records does not have to wait for new TLS handshakes.
+  //
   // There should be no need to increase this in general.
   //
   // Default: 1
@@ -315,7 +323,7 @@ class Configuration : private boost::noncopyable {
   // Minimum: 1
   // Maximum (inclusive): 9223372036854775807
   size_t rate_limit() const noexcept {
-    return rate_limit_;
+    return tunables_.rate_limit.load(std::memory_order_relaxed);
   }
 
   // Maximum amount of itme (milliseconds) a record may spend being buffered
@@ -340,7 +348,7 @@ class Configuration : private boost::noncopyable {
   // Default: 100
   // Maximum (inclusive): 9223372036854775807
   uint64_t record_max_buffered_time() const noexcept {
-    return record_max_buffered_time_;
+    return tunables_.record_max_buffered_time.load(std::memory_order_relaxed);
   }
 
   // Set a time-to-live on records (milliseconds). Records that do not get
@@ -362,7 +370,7 @@ class Configuration : private boost::noncopyable {
   // Minimum: 100
   // Maximum (inclusive): 9223372036854775807
   uint64_t record_ttl() const noexcept {
-    return record_ttl_;
+    return tunables_.record_ttl.load(std::memory_order_relaxed);
   }
 
   // Which region to send records to.
@@ -435,13 +443,282 @@ class Configuration : private boost::noncopyable {
     return use_thread_pool_;
   }
 
+  /// Indicates whether the SDK clients should use a thread pool that grows
+  /// with the number of requests in flight, up to \see thread_pool_size(), and
+  /// shrinks when threads go idle. Responses are then handled directly on the
+  /// thread that made the request.
+  /// \return true if the client should use an elastic thread pool
+  bool use_elastic_thread_pool() const noexcept {
+    return use_elastic_thread_pool_;
+  }
+
   /// The maximum number of threads that a thread pool should be limited to.
-  /// Threads are created eagerly.  This is only relevant if \see use_thread_pool() is true
+  /// Threads are created eagerly.  This is only relevant if \see use_thread_pool() or
+  /// \see use_elastic_thread_pool() is true
   /// \return the mamximum number of threads that the thread pool should consume
   uint32_t thread_pool_size() const noexcept {
     return thread_pool_size_;
   }
 
+  // Directory in which to keep a copy of each stream's shard map, so that a
+  // restarted producer can start aggregating before it has listed the shards
+  // of the stream. Empty disables the cache.
+  //
+  // Default: ""
+  const std::string& shard_map_cache_dir() const noexcept {
+    return shard_map_cache_dir_;
+  }
+
+  // Maximum age (milliseconds) of a cached shard map for it to be used at
+  // startup. A cached shard map is refreshed from Kinesis in the background
+  // once the producer has started.
+  //
+  // Default: 3600000
+  // Minimum: 1000
+  // Maximum (inclusive): 604800000
+  uint64_t shard_map_cache_ttl() const noexcept {
+    return shard_map_cache_ttl_;
+  }
+
+  // Streams to set up when the producer starts, before it accepts any
+  // records. Their pipelines are created and their shard maps fetched up
+  // front, so the first records put to them are aggregated right away.
+  //
+  // Default: empty
+  const std::vector<std::string>& prewarm_streams() const noexcept {
+    return prewarm_streams_;
+  }
+
+  // When pre-warming streams, also open min_connections connections to
+  // Kinesis before accepting records.
+  //
+  // Default: false
+  bool prewarm_connections() const noexcept {
+    return prewarm_connections_;
+  }
+
+  // Maximum time (milliseconds) to spend pre-warming streams at startup. The
+  // producer starts accepting records after this even if pre-warming has not
+  // finished.
+  //
+  // Default: 10000
+  // Minimum: 100
+  // Maximum (inclusive): 300000
+  uint64_t prewarm_timeout() const noexcept {
+    return prewarm_timeout_;
+  }
+
+  // Number of threads running the producer's internal work: aggregation,
+  // timers and handling of responses. 0 picks a number based on the number of
+  // cores, up to 8.
+  //
+  // Default: 0
+  // Minimum: 0
+  // Maximum (inclusive): 1024
+  uint32_t executor_threads() const noexcept {
+    return executor_threads_;
+  }
+
+  // Give each executor thread its own event loop and run queue instead of
+  // sharing one between all threads. Work belonging to a stream stays on one
+  // thread, and idle threads take over work queued on busy ones. Reduces
+  // contention on hosts with many cores.
+  //
+  // Default: false
+  bool executor_multi_reactor() const noexcept {
+    return executor_multi_reactor_;
+  }
+
+  // CPUs to run the IPC threads on: the threads reading and writing the pipes
+  // to the wrapper, and the thread handing received records to the executor.
+  // A list in the format of taskset, e.g. "0-3,8". Empty lets the OS place
+  // them. Only supported on Linux.
+  //
+  // Default: ""
+  const std::string& ipc_thread_cpus() const noexcept {
+    return ipc_thread_cpus_;
+  }
+
+  // CPUs to run the executor threads on, in the same format as
+  // ipc_thread_cpus. Each thread is pinned to one CPU of the list, going round
+  // the list if there are more threads than CPUs.
+  //
+  // Default: ""
+  const std::string& executor_thread_cpus() const noexcept {
+    return executor_thread_cpus_;
+  }
+
+  // CPUs to run the threads of the AWS SDK clients on, in the same format as
+  // ipc_thread_cpus.
+  //
+  // Default: ""
+  const std::string& sdk_thread_cpus() const noexcept {
+    return sdk_thread_cpus_;
+  }
+
+  // Have threads pinned with the settings above allocate memory from the NUMA
+  // node of their CPUs. Combined with executor_multi_reactor, each stream's
+  // pipeline allocates from the node of the thread it runs on.
+  //
+  // Default: false
+  bool numa_bind_memory() const noexcept {
+    return numa_bind_memory_;
+  }
+
+  // Maximum bytes of records held by the producer across all streams, from
+  // the time they are put until their results are returned. What happens when
+  // it is exceeded is set by memory_budget_policy. 0 means no limit.
+  //
+  // Default: 0
+  // Minimum: 0
+  // Maximum (inclusive): 9223372036854775807
+  uint64_t memory_budget() const noexcept {
+    return memory_budget_;
+  }
+
+  // What to do when memory_budget is exceeded.
+  //
+  // "fail" fails each record put while over the budget with the error code
+  // MemoryBudgetExceeded.
+  //
+  // "drop_oldest" fails records of the same stream that are waiting to be
+  // sent, those closest to expiring first, to make room. New records are
+  // failed only if not enough can be dropped.
+  //
+  // "backpressure" accepts all records, but has the wrapper hold back new
+  // records while over the budget, until usage has come down to 90% of it.
+  //
+  // Default: fail
+  // Expected pattern: fail|drop_oldest|backpressure
+  const std::string& memory_budget_policy() const noexcept {
+    return memory_budget_policy_;
+  }
+
+  // Directory in which to keep a spill log per stream. While the producer
+  // holds more than spill_high_water_mark bytes of records, records put are
+  // written to the log instead of being kept in memory, and they are read
+  // back in order as memory frees up. Lets the producer ride out a stream
+  // being throttled or unreachable for minutes without holding everything in
+  // memory. Each producer needs a directory of its own. Empty disables
+  // spilling.
+  //
+  // Default: ""
+  const std::string& spill_dir() const noexcept {
+    return spill_dir_;
+  }
+
+  // Bytes of records held in memory, across all streams, above which new
+  // records are spilled to disk. Only used if spill_dir is set; should be
+  // below memory_budget if that is set. Spilled records are read back once
+  // usage is under 90% of this.
+  //
+  // Default: 134217728
+  // Minimum: 0
+  // Maximum (inclusive): 9223372036854775807
+  uint64_t spill_high_water_mark() const noexcept {
+    return spill_high_water_mark_;
+  }
+
+  // Maximum disk space (bytes) taken by the spill log of each stream. Once it
+  // is full, records are kept in memory again.
+  //
+  // Default: 1073741824
+  // Minimum: 8388608
+  // Maximum (inclusive): 9223372036854775807
+  uint64_t spill_max_bytes() const noexcept {
+    return spill_max_bytes_;
+  }
+
+  // Keep spill logs when the producer shuts down or crashes, and send the
+  // records left in them when it starts again with the same spill_dir. Their
+  // results are not returned, since the wrapper that put them is gone, so
+  // records can be sent twice if the application also retried them.
+  //
+  // Default: false
+  bool spill_keep_on_restart() const noexcept {
+    return spill_keep_on_restart_;
+  }
+
+  // Send records as soon as they clear the rate limiter and a request slot is
+  // free, instead of aggregating and collecting them. Each request holds the
+  // records that are ready when it is sent, and nothing waits for more to
+  // arrive, so record_max_buffered_time and the aggregation settings have no
+  // effect. Meant for low volume streams where latency matters more than
+  // throughput, usually set through a stream override.
+  //
+  // Default: false
+  bool direct_send() const noexcept {
+    return direct_send_;
+  }
+
+  // Maximum number of PutRecords requests in flight at once for a stream in
+  // direct_send mode. Records that are ready while all are in flight are sent
+  // together when one completes.
+  //
+  // Default: 8
+  // Minimum: 1
+  // Maximum (inclusive): 1024
+  uint64_t direct_send_max_in_flight() const noexcept {
+    return direct_send_max_in_flight_;
+  }
+
+  // Let each shard's aggregator choose how long records wait, from the rate
+  // records have been arriving at, rather than always waiting
+  // record_max_buffered_time. Records that are unlikely to be joined by
+  // another before record_max_buffered_time are sent right away; otherwise
+  // they wait until the aggregated record is expected to fill, with some
+  // allowance, and never longer than record_max_buffered_time. Only used with
+  // aggregation.
+  //
+  // Default: false
+  bool adaptive_linger() const noexcept {
+    return adaptive_linger_;
+  }
+
+  // Write the body of PutRecords requests straight from the records, instead
+  // of building the SDK's request model and having the SDK serialize it. This
+  // saves copying every record twice on the way to the wire. Requests are
+  // then sent with blocking calls on the SDK's threads, as the SDK's async
+  // calls would have done.
+  //
+  // Default: false
+  bool direct_request_encoding() const noexcept {
+    return direct_request_encoding_;
+  }
+
+  // Send PutRecords requests over the KPL's own HTTP connections instead of
+  // through the SDK's HTTP client. Requests are signed and sent by the KPL's
+  // worker threads, over up to max_connections keep-alive connections to the
+  // Kinesis endpoint. Ignored when a proxy is configured.
+  //
+  // Default: false
+  bool native_transport() const noexcept {
+    return native_transport_;
+  }
+
+  // Serialize the aggregated records of large PutRecords requests in parallel
+  // on the KPL's worker threads before the request is assembled, instead of
+  // one after the other on the thread that flushed the request. Requests with
+  // little aggregated data are not split up.
+  //
+  // Default: false
+  bool parallel_serialization() const noexcept {
+    return parallel_serialization_;
+  }
+
+  // Maximum number of PutRecords requests in flight at once that contain
+  // records for the same shard. Records for a shard whose requests are all in
+  // flight are held back and sent when one of them completes, which keeps
+  // bursts from hitting one shard with several requests at a time. 0 means no
+  // limit.
+  //
+  // Default: 0
+  // Minimum: 0
+  // Maximum (inclusive): 1024
+  uint64_t shard_max_in_flight() const noexcept {
+    return tunables_.shard_max_in_flight.load(std::memory_order_relaxed);
+  }
+
   // Enable aggregation. With aggregation, multiple user records are packed
   // into a single KinesisRecord. If disabled, each user record is sent in its
   // own KinesisRecord.
@@ -471,7 +748,7 @@ class Configuration : private boost::noncopyable {
       err += std::to_string(val);
       throw std::runtime_error(err);
     }
-    aggregation_max_count_ = val;
+    update_tunables([=](Tunables& t) { t.aggregation_max_count = val; });
     return *this;
   }
 
@@ -495,7 +772,7 @@ class Configuration : private boost::noncopyable {
       err += std::to_string(val);
       throw std::runtime_error(err);
     }
-    aggregation_max_size_ = val;
+    update_tunables([=](Tunables& t) { t.aggregation_max_size = val; });
     return *this;
   }
 
@@ -551,7 +828,7 @@ class Configuration : private boost::noncopyable {
       err += std::to_string(val);
       throw std::runtime_error(err);
     }
-    collection_max_count_ = val;
+    update_tunables([=](Tunables& t) { t.collection_max_count = val; });
     return *this;
   }
 
@@ -573,7 +850,7 @@ class Configuration : private boost::noncopyable {
       err += std::to_string(val);
       throw std::runtime_error(err);
     }
-    collection_max_size_ = val;
+    update_tunables([=](Tunables& t) { t.collection_max_size = val; });
     return *this;
   }
 
@@ -823,6 +1100,10 @@ class Configuration : private boost::noncopyable {
 
   // Minimum number of connections to keep open to the backend.
   //
+  // When the producer is idle, it sends lightweight requests every 30 seconds
+  // to keep this many connections established, so that the next burst of
+  // records does not have to wait for new TLS handshakes.
+  //
   // There should be no need to increase this in general.
   //
   // Default: 1
@@ -865,7 +1146,7 @@ class Configuration : private boost::noncopyable {
       err += std::to_string(val);
       throw std::runtime_error(err);
     }
-    rate_limit_ = val;
+    update_tunables([=](Tunables& t) { t.rate_limit = val; });
     return *this;
   }
 
@@ -897,7 +1178,7 @@ class Configuration : private boost::noncopyable {
       err += std::to_string(val);
       throw std::runtime_error(err);
     }
-    record_max_buffered_time_ = val;
+    update_tunables([=](Tunables& t) { t.record_max_buffered_time = val; });
     return *this;
   }
 
@@ -926,7 +1207,7 @@ class Configuration : private boost::noncopyable {
       err += std::to_string(val);
       throw std::runtime_error(err);
     }
-    record_ttl_ = val;
+    update_tunables([=](Tunables& t) { t.record_ttl = val; });
     return *this;
   }
 
@@ -1031,6 +1312,15 @@ class Configuration : private boost::noncopyable {
     return *this;
   }
 
+  /// Enables or disables the use of an elastic thread pool for the SDK Client.
+  /// Default: false
+  /// \param val whether or not to use an elastic thread pool
+  /// \return This configuration
+  Configuration& use_elastic_thread_pool(bool val) {
+    use_elastic_thread_pool_ = val;
+    return *this;
+  }
+
   /// The maximum number of threads the thread pool will be allowed to use.
   /// This is only useful if \see use_thread_pool is set to true
   /// The threads for the thread pool are allocated eagerly.
@@ -1043,12 +1333,349 @@ class Configuration : private boost::noncopyable {
     return *this;
   }
 
+  // Directory in which to keep a copy of each stream's shard map, so that a
+  // restarted producer can start aggregating before it has listed the shards
+  // of the stream. Empty disables the cache.
+  //
+  // Default: ""
+  Configuration& shard_map_cache_dir(std::string val) {
+    shard_map_cache_dir_ = val;
+    return *this;
+  }
+
+  // Maximum age (milliseconds) of a cached shard map for it to be used at
+  // startup. A cached shard map is refreshed from Kinesis in the background
+  // once the producer has started.
+  //
+  // Default: 3600000
+  // Minimum: 1000
+  // Maximum (inclusive): 604800000
+  Configuration& shard_map_cache_ttl(uint64_t val) {
+    if (val < 1000ull || val > 604800000ull) {
+      std::string err;
+      err += "shard_map_cache_ttl must be between 1000 and 604800000, got ";
+      err += std::to_string(val);
+      throw std::runtime_error(err);
+    }
+    shard_map_cache_ttl_ = val;
+    return *this;
+  }
+
+  // When pre-warming streams, also open min_connections connections to
+  // Kinesis before accepting records.
+  //
+  // Default: false
+  Configuration& prewarm_connections(bool val) {
+    prewarm_connections_ = val;
+    return *this;
+  }
+
+  // Maximum time (milliseconds) to spend pre-warming streams at startup. The
+  // producer starts accepting records after this even if pre-warming has not
+  // finished.
+  //
+  // Default: 10000
+  // Minimum: 100
+  // Maximum (inclusive): 300000
+  Configuration& prewarm_timeout(uint64_t val) {
+    if (val < 100ull || val > 300000ull) {
+      std::string err;
+      err += "prewarm_timeout must be between 100 and 300000, got ";
+      err += std::to_string(val);
+      throw std::runtime_error(err);
+    }
+    prewarm_timeout_ = val;
+    return *this;
+  }
+
+  // Number of threads running the producer's internal work: aggregation,
+  // timers and handling of responses. 0 picks a number based on the number of
+  // cores, up to 8.
+  //
+  // Default: 0
+  // Minimum: 0
+  // Maximum (inclusive): 1024
+  Configuration& executor_threads(uint32_t val) {
+    if (val > 1024u) {
+      std::string err;
+      err += "executor_threads must be between 0 and 1024, got ";
+      err += std::to_string(val);
+      throw std::runtime_error(err);
+    }
+    executor_threads_ = val;
+    return *this;
+  }
+
+  // Give each executor thread its own event loop and run queue instead of
+  // sharing one between all threads. Work belonging to a stream stays on one
+  // thread, and idle threads take over work queued on busy ones. Reduces
+  // contention on hosts with many cores.
+  //
+  // Default: false
+  Configuration& executor_multi_reactor(bool val) {
+    executor_multi_reactor_ = val;
+    return *this;
+  }
+
+  // CPUs to run the IPC threads on: the threads reading and writing the pipes
+  // to the wrapper, and the thread handing received records to the executor.
+  // A list in the format of taskset, e.g. "0-3,8". Empty lets the OS place
+  // them. Only supported on Linux.
+  //
+  // Default: ""
+  Configuration& ipc_thread_cpus(std::string val) {
+    aws::utils::parse_cpu_list(val);
+    ipc_thread_cpus_ = val;
+    return *this;
+  }
+
+  // CPUs to run the executor threads on, in the same format as
+  // ipc_thread_cpus. Each thread is pinned to one CPU of the list, going round
+  // the list if there are more threads than CPUs.
+  //
+  // Default: ""
+  Configuration& executor_thread_cpus(std::string val) {
+    aws::utils::parse_cpu_list(val);
+    executor_thread_cpus_ = val;
+    return *this;
+  }
+
+  // CPUs to run the threads of the AWS SDK clients on, in the same format as
+  // ipc_thread_cpus.
+  //
+  // Default: ""
+  Configuration& sdk_thread_cpus(std::string val) {
+    aws::utils::parse_cpu_list(val);
+    sdk_thread_cpus_ = val;
+    return *this;
+  }
+
+  // Have threads pinned with the settings above allocate memory from the NUMA
+  // node of their CPUs. Combined with executor_multi_reactor, each stream's
+  // pipeline allocates from the node of the thread it runs on.
+  //
+  // Default: false
+  Configuration& numa_bind_memory(bool val) {
+    numa_bind_memory_ = val;
+    return *this;
+  }
+
+  // Maximum bytes of records held by the producer across all streams, from
+  // the time they are put until their results are returned. What happens when
+  // it is exceeded is set by memory_budget_policy. 0 means no limit.
+  //
+  // Default: 0
+  // Minimum: 0
+  // Maximum (inclusive): 9223372036854775807
+  Configuration& memory_budget(uint64_t val) {
+    if (val > 9223372036854775807ull) {
+      std::string err;
+      err += "memory_budget must be between 0 and 9223372036854775807, got ";
+      err += std::to_string(val);
+      throw std::runtime_error(err);
+    }
+    memory_budget_ = val;
+    return *this;
+  }
+
+  // What to do when memory_budget is exceeded.
+  //
+  // "fail" fails each record put while over the budget with the error code
+  // MemoryBudgetExceeded.
+  //
+  // "drop_oldest" fails records of the same stream that are waiting to be
+  // sent, those closest to expiring first, to make room. New records are
+  // failed only if not enough can be dropped.
+  //
+  // "backpressure" accepts all records, but has the wrapper hold back new
+  // records while over the budget, until usage has come down to 90% of it.
+  //
+  // Default: fail
+  // Expected pattern: fail|drop_oldest|backpressure
+  Configuration& memory_budget_policy(std::string val) {
+    static std::regex pattern(
+        "fail|drop_oldest|backpressure",
+        std::regex::ECMAScript | std::regex::optimize);
+    if (!std::regex_match(val, pattern)) {
+      std::string err;
+      err += "memory_budget_policy must match the pattern fail|drop_oldest|backpressure, got ";
+      err += val;
+      throw std::runtime_error(err);
+    }
+    memory_budget_policy_ = val;
+    return *this;
+  }
+
+  // Directory in which to keep a spill log per stream. While the producer
+  // holds more than spill_high_water_mark bytes of records, records put are
+  // written to the log instead of being kept in memory, and they are read
+  // back in order as memory frees up. Lets the producer ride out a stream
+  // being throttled or unreachable for minutes without holding everything in
+  // memory. Each producer needs a directory of its own. Empty disables
+  // spilling.
+  //
+  // Default: ""
+  Configuration& spill_dir(std::string val) {
+    spill_dir_ = val;
+    return *this;
+  }
+
+  // Bytes of records held in memory, across all streams, above which new
+  // records are spilled to disk. Only used if spill_dir is set; should be
+  // below memory_budget if that is set. Spilled records are read back once
+  // usage is under 90% of this.
+  //
+  // Default: 134217728
+  // Minimum: 0
+  // Maximum (inclusive): 9223372036854775807
+  Configuration& spill_high_water_mark(uint64_t val) {
+    if (val > 9223372036854775807ull) {
+      std::string err;
+      err += "spill_high_water_mark must be between 0 and 9223372036854775807, got ";
+      err += std::to_string(val);
+      throw std::runtime_error(err);
+    }
+    spill_high_water_mark_ = val;
+    return *this;
+  }
+
+  // Maximum disk space (bytes) taken by the spill log of each stream. Once it
+  // is full, records are kept in memory again.
+  //
+  // Default: 1073741824
+  // Minimum: 8388608
+  // Maximum (inclusive): 9223372036854775807
+  Configuration& spill_max_bytes(uint64_t val) {
+    if (val < 8388608ull || val > 9223372036854775807ull) {
+      std::string err;
+      err += "spill_max_bytes must be between 8388608 and 9223372036854775807, got ";
+      err += std::to_string(val);
+      throw std::runtime_error(err);
+    }
+    spill_max_bytes_ = val;
+    return *this;
+  }
+
+  // Keep spill logs when the producer shuts down or crashes, and send the
+  // records left in them when it starts again with the same spill_dir. Their
+  // results are not returned, since the wrapper that put them is gone, so
+  // records can be sent twice if the application also retried them.
+  //
+  // Default: false
+  Configuration& spill_keep_on_restart(bool val) {
+    spill_keep_on_restart_ = val;
+    return *this;
+  }
+
+  // Send records as soon as they clear the rate limiter and a request slot is
+  // free, instead of aggregating and collecting them. Each request holds the
+  // records that are ready when it is sent, and nothing waits for more to
+  // arrive, so record_max_buffered_time and the aggregation settings have no
+  // effect. Meant for low volume streams where latency matters more than
+  // throughput, usually set through a stream override.
+  //
+  // Default: false
+  Configuration& direct_send(bool val) {
+    direct_send_ = val;
+    return *this;
+  }
+
+  // Maximum number of PutRecords requests in flight at once for a stream in
+  // direct_send mode. Records that are ready while all are in flight are sent
+  // together when one completes.
+  //
+  // Default: 8
+  // Minimum: 1
+  // Maximum (inclusive): 1024
+  Configuration& direct_send_max_in_flight(uint64_t val) {
+    if (val < 1ull || val > 1024ull) {
+      std::string err;
+      err += "direct_send_max_in_flight must be between 1 and 1024, got ";
+      err += std::to_string(val);
+      throw std::runtime_error(err);
+    }
+    direct_send_max_in_flight_ = val;
+    return *this;
+  }
+
+  // Let each shard's aggregator choose how long records wait, from the rate
+  // records have been arriving at, rather than always waiting
+  // record_max_buffered_time. Records that are unlikely to be joined by
+  // another before record_max_buffered_time are sent right away; otherwise
+  // they wait until the aggregated record is expected to fill, with some
+  // allowance, and never longer than record_max_buffered_time. Only used with
+  // aggregation.
+  //
+  // Default: false
+  Configuration& adaptive_linger(bool val) {
+    adaptive_linger_ = val;
+    return *this;
+  }
+
+  // Write the body of PutRecords requests straight from the records, instead
+  // of building the SDK's request model and having the SDK serialize it. This
+  // saves copying every record twice on the way to the wire. Requests are
+  // then sent with blocking calls on the SDK's threads, as the SDK's async
+  // calls would have done.
+  //
+  // Default: false
+  Configuration& direct_request_encoding(bool val) {
+    direct_request_encoding_ = val;
+    return *this;
+  }
+
+  // Send PutRecords requests over the KPL's own HTTP connections instead of
+  // through the SDK's HTTP client. Requests are signed and sent by the KPL's
+  // worker threads, over up to max_connections keep-alive connections to the
+  // Kinesis endpoint. Ignored when a proxy is configured.
+  //
+  // Default: false
+  Configuration& native_transport(bool val) {
+    native_transport_ = val;
+    return *this;
+  }
+
+  // Serialize the aggregated records of large PutRecords requests in parallel
+  // on the KPL's worker threads before the request is assembled, instead of
+  // one after the other on the thread that flushed the request. Requests with
+  // little aggregated data are not split up.
+  //
+  // Default: false
+  Configuration& parallel_serialization(bool val) {
+    parallel_serialization_ = val;
+    return *this;
+  }
+
+  // Maximum number of PutRecords requests in flight at once that contain
+  // records for the same shard. Records for a shard whose requests are all in
+  // flight are held back and sent when one of them completes, which keeps
+  // bursts from hitting one shard with several requests at a time. 0 means no
+  // limit.
+  //
+  // Default: 0
+  // Minimum: 0
+  // Maximum (inclusive): 1024
+  Configuration& shard_max_in_flight(uint64_t val) {
+    if (val > 1024ull) {
+      std::string err;
+      err += "shard_max_in_flight must be between 0 and 1024, got ";
+      err += std::to_string(val);
+      throw std::runtime_error(err);
+    }
+    update_tunables([=](Tunables& t) { t.shard_max_in_flight = val; });
+    return *this;
+  }
+
 
   const std::vector<std::tuple<std::string, std::string, std::string>>&
   additional_metrics_dims() {
     return additional_metrics_dims_;
   }
 
+  void add_prewarm_stream(std::string stream) {
+    prewarm_streams_.push_back(std::move(stream));
+  }
+
   void add_additional_metrics_dims(std::string key,
                                    std::string value,
                                    std::string granularity) {
@@ -1057,6 +1684,64 @@ class Configuration : private boost::noncopyable {
                                           std::move(granularity));
   }
 
+  const std::vector<aws::kinesis::protobuf::StreamOverride>&
+  stream_overrides() const noexcept {
+    return stream_overrides_;
+  }
+
+  // Throws if the override has no stream or any of its values is invalid.
+  void add_stream_override(aws::kinesis::protobuf::StreamOverride o) {
+    if (o.stream().empty()) {
+      throw std::runtime_error("stream of a stream override must not be empty");
+    }
+    Configuration validated;
+    validated.apply_override(o);
+    stream_overrides_.push_back(std::move(o));
+  }
+
+  // The override naming the stream exactly, or failing that the one with the
+  // longest matching prefix. Null if there is none.
+  const aws::kinesis::protobuf::StreamOverride*
+  find_stream_override(const std::string& stream) const {
+    const aws::kinesis::protobuf::StreamOverride* best = nullptr;
+    size_t best_len = 0;
+    for (auto& o : stream_overrides_) {
+      auto& key = o.stream();
+      if (key.back() != '*') {
+        if (key == stream) {
+          return &o;
+        }
+        continue;
+      }
+      auto len = key.size() - 1;
+      if (len >= best_len && stream.compare(0, len, key, 0, len) == 0) {
+        best = &o;
+        best_len = len;
+      }
+    }
+    return best;
+  }
+
+  // The configuration a stream's pipeline should use: base itself, or a copy
+  // of it with the stream's override applied. The copy takes the tunables'
+  // current values from base, so it includes updates made since startup.
+  static std::shared_ptr<Configuration> for_stream(
+      const std::shared_ptr<Configuration>& base,
+      const std::string& stream) {
+    auto o = base->find_stream_override(stream);
+    if (!o) {
+      return base;
+    }
+    auto config = std::make_shared<Configuration>();
+    aws::kinesis::protobuf::Message m;
+    *m.mutable_configuration() = base->source_;
+    config->transfer_from_protobuf_msg(m);
+    config->apply_update(base->tunables());
+    config->apply_override(*o);
+    config->stream_override_ = *o;
+    return config;
+  }
+
   void transfer_from_protobuf_msg(const aws::kinesis::protobuf::Message& m) {
     if (!m.has_configuration()) {
       throw std::runtime_error("Not a configuration message");
@@ -1099,6 +1784,38 @@ class Configuration : private boost::noncopyable {
       thread_pool_size(c.thread_pool_size());
     } else if (c.thread_config() == ::aws::kinesis::protobuf::Configuration_ThreadConfig_PER_REQUEST) {
       use_thread_pool(false);
+    } else if (c.thread_config() == ::aws::kinesis::protobuf::Configuration_ThreadConfig_ELASTIC) {
+      use_thread_pool(false);
+      use_elastic_thread_pool(true);
+      thread_pool_size(c.thread_pool_size());
+    }
+
+    shard_map_cache_dir(c.shard_map_cache_dir());
+    shard_map_cache_ttl(c.shard_map_cache_ttl());
+    prewarm_connections(c.prewarm_connections());
+    prewarm_timeout(c.prewarm_timeout());
+    executor_threads(c.executor_threads());
+    executor_multi_reactor(c.executor_multi_reactor());
+    ipc_thread_cpus(c.ipc_thread_cpus());
+    executor_thread_cpus(c.executor_thread_cpus());
+    sdk_thread_cpus(c.sdk_thread_cpus());
+    numa_bind_memory(c.numa_bind_memory());
+    memory_budget(c.memory_budget());
+    memory_budget_policy(c.memory_budget_policy());
+    spill_dir(c.spill_dir());
+    spill_high_water_mark(c.spill_high_water_mark());
+    spill_max_bytes(c.spill_max_bytes());
+    spill_keep_on_restart(c.spill_keep_on_restart());
+    direct_send(c.direct_send());
+    direct_send_max_in_flight(c.direct_send_max_in_flight());
+    adaptive_linger(c.adaptive_linger());
+    direct_request_encoding(c.direct_request_encoding());
+    native_transport(c.native_transport());
+    parallel_serialization(c.parallel_serialization());
+    shard_max_in_flight(c.shard_max_in_flight());
+
+    for (auto i = 0; i < c.prewarm_streams_size(); i++) {
+      add_prewarm_stream(c.prewarm_streams(i));
     }
 
     for (auto i = 0; i < c.additional_metric_dims_size(); i++) {
@@ -1107,16 +1824,242 @@ class Configuration : private boost::noncopyable {
           std::make_tuple(ad.key(), ad.value(), ad.granularity()));
     }
 
+    for (auto i = 0; i < c.stream_overrides_size(); i++) {
+      add_stream_override(c.stream_overrides(i));
+    }
+
+    source_ = std::move(c);
+  }
+
+  // Applies the fields set in an UpdateConfiguration message. Every value is
+  // checked before any is applied, so an invalid update throws and leaves the
+  // configuration unchanged.
+  //
+  // Only the fields that can change while records are flowing are covered.
+  // They are published together as one new snapshot, so a reader never sees
+  // some of an update's values without the rest.
+  //
+  // A stream's configuration keeps the values its override sets.
+  void update_from_protobuf_msg(
+      const aws::kinesis::protobuf::UpdateConfiguration& u) {
+    Configuration validated;
+    validated.apply_update(u);
+    if (!stream_override_) {
+      apply_update(u);
+      return;
+    }
+    auto& o = *stream_override_;
+    auto filtered = u;
+    if (o.has_aggregation_max_count()) {
+      filtered.clear_aggregation_max_count();
+    }
+    if (o.has_aggregation_max_size()) {
+      filtered.clear_aggregation_max_size();
+    }
+    if (o.has_collection_max_count()) {
+      filtered.clear_collection_max_count();
+    }
+    if (o.has_collection_max_size()) {
+      filtered.clear_collection_max_size();
+    }
+    if (o.has_rate_limit()) {
+      filtered.clear_rate_limit();
+    }
+    if (o.has_record_max_buffered_time()) {
+      filtered.clear_record_max_buffered_time();
+    }
+    if (o.has_record_ttl()) {
+      filtered.clear_record_ttl();
+    }
+    apply_update(filtered);
+  }
+
+  // The fields covered by UpdateConfiguration, with the same defaults as
+  // their getters.
+  struct Tunables {
+    size_t aggregation_max_count = 4294967295;
+    size_t aggregation_max_size = 51200;
+    size_t collection_max_count = 500;
+    size_t collection_max_size = 5242880;
+    size_t rate_limit = 150;
+    uint64_t record_max_buffered_time = 100;
+    uint64_t record_ttl = 30000;
+    uint64_t shard_max_in_flight = 0;
+  };
+
+  // The current tunables, all from the same update. Code that reads several
+  // of them together should take one snapshot per operation rather than call
+  // the individual getters, which may straddle an update.
+  Tunables snapshot() const {
+    return tunables_.load();
+  }
+
+  // The current values of the fields covered by UpdateConfiguration.
+  aws::kinesis::protobuf::UpdateConfiguration tunables() const {
+    aws::kinesis::protobuf::UpdateConfiguration u;
+    u.set_aggregation_max_count(aggregation_max_count());
+    u.set_aggregation_max_size(aggregation_max_size());
+    u.set_collection_max_count(collection_max_count());
+    u.set_collection_max_size(collection_max_size());
+    u.set_rate_limit(rate_limit());
+    u.set_record_max_buffered_time(record_max_buffered_time());
+    u.set_record_ttl(record_ttl());
+    u.set_shard_max_in_flight(shard_max_in_flight());
+    return u;
   }
 
  private:
+  void apply_override(const aws::kinesis::protobuf::StreamOverride& o) {
+    if (o.has_aggregation_enabled()) {
+      aggregation_enabled(o.aggregation_enabled());
+    }
+    if (o.has_aggregation_max_count()) {
+      aggregation_max_count(o.aggregation_max_count());
+    }
+    if (o.has_aggregation_max_size()) {
+      aggregation_max_size(o.aggregation_max_size());
+    }
+    if (o.has_collection_max_count()) {
+      collection_max_count(o.collection_max_count());
+    }
+    if (o.has_collection_max_size()) {
+      collection_max_size(o.collection_max_size());
+    }
+    if (o.has_rate_limit()) {
+      rate_limit(o.rate_limit());
+    }
+    if (o.has_record_max_buffered_time()) {
+      record_max_buffered_time(o.record_max_buffered_time());
+    }
+    if (o.has_record_ttl()) {
+      record_ttl(o.record_ttl());
+    }
+    if (o.has_direct_send()) {
+      direct_send(o.direct_send());
+    }
+    if (o.has_direct_send_max_in_flight()) {
+      direct_send_max_in_flight(o.direct_send_max_in_flight());
+    }
+    if (o.has_adaptive_linger()) {
+      adaptive_linger(o.adaptive_linger());
+    }
+  }
+
+  // The tunables, each readable on its own without locking. A version
+  // number, odd while a store is in progress, lets load() retry until it has
+  // read every field from the same store.
+  class AtomicTunables : boost::noncopyable {
+   public:
+    AtomicTunables() {
+      store(Tunables());
+    }
+
+    Tunables load() const {
+      for (;;) {
+        auto version = version_.load(std::memory_order_acquire);
+        Tunables t;
+        t.aggregation_max_count =
+            aggregation_max_count.load(std::memory_order_relaxed);
+        t.aggregation_max_size =
+            aggregation_max_size.load(std::memory_order_relaxed);
+        t.collection_max_count =
+            collection_max_count.load(std::memory_order_relaxed);
+        t.collection_max_size =
+            collection_max_size.load(std::memory_order_relaxed);
+        t.rate_limit = rate_limit.load(std::memory_order_relaxed);
+        t.record_max_buffered_time =
+            record_max_buffered_time.load(std::memory_order_relaxed);
+        t.record_ttl = record_ttl.load(std::memory_order_relaxed);
+        t.shard_max_in_flight =
+            shard_max_in_flight.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (!(version & 1) &&
+            version_.load(std::memory_order_relaxed) == version) {
+          return t;
+        }
+      }
+    }
+
+    // Stores must be serialized by the caller.
+    void store(const Tunables& t) {
+      auto version = version_.load(std::memory_order_relaxed);
+      version_.store(version + 1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_release);
+      aggregation_max_count.store(t.aggregation_max_count,
+                                  std::memory_order_relaxed);
+      aggregation_max_size.store(t.aggregation_max_size,
+                                 std::memory_order_relaxed);
+      collection_max_count.store(t.collection_max_count,
+                                 std::memory_order_relaxed);
+      collection_max_size.store(t.collection_max_size,
+                                std::memory_order_relaxed);
+      rate_limit.store(t.rate_limit, std::memory_order_relaxed);
+      record_max_buffered_time.store(t.record_max_buffered_time,
+                                     std::memory_order_relaxed);
+      record_ttl.store(t.record_ttl, std::memory_order_relaxed);
+      shard_max_in_flight.store(t.shard_max_in_flight,
+                                std::memory_order_relaxed);
+      version_.store(version + 2, std::memory_order_release);
+    }
+
+    std::atomic<size_t> aggregation_max_count;
+    std::atomic<size_t> aggregation_max_size;
+    std::atomic<size_t> collection_max_count;
+    std::atomic<size_t> collection_max_size;
+    std::atomic<size_t> rate_limit;
+    std::atomic<uint64_t> record_max_buffered_time;
+    std::atomic<uint64_t> record_ttl;
+    std::atomic<uint64_t> shard_max_in_flight;
+
+   private:
+    std::atomic<uint64_t> version_{0};
+  };
+
+  // Copies the current tunables, lets f change the copy, and publishes it.
+  template <typename F>
+  void update_tunables(F f) {
+    aws::lock_guard<aws::mutex> lk(tunables_mutex_);
+    auto t = tunables_.load();
+    f(t);
+    tunables_.store(t);
+  }
+
+  // The setters are run against a scratch configuration, so every field is
+  // checked before the result is published in one store.
+  void apply_update(const aws::kinesis::protobuf::UpdateConfiguration& u) {
+    aws::lock_guard<aws::mutex> lk(tunables_mutex_);
+    Configuration next;
+    next.tunables_.store(tunables_.load());
+    if (u.has_aggregation_max_count()) {
+      next.aggregation_max_count(u.aggregation_max_count());
+    }
+    if (u.has_aggregation_max_size()) {
+      next.aggregation_max_size(u.aggregation_max_size());
+    }
+    if (u.has_collection_max_count()) {
+      next.collection_max_count(u.collection_max_count());
+    }
+    if (u.has_collection_max_size()) {
+      next.collection_max_size(u.collection_max_size());
+    }
+    if (u.has_rate_limit()) {
+      next.rate_limit(u.rate_limit());
+    }
+    if (u.has_record_max_buffered_time()) {
+      next.record_max_buffered_time(u.record_max_buffered_time());
+    }
+    if (u.has_record_ttl()) {
+      next.record_ttl(u.record_ttl());
+    }
+    if (u.has_shard_max_in_flight()) {
+      next.shard_max_in_flight(u.shard_max_in_flight());
+    }
+    tunables_.store(next.tunables_.load());
+  }
+
   bool aggregation_enabled_ = true;
-  size_t aggregation_max_count_ = 4294967295;
-  size_t aggregation_max_size_ = 51200;
   std::string cloudwatch_endpoint_ = "";
   size_t cloudwatch_port_ = 443;
-  size_t collection_max_count_ = 500;
-  size_t collection_max_size_ = 5242880;
   uint64_t connect_timeout_ = 6000;
   boost::optional<bool> enable_core_dumps_;
   bool fail_if_throttled_ = false;
@@ -1129,9 +2072,6 @@ class Configuration : private boost::noncopyable {
   std::string metrics_namespace_ = "KinesisProducerLibrary";
   size_t metrics_upload_delay_ = 60000;
   size_t min_connections_ = 1;
-  size_t rate_limit_ = 150;
-  uint64_t record_max_buffered_time_ = 100;
-  uint64_t record_ttl_ = 30000;
   std::string region_ = "";
   uint64_t request_timeout_ = 6000;
   bool verify_certificate_ = true;
@@ -1141,11 +2081,46 @@ class Configuration : private boost::noncopyable {
   std::string proxy_password_ = "";
 
   bool use_thread_pool_ = true;
+  bool use_elastic_thread_pool_ = false;
   uint32_t thread_pool_size_ = 64;
 
+  std::string shard_map_cache_dir_ = "";
+  uint64_t shard_map_cache_ttl_ = 3600000;
+
+  std::vector<std::string> prewarm_streams_;
+  bool prewarm_connections_ = false;
+  uint64_t prewarm_timeout_ = 10000;
+  uint32_t executor_threads_ = 0;
+  bool executor_multi_reactor_ = false;
+  std::string ipc_thread_cpus_ = "";
+  std::string executor_thread_cpus_ = "";
+  std::string sdk_thread_cpus_ = "";
+  bool numa_bind_memory_ = false;
+  uint64_t memory_budget_ = 0;
+  std::string memory_budget_policy_ = "fail";
+  std::string spill_dir_ = "";
+  uint64_t spill_high_water_mark_ = 134217728;
+  uint64_t spill_max_bytes_ = 1073741824;
+  bool spill_keep_on_restart_ = false;
+  bool direct_send_ = false;
+  uint64_t direct_send_max_in_flight_ = 8;
+  bool adaptive_linger_ = false;
+  bool direct_request_encoding_ = false;
+  bool native_transport_ = false;
+  bool parallel_serialization_ = false;
+
+
+  // Written by the setters and apply_update; see snapshot().
+  AtomicTunables tunables_;
+  aws::mutex tunables_mutex_;
 
   std::vector<std::tuple<std::string, std::string, std::string>>
       additional_metrics_dims_;
+  std::vector<aws::kinesis::protobuf::StreamOverride> stream_overrides_;
+  // Set in the copies made for streams with an override.
+  boost::optional<aws::kinesis::protobuf::StreamOverride> stream_override_;
+  // What this was built from, used to make those copies.
+  aws::kinesis::protobuf::Configuration source_;
 };
 
 } //namespace core
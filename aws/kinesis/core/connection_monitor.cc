@@ -0,0 +1,103 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <mutex>
+
+#include <aws/kinesis/core/connection_monitor.h>
+
+#include <aws/core/monitoring/HttpClientMetrics.h>
+#include <aws/core/monitoring/MonitoringFactory.h>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/optional.hpp>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+namespace {
+
+const char* kAllocationTag = "ConnectionMonitor";
+
+class ConnectionMonitorFactory : public Aws::Monitoring::MonitoringFactory {
+ public:
+  Aws::UniquePtr<Aws::Monitoring::MonitoringInterface>
+  CreateMonitoringInstance() const override {
+    return Aws::MakeUnique<ConnectionMonitor>(kAllocationTag);
+  }
+};
+
+std::mutex& stats_mutex() {
+  static std::mutex m;
+  return m;
+}
+
+ConnectionMonitor::Stats& stats() {
+  static ConnectionMonitor::Stats s;
+  return s;
+}
+
+boost::optional<int64_t> find(
+    const Aws::Monitoring::CoreMetricsCollection& metrics,
+    Aws::Monitoring::HttpClientMetricsType type) {
+  auto it = metrics.httpClientMetrics.find(
+      Aws::Monitoring::GetHttpClientMetricNameByType(type));
+  if (it == metrics.httpClientMetrics.end()) {
+    return boost::none;
+  }
+  return it->second;
+}
+
+} //namespace
+
+void ConnectionMonitor::install(Aws::SDKOptions& options) {
+  options.monitoringOptions.customizedMonitoringFactory_create_fn.push_back(
+      [] {
+        return Aws::MakeUnique<ConnectionMonitorFactory>(kAllocationTag);
+      });
+}
+
+ConnectionMonitor::Stats ConnectionMonitor::drain() {
+  std::lock_guard<std::mutex> lk(stats_mutex());
+  Stats result;
+  std::swap(result, stats());
+  return result;
+}
+
+void ConnectionMonitor::record(
+    const Aws::String& service_name,
+    const Aws::Monitoring::CoreMetricsCollection& metrics) {
+  if (!boost::iequals(service_name, "kinesis")) {
+    return;
+  }
+
+  using Type = Aws::Monitoring::HttpClientMetricsType;
+  // The connect latency is zero when an existing connection was reused. The
+  // SSL latency covers everything from the start of the request to the end of
+  // the TLS handshake.
+  auto connect = find(metrics, Type::ConnectLatency);
+  auto handshake = find(metrics, Type::SslLatency);
+  bool new_connection = connect && *connect > 0;
+
+  std::lock_guard<std::mutex> lk(stats_mutex());
+  stats().requests++;
+  if (new_connection) {
+    stats().handshakes.emplace_back(
+        handshake && *handshake > 0 ? *handshake : *connect);
+  }
+}
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
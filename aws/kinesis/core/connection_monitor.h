@@ -0,0 +1,99 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_KINESIS_CORE_CONNECTION_MONITOR_H_
+#define AWS_KINESIS_CORE_CONNECTION_MONITOR_H_
+
+#include <chrono>
+#include <vector>
+
+#include <aws/core/Aws.h>
+#include <aws/core/monitoring/MonitoringInterface.h>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+// Watches the HTTP metrics the SDK attaches to every Kinesis request, to tell
+// how many requests went out and how many of them had to open a new
+// connection first.
+//
+// The SDK creates its own instances of the monitor, so everything they see
+// is collected in one process-wide place and picked up with drain().
+class ConnectionMonitor : public Aws::Monitoring::MonitoringInterface {
+ public:
+  struct Stats {
+    // Kinesis requests completed since the last drain.
+    size_t requests = 0;
+
+    // Time spent on TCP and TLS setup, one entry per new connection.
+    std::vector<std::chrono::milliseconds> handshakes;
+  };
+
+  // Registers the monitor with the SDK. Must be called before Aws::InitAPI.
+  static void install(Aws::SDKOptions& options);
+
+  // Returns what was collected since the previous call and resets it.
+  static Stats drain();
+
+  void* OnRequestStarted(
+      const Aws::String& service_name,
+      const Aws::String& request_name,
+      const std::shared_ptr<const Aws::Http::HttpRequest>& request)
+      const override {
+    return nullptr;
+  }
+
+  void OnRequestSucceeded(
+      const Aws::String& service_name,
+      const Aws::String& request_name,
+      const std::shared_ptr<const Aws::Http::HttpRequest>& request,
+      const Aws::Client::HttpResponseOutcome& outcome,
+      const Aws::Monitoring::CoreMetricsCollection& metrics,
+      void* context) const override {
+    record(service_name, metrics);
+  }
+
+  void OnRequestFailed(
+      const Aws::String& service_name,
+      const Aws::String& request_name,
+      const std::shared_ptr<const Aws::Http::HttpRequest>& request,
+      const Aws::Client::HttpResponseOutcome& outcome,
+      const Aws::Monitoring::CoreMetricsCollection& metrics,
+      void* context) const override {
+    record(service_name, metrics);
+  }
+
+  void OnRequestRetry(
+      const Aws::String& service_name,
+      const Aws::String& request_name,
+      const std::shared_ptr<const Aws::Http::HttpRequest>& request,
+      void* context) const override {}
+
+  void OnFinish(
+      const Aws::String& service_name,
+      const Aws::String& request_name,
+      const std::shared_ptr<const Aws::Http::HttpRequest>& request,
+      void* context) const override {}
+
+  static void record(const Aws::String& service_name,
+                     const Aws::Monitoring::CoreMetricsCollection& metrics);
+};
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
+
+#endif //AWS_KINESIS_CORE_CONNECTION_MONITOR_H_
@@ -0,0 +1,148 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_KINESIS_CORE_DIRECT_SENDER_H_
+#define AWS_KINESIS_CORE_DIRECT_SENDER_H_
+
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include <aws/kinesis/core/configuration.h>
+#include <aws/kinesis/core/put_records_request.h>
+#include <aws/mutex.h>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+// Takes the place of the Collector for streams in direct_send mode. Records
+// are sent as soon as one of the stream's request slots is free, together
+// with whatever else is ready at that moment, up to the collection limits.
+// There is no timer; a slot is freed by calling request_completed. Records
+// that have expired by the time a slot is free are given to the expired
+// callback instead of being sent.
+//
+// All methods are threadsafe.
+class DirectSender : boost::noncopyable {
+ public:
+  using SendCallback =
+      std::function<void (std::shared_ptr<PutRecordsRequest>)>;
+  using ExpiredCallback =
+      std::function<void (const std::shared_ptr<KinesisRecord>&)>;
+
+  DirectSender(const SendCallback& send_callback,
+               const ExpiredCallback& expired_callback,
+               const std::shared_ptr<Configuration>& config)
+      : send_callback_(send_callback),
+        expired_callback_(expired_callback),
+        config_(config),
+        in_flight_(0) {}
+
+  void put(const std::shared_ptr<KinesisRecord>& kr) {
+    {
+      aws::lock_guard<aws::mutex> lk(mutex_);
+      ready_.push_back(kr);
+    }
+    send_ready();
+  }
+
+  // Must be called once for each request given to the send callback, when
+  // it has completed.
+  void request_completed() {
+    {
+      aws::lock_guard<aws::mutex> lk(mutex_);
+      in_flight_--;
+    }
+    send_ready();
+  }
+
+  size_t in_flight() {
+    aws::lock_guard<aws::mutex> lk(mutex_);
+    return in_flight_;
+  }
+
+  // Records waiting for a free slot.
+  size_t waiting() {
+    aws::lock_guard<aws::mutex> lk(mutex_);
+    return ready_.size();
+  }
+
+ private:
+  void send_ready() {
+    std::vector<std::shared_ptr<PutRecordsRequest>> requests;
+    std::vector<std::shared_ptr<KinesisRecord>> expired;
+    {
+      aws::lock_guard<aws::mutex> lk(mutex_);
+      auto max_in_flight = config_->direct_send_max_in_flight();
+      if (in_flight_ < max_in_flight) {
+        take_expired(expired);
+      }
+      auto t = config_->snapshot();
+      auto max_count = t.collection_max_count;
+      auto max_size = t.collection_max_size;
+      while (!ready_.empty() && in_flight_ < max_in_flight) {
+        auto prr = std::make_shared<PutRecordsRequest>();
+        do {
+          prr->add(ready_.front());
+          ready_.pop_front();
+        } while (!ready_.empty() &&
+                 prr->size() < max_count &&
+                 prr->accurate_size() + request_size(ready_.front()) <=
+                     max_size);
+        in_flight_++;
+        requests.push_back(std::move(prr));
+      }
+    }
+    for (auto& kr : expired) {
+      expired_callback_(kr);
+    }
+    for (auto& prr : requests) {
+      send_callback_(std::move(prr));
+    }
+  }
+
+  // Moves the expired records out of ready_, keeping the rest in order. Must
+  // be called with mutex_ held.
+  void take_expired(std::vector<std::shared_ptr<KinesisRecord>>& expired) {
+    auto kept = std::stable_partition(
+        ready_.begin(),
+        ready_.end(),
+        [](auto& kr) { return !kr->expired(); });
+    std::move(kept, ready_.end(), std::back_inserter(expired));
+    ready_.erase(kept, ready_.end());
+  }
+
+  // What a record adds to the size of a PutRecordsRequest.
+  static size_t request_size(const std::shared_ptr<KinesisRecord>& kr) {
+    return kr->partition_key().length() + kr->accurate_size();
+  }
+
+  SendCallback send_callback_;
+  ExpiredCallback expired_callback_;
+  std::shared_ptr<Configuration> config_;
+  aws::mutex mutex_;
+  std::deque<std::shared_ptr<KinesisRecord>> ready_;
+  size_t in_flight_;
+};
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
+
+#endif //AWS_KINESIS_CORE_DIRECT_SENDER_H_
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_KINESIS_CORE_FLUSH_TRACKER_H_
+#define AWS_KINESIS_CORE_FLUSH_TRACKER_H_
+
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include <aws/utils/spin_lock.h>
+#include <aws/mutex.h>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+// Tells when every record accepted before a flush has finished.
+//
+// Each tracked flush ends an epoch and starts the next. Records are counted
+// against the epoch they were accepted in, and epochs are retired in order
+// once they have no records left, so the oldest epoch still live is the
+// watermark below which everything has finished. A flush completes when the
+// epoch it ended is retired.
+//
+// All methods are threadsafe. Callbacks are invoked outside the lock, on the
+// thread that finished the last record they were waiting for.
+class FlushTracker : boost::noncopyable {
+ public:
+  using Callback = std::function<void ()>;
+
+  FlushTracker()
+      : epochs_(1),
+        first_epoch_(0) {}
+
+  // Returns the epoch to pass to finished() for the record.
+  uint64_t accepted() {
+    aws::lock_guard<aws::utils::SpinLock> lk(mutex_);
+    epochs_.back().outstanding++;
+    return first_epoch_ + epochs_.size() - 1;
+  }
+
+  void finished(uint64_t epoch) {
+    std::vector<Callback> completed;
+    {
+      aws::lock_guard<aws::utils::SpinLock> lk(mutex_);
+      epochs_[epoch - first_epoch_].outstanding--;
+      retire(completed);
+    }
+    for (auto& cb : completed) {
+      cb();
+    }
+  }
+
+  // Calls callback once every record accepted so far has finished, which
+  // may be right away.
+  void flush(const Callback& callback) {
+    std::vector<Callback> completed;
+    {
+      aws::lock_guard<aws::utils::SpinLock> lk(mutex_);
+      epochs_.back().callbacks.push_back(callback);
+      epochs_.emplace_back();
+      retire(completed);
+    }
+    for (auto& cb : completed) {
+      cb();
+    }
+  }
+
+  // Flushes still waiting for records to finish.
+  size_t pending() {
+    aws::lock_guard<aws::utils::SpinLock> lk(mutex_);
+    return epochs_.size() - 1;
+  }
+
+ private:
+  struct Epoch {
+    uint64_t outstanding = 0;
+    std::vector<Callback> callbacks;
+  };
+
+  // The last epoch takes new records and is never retired.
+  void retire(std::vector<Callback>& completed) {
+    while (epochs_.size() > 1 && epochs_.front().outstanding == 0) {
+      for (auto& cb : epochs_.front().callbacks) {
+        completed.push_back(std::move(cb));
+      }
+      epochs_.pop_front();
+      first_epoch_++;
+    }
+  }
+
+  aws::utils::SpinLock mutex_;
+  std::deque<Epoch> epochs_;
+  uint64_t first_epoch_;
+};
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
+
+#endif //AWS_KINESIS_CORE_FLUSH_TRACKER_H_
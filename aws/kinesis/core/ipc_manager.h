@@ -26,6 +26,7 @@
 
 #include <aws/utils/logging.h>
 
+#include <aws/utils/cpu_affinity.h>
 #include <aws/utils/io_service_executor.h>
 #include <aws/utils/concurrent_linked_queue.h>
 
@@ -341,15 +342,22 @@ class IpcWriter : public IpcWorker {
 class IpcManager : boost::noncopyable {
  public:
   IpcManager(
-    const std::shared_ptr<detail::IpcChannel>& channel)
+    const std::shared_ptr<detail::IpcChannel>& channel,
+    aws::utils::ThreadPlacement placement = aws::utils::ThreadPlacement())
       : in_queue_(std::make_shared<detail::IpcMessageQueue>()),
         out_queue_(std::make_shared<detail::IpcMessageQueue>()),
         executor_(2),
         channel_(channel),
         reader_(std::make_unique<detail::IpcReader>(channel_, in_queue_)),
         writer_(std::make_unique<detail::IpcWriter>(channel_, out_queue_)) {
-    executor_.submit([this] { reader_->start(); });
-    executor_.submit([this] { writer_->start(); });
+    executor_.submit([this, placement] {
+      placement.apply();
+      reader_->start();
+    });
+    executor_.submit([this, placement] {
+      placement.apply();
+      writer_->start();
+    });
   }
 
   ~IpcManager() {
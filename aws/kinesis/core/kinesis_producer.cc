@@ -24,9 +24,13 @@
 #include <aws/core/client/DefaultRetryStrategy.h>
 #include <aws/core/http/Scheme.h>
 #include <aws/kinesis/core/kinesis_producer.h>
+#include <aws/kinesis/core/connection_monitor.h>
+#include <aws/utils/elastic_thread_executor.h>
 
+#include <algorithm>
 #include <system_error>
 #include <aws/core/utils/threading/Executor.h>
+#include <aws/kinesis/model/ListShardsRequest.h>
 
 namespace {
 
@@ -96,6 +100,93 @@ T cast_size_t(std::size_t value) {
 
 std::shared_ptr<Aws::Utils::Threading::Executor> sdk_client_executor;
 
+// Runs the SDK's work on threads placed according to the configuration. The
+// SDK executors don't expose their threads, so each thread places itself
+// before the first task it runs.
+class PlacedSdkExecutor : public Aws::Utils::Threading::Executor {
+ public:
+  PlacedSdkExecutor(std::shared_ptr<Aws::Utils::Threading::Executor> executor,
+                    aws::utils::ThreadPlacement placement)
+      : executor_(std::move(executor)),
+        placement_(std::move(placement)) {}
+
+ protected:
+  bool SubmitToThread(std::function<void()>&& task) override {
+    return executor_->Submit([this, task = std::move(task)] {
+      thread_local bool placed = false;
+      if (!placed) {
+        placement_.apply();
+        placed = true;
+      }
+      task();
+    });
+  }
+
+ private:
+  std::shared_ptr<Aws::Utils::Threading::Executor> executor_;
+  aws::utils::ThreadPlacement placement_;
+};
+
+const char* priority_name(aws::utils::Priority priority) {
+  switch (priority) {
+    case aws::utils::Priority::High:
+      return "High";
+    case aws::utils::Priority::Normal:
+      return "Normal";
+    case aws::utils::Priority::Low:
+      return "Low";
+  }
+  return "Unknown";
+}
+
+// The median, the 99th percentile and the maximum of the durations recorded
+// since the previous snapshot of a histogram, in milliseconds, each at the
+// midpoint of its bucket.
+struct HistogramSummary {
+  double p50;
+  double p99;
+  double max;
+};
+
+// Returns false if nothing was recorded since the previous snapshot.
+bool summarize_histogram(const aws::utils::LatencyHistogram::Counts& now,
+                         const aws::utils::LatencyHistogram::Counts& before,
+                         HistogramSummary& summary) {
+  aws::utils::LatencyHistogram::Counts delta;
+  uint64_t total = 0;
+  for (size_t i = 0; i < now.size(); i++) {
+    delta[i] = now[i] - before[i];
+    total += delta[i];
+  }
+  if (total == 0) {
+    return false;
+  }
+
+  auto ms = [](size_t bucket) {
+    return aws::utils::LatencyHistogram::representative(bucket).count() /
+        1000.0;
+  };
+  // Ranks, 1 based, of the median and the 99th percentile.
+  const uint64_t ranks[] = {(total + 1) / 2, total - total / 100};
+  double* values[] = {&summary.p50, &summary.p99};
+  size_t next_rank = 0;
+  uint64_t seen = 0;
+  size_t last = 0;
+  for (size_t i = 0; i < delta.size(); i++) {
+    if (delta[i] == 0) {
+      continue;
+    }
+    seen += delta[i];
+    last = i;
+    while (next_rank < 2 && seen >= ranks[next_rank]) {
+      *values[next_rank] = ms(i);
+      next_rank++;
+    }
+  }
+  summary.max = ms(last);
+  return true;
+}
+
 Aws::Client::ClientConfiguration
 make_sdk_client_cfg(const aws::kinesis::core::Configuration& kpl_cfg,
                     const std::string& region,
@@ -114,7 +205,16 @@ make_sdk_client_cfg(const aws::kinesis::core::Configuration& kpl_cfg,
   cfg.proxyPort = cast_size_t<unsigned>(kpl_cfg.proxy_port());
   cfg.proxyUserName = kpl_cfg.proxy_user_name();
   cfg.proxyPassword = kpl_cfg.proxy_password();
-  if (kpl_cfg.use_thread_pool()) {
+  if (kpl_cfg.use_elastic_thread_pool()) {
+    if (sdk_client_executor == nullptr) {
+      uint32_t thread_pool_size = kpl_cfg.thread_pool_size();
+      if (thread_pool_size == 0) {
+        thread_pool_size = kDefaultThreadPoolSize;
+      }
+      LOG(info) << "Using elastic threading model with up to " << thread_pool_size << " threads.";
+      sdk_client_executor = std::make_shared<aws::utils::ElasticThreadExecutor>(thread_pool_size);
+    }
+  } else if (kpl_cfg.use_thread_pool()) {
     if (sdk_client_executor == nullptr) {
       uint32_t thread_pool_size = kpl_cfg.thread_pool_size();
       //
@@ -130,6 +230,16 @@ make_sdk_client_cfg(const aws::kinesis::core::Configuration& kpl_cfg,
     LOG(info) << "Using per request threading model.";
     sdk_client_executor = std::make_shared<Aws::Utils::Threading::DefaultExecutor>();
   }
+  aws::utils::ThreadPlacement placement(
+      aws::utils::parse_cpu_list(kpl_cfg.sdk_thread_cpus()),
+      kpl_cfg.numa_bind_memory());
+  if (!placement.empty() &&
+      !std::dynamic_pointer_cast<PlacedSdkExecutor>(sdk_client_executor)) {
+    LOG(info) << "Pinning SDK threads to CPUs " << kpl_cfg.sdk_thread_cpus();
+    sdk_client_executor = std::make_shared<PlacedSdkExecutor>(
+        std::move(sdk_client_executor),
+        std::move(placement));
+  }
   cfg.executor = sdk_client_executor;
   cfg.verifySSL = kpl_cfg.verify_certificate();
   cfg.caPath = ca_path;
@@ -145,6 +255,8 @@ namespace core {
 
 const std::chrono::microseconds KinesisProducer::kMessageDrainMinBackoff(100);
 const std::chrono::microseconds KinesisProducer::kMessageDrainMaxBackoff(10000);
+const std::chrono::seconds KinesisProducer::kKeepAliveInterval(30);
+const std::chrono::seconds KinesisProducer::kExecutorMetricsInterval(1);
 
 void KinesisProducer::create_metrics_manager() {
   auto level = aws::metrics::constants::level(config_->metrics_level());
@@ -189,6 +301,54 @@ void KinesisProducer::create_kinesis_client(const std::string& ca_path, const st
       cfg);
 }
 
+// The native transport talks HTTP to the endpoint directly, so it's only used
+// when there's no proxy in between.
+void KinesisProducer::create_transport(const std::string& ca_path,
+                                       const std::string& ca_file) {
+  if (!config_->native_transport()) {
+    return;
+  }
+  if (!config_->proxy_host().empty()) {
+    LOG(warning) << "NativeTransport can't be used with a proxy, sending "
+                 << "PutRecords through the SDK";
+    return;
+  }
+  if (!executor_->io_reactor()) {
+    LOG(warning) << "NativeTransport needs an asio based executor, sending "
+                 << "PutRecords through the SDK";
+    return;
+  }
+
+  std::string host;
+  uint16_t port = 443;
+  if (config_->kinesis_endpoint().size() > 0) {
+    host = config_->kinesis_endpoint();
+    port = cast_size_t<uint16_t>(config_->kinesis_port());
+  } else {
+    auto region_override = kRegionEndpointOverride.find(region_);
+    host = region_override != kRegionEndpointOverride.end()
+        ? region_override->second.kinesis_endpoint_
+        : "kinesis." + region_ + ".amazonaws.com";
+  }
+  LOG(info) << "Sending PutRecords to " << host << ":" << port
+            << " with the native transport";
+
+  auto creds_provider = kinesis_creds_provider_;
+  transport_ = std::make_shared<PutRecordsTransport>(
+      executor_,
+      host,
+      port,
+      PutRecordsTransport::make_ssl_context(config_->verify_certificate(),
+                                            ca_path,
+                                            ca_file),
+      region_,
+      [creds_provider] { return creds_provider->GetAWSCredentials(); },
+      user_agent(),
+      config_->max_connections(),
+      std::chrono::milliseconds(config_->connect_timeout()),
+      std::chrono::milliseconds(config_->request_timeout()));
+}
+
 void KinesisProducer::create_cw_client(const std::string& ca_path, const std::string& ca_file) {
   auto cfg = make_sdk_client_cfg(*config_, region_, ca_path, ca_file, 2);
   if (config_->cloudwatch_endpoint().size() > 0) {
@@ -204,27 +364,151 @@ void KinesisProducer::create_cw_client(const std::string& ca_path, const std::st
       cfg);
 }
 
+// The budget is shared by all pipelines. With the backpressure policy, pauses
+// and resumes are sent to the wrapper as they happen.
+void KinesisProducer::create_memory_budget() {
+  memory_budget_ = std::make_shared<MemoryBudget>(
+      config_->memory_budget(),
+      MemoryBudget::parse_policy(config_->memory_budget_policy()),
+      [this](bool paused, uint64_t used) {
+        LOG(info) << (paused ? "Pausing" : "Resuming") << " records from the "
+                  << "wrapper, " << used << " of " << config_->memory_budget()
+                  << " bytes of the memory budget in use";
+        aws::kinesis::protobuf::Message m;
+        m.set_id(::rand());
+        auto bp = m.mutable_backpressure();
+        bp->set_paused(paused);
+        bp->set_buffered_bytes(used);
+        bp->set_budget_bytes(config_->memory_budget());
+        ipc_manager_->put(m.SerializeAsString());
+      });
+}
+
 Pipeline* KinesisProducer::create_pipeline(const std::string& stream) {
+  // Keep each stream's timers and response handling on one thread if the
+  // executor supports it. A stream that backs up its thread spills over onto
+  // the others.
+  auto executor = executor_->affine(std::hash<std::string>()(stream));
   return new Pipeline(
       region_,
       stream,
-      config_,
-      executor_,
+      Configuration::for_stream(config_, stream),
+      executor ? executor : executor_,
       kinesis_client_,
+      sdk_client_executor,
+      transport_,
+      request_serializer_,
       metrics_manager_,
+      memory_budget_,
+      inline_completions_,
+      executor_->num_threads(),
       [this](auto& ur) {
-        ipc_manager_->put(ur->to_put_record_result().SerializeAsString());
+        if (!ur->recovered()) {
+          ipc_manager_->put(ur->to_put_record_result().SerializeAsString());
+        }
       },
       [this](const std::string& stream_name) {
         return this->get_stream_id_from_cache(stream_name);
       });
 }
 
+// Creates the pipelines of streams that have records left in spill logs by an
+// earlier run, so that those records are sent even if no new records are put
+// to the stream.
+void KinesisProducer::recover_spilled_streams() {
+  if (config_->spill_dir().empty() || !config_->spill_keep_on_restart()) {
+    return;
+  }
+
+  const auto prefix = region_ + "-";
+  boost::system::error_code ec;
+  boost::filesystem::directory_iterator it(config_->spill_dir(), ec), end;
+  for (; !ec && it != end; it.increment(ec)) {
+    auto name = it->path().filename().string();
+    if (boost::filesystem::is_directory(it->path()) &&
+        name.size() > prefix.size() &&
+        name.compare(0, prefix.size(), prefix) == 0) {
+      pipelines_[name.substr(prefix.size())];
+    }
+  }
+}
+
+// Sets up the configured streams before any records are accepted, so that
+// the first records for them don't go out unaggregated on cold connections.
+// Gives up after prewarm_timeout; whatever is not ready by then finishes in
+// the background.
+void KinesisProducer::prewarm() {
+  auto& streams = config_->prewarm_streams();
+  if (streams.empty()) {
+    return;
+  }
+
+  const auto started = std::chrono::steady_clock::now();
+  const auto deadline =
+      started + std::chrono::milliseconds(config_->prewarm_timeout());
+  LOG(info) << "Pre-warming " << streams.size() << " streams";
+
+  std::vector<Pipeline*> pipelines;
+  for (auto& stream : streams) {
+    pipelines.push_back(&pipelines_[stream]);
+  }
+
+  auto pending_connections = std::make_shared<std::atomic<size_t>>(0);
+  if (config_->prewarm_connections()) {
+    pending_connections =
+        warm_connections(streams.front(), config_->min_connections());
+  }
+
+  while (std::chrono::steady_clock::now() < deadline) {
+    bool ready =
+        *pending_connections == 0 &&
+        std::all_of(pipelines.begin(), pipelines.end(), [](auto pipeline) {
+          return pipeline->has_shard_map();
+        });
+    if (ready) {
+      std::chrono::duration<double, std::milli> elapsed =
+          std::chrono::steady_clock::now() - started;
+      LOG(info) << "Pre-warming finished in " << elapsed.count() << " ms";
+      return;
+    }
+    aws::utils::sleep_for(std::chrono::milliseconds(10));
+  }
+
+  LOG(warning) << "Pre-warming did not finish within "
+               << config_->prewarm_timeout() << " ms; accepting records anyway";
+}
+
+// Issues count concurrent requests, which makes the client establish (up to)
+// count connections. Returns the number of requests still in flight.
+std::shared_ptr<std::atomic<size_t>>
+KinesisProducer::warm_connections(const std::string& stream, size_t count) {
+  auto pending = std::make_shared<std::atomic<size_t>>(count);
+  for (size_t i = 0; i < count; i++) {
+    Aws::Kinesis::Model::ListShardsRequest req;
+    req.SetStreamName(stream);
+    req.SetMaxResults(1);
+    kinesis_client_->ListShardsAsync(
+        req,
+        [pending](auto /*client*/, auto& /*req*/, auto& outcome, auto& /*ctx*/) {
+          if (!outcome.IsSuccess()) {
+            LOG(warning) << "Connection warm-up request failed: "
+                         << outcome.GetError().GetMessage();
+          }
+          (*pending)--;
+        });
+  }
+  return pending;
+}
+
 void KinesisProducer::drain_messages() {
   std::string s;
   std::vector<std::string> buf;
   std::chrono::microseconds backoff = kMessageDrainMinBackoff;
 
+  aws::utils::ThreadPlacement(
+      aws::utils::parse_cpu_list(config_->ipc_thread_cpus()),
+      config_->numa_bind_memory()).apply();
+
   while (!shutdown_) {
     // The checks must be in this order because try_take has a side effect
     while (buf.size() < kMessageMaxBatchSize && ipc_manager_->try_take(s)) {
@@ -234,10 +518,17 @@ void KinesisProducer::drain_messages() {
     if (!buf.empty()) {
       std::vector<std::string> batch;
       std::swap(batch, buf);
-      executor_->submit([batch = std::move(batch), this]() mutable {
+      // The messages were read into memory on this thread's node.
+      auto node = aws::utils::current_numa_node();
+      auto epoch = ipc_batches_.accepted();
+      executor_->submit([batch = std::move(batch), node, epoch, this]() mutable {
+        if (node != aws::utils::current_numa_node()) {
+          cross_node_batches_++;
+        }
         for (auto& s : batch) {
           this->on_ipc_message(std::move(s));
         }
+        ipc_batches_.finished(epoch);
       });
       backoff = kMessageDrainMinBackoff;
     } else {
@@ -265,6 +556,8 @@ void KinesisProducer::on_ipc_message(std::string&& message) noexcept {
     on_set_credentials(m.set_credentials());
   } else if (m.has_stream_metadata()) {
     on_stream_metadata(m.stream_metadata());
+  } else if (m.has_update_configuration()) {
+    on_update_configuration(m.update_configuration());
   } else {
     LOG(error) << "Received unknown message type";
   }
@@ -272,19 +565,72 @@ void KinesisProducer::on_ipc_message(std::string&& message) noexcept {
 
 void KinesisProducer::on_put_record(aws::kinesis::protobuf::Message& m) {
   auto ur = std::make_shared<UserRecord>(m);
+  auto& pipeline = pipelines_[ur->stream()];
+  auto t = pipeline.config().snapshot();
   ur->set_deadline_from_now(
-      std::chrono::milliseconds(config_->record_max_buffered_time()));
-  ur->set_expiration_from_now(
-      std::chrono::milliseconds(config_->record_ttl()));
-  pipelines_[ur->stream()].put(ur);
+      std::chrono::milliseconds(t.record_max_buffered_time));
+  ur->set_expiration_from_now(std::chrono::milliseconds(t.record_ttl));
+  pipeline.put(ur);
 }
 
 void KinesisProducer::on_flush(const aws::kinesis::protobuf::Flush& flush_msg) {
+  if (!flush_msg.has_flush_id()) {
+    if (flush_msg.has_stream_name()) {
+      pipelines_[flush_msg.stream_name()].flush();
+    } else {
+      pipelines_.foreach([](auto&, auto pipeline) { pipeline->flush(); });
+    }
+    return;
+  }
+
+  // Earlier batches may still be putting records that were read before this
+  // flush, so the flush is only registered once every batch taken so far,
+  // this one included, has finished. That can also cover some records read
+  // after it, which only makes the reply later.
+  ipc_batches_.flush([this, flush_msg] { this->flush_barrier(flush_msg); });
+}
+
+void KinesisProducer::flush_barrier(
+    const aws::kinesis::protobuf::Flush& flush_msg) {
+  // The reply is sent when the last pipeline is done. The extra count keeps
+  // it from going out before every pipeline has been asked.
+  auto flush_id = flush_msg.flush_id();
+  auto remaining = std::make_shared<std::atomic<size_t>>(1);
+  auto done = [this, flush_id, remaining] {
+    if (--(*remaining) == 0) {
+      aws::kinesis::protobuf::Message m;
+      m.set_id(::rand());
+      m.mutable_flush_complete()->set_flush_id(flush_id);
+      ipc_manager_->put(m.SerializeAsString());
+    }
+  };
   if (flush_msg.has_stream_name()) {
-    pipelines_[flush_msg.stream_name()].flush();
+    (*remaining)++;
+    pipelines_[flush_msg.stream_name()].flush(done);
   } else {
-    pipelines_.foreach([](auto&, auto pipeline) { pipeline->flush(); });
+    pipelines_.foreach([&](auto&, auto pipeline) {
+      (*remaining)++;
+      pipeline->flush(done);
+    });
   }
+  done();
+}
+
+void KinesisProducer::on_update_configuration(
+    const aws::kinesis::protobuf::UpdateConfiguration& update) {
+  try {
+    config_->update_from_protobuf_msg(update);
+  } catch (const std::exception& ex) {
+    LOG(error) << "Rejected configuration update: " << ex.what();
+    return;
+  }
+  // Pipelines sharing the global configuration apply the same values again,
+  // which changes nothing.
+  pipelines_.foreach([&](auto&, auto pipeline) {
+    pipeline->update_configuration(update);
+  });
+  LOG(info) << "Applied configuration update: "
+            << update.ShortDebugString();
 }
 
 void KinesisProducer::on_stream_metadata(
@@ -419,17 +765,133 @@ void KinesisProducer::report_outstanding() {
         ->put(pipeline->outstanding_user_records());
   });
 
+  metrics_manager_
+      ->finder()
+      .set_name(aws::metrics::constants::Names::BufferedBytes)
+      .find()
+      ->put(memory_budget_->used());
+  memory_budget_->update_backpressure();
+
   auto delay = std::chrono::milliseconds(200);
   if (!report_outstanding_) {
     report_outstanding_ =
         executor_->schedule(
             [this] { this->report_outstanding(); },
-            delay);
+            delay,
+            aws::utils::Priority::Low);
   } else {
     report_outstanding_->reschedule(delay);
   }
 }
 
+// Publishes the executor's queue depth, task wait and run times and timer
+// lateness per task priority. Late timers mean deadline flushes are delayed,
+// and long waits that the executor's threads are saturated. Also publishes how
+// many batches of IPC messages were handled on a different NUMA node than the
+// one they were read on.
+void KinesisProducer::report_executor_metrics() {
+  for (size_t i = 0; i < aws::utils::kNumPriorities; i++) {
+    auto priority = static_cast<aws::utils::Priority>(i);
+    auto stats = executor_->queue_stats(priority);
+    auto& last = executor_stats_[i];
+    auto find = [&](auto name) {
+      return metrics_manager_
+          ->finder()
+          .set_name(name)
+          .set_task_priority(priority_name(priority))
+          .find();
+    };
+
+    // Each statistic is a metric of its own, so that CloudWatch's average
+    // and sum of each are meaningful.
+    auto put_summary = [&](const auto& now,
+                           const auto& before,
+                           auto p50_name,
+                           auto p99_name,
+                           auto max_name) {
+      HistogramSummary summary;
+      if (summarize_histogram(now, before, summary)) {
+        find(p50_name)->put(summary.p50);
+        find(p99_name)->put(summary.p99);
+        find(max_name)->put(summary.max);
+      }
+    };
+
+    using Names = aws::metrics::constants::Names;
+    find(Names::ExecutorQueueDepth)->put(stats.depth);
+    put_summary(stats.wait,
+                last.wait,
+                Names::ExecutorTaskWaitTimeP50,
+                Names::ExecutorTaskWaitTimeP99,
+                Names::ExecutorTaskWaitTimeMax);
+    put_summary(stats.run,
+                last.run,
+                Names::ExecutorTaskRunTimeP50,
+                Names::ExecutorTaskRunTimeP99,
+                Names::ExecutorTaskRunTimeMax);
+    put_summary(stats.timer_lateness,
+                last.timer_lateness,
+                Names::ExecutorTimerLatenessP50,
+                Names::ExecutorTimerLatenessP99,
+                Names::ExecutorTimerLatenessMax);
+    last = stats;
+  }
+
+  metrics_manager_
+      ->finder()
+      .set_name(aws::metrics::constants::Names::CrossNodeBatches)
+      .find()
+      ->put(cross_node_batches_.exchange(0));
+
+  if (!executor_metrics_) {
+    executor_metrics_ =
+        executor_->schedule(
+            [this] { this->report_executor_metrics(); },
+            kExecutorMetricsInterval,
+            aws::utils::Priority::Low);
+  } else {
+    executor_metrics_->reschedule(kExecutorMetricsInterval);
+  }
+}
+
+// Reports new connections, and if the client was (nearly) idle since the last
+// run, issues min_connections concurrent lightweight requests so that at least
+// that many connections stay established for the next burst.
+void KinesisProducer::keep_connections_alive() {
+  auto stats = ConnectionMonitor::drain();
+  auto find = [this](auto name) {
+    return metrics_manager_->finder().set_name(name).find();
+  };
+  find(aws::metrics::constants::Names::ConnectionsEstablished)
+      ->put(stats.handshakes.size());
+  for (auto handshake : stats.handshakes) {
+    find(aws::metrics::constants::Names::ConnectionHandshakeTime)
+        ->put(handshake.count());
+  }
+
+  if (stats.requests < config_->min_connections()) {
+    std::string stream;
+    pipelines_.foreach([&](auto& s, auto /*pipeline*/) {
+      if (stream.empty()) {
+        stream = s;
+      }
+    });
+    if (!stream.empty()) {
+      warm_connections(stream, config_->min_connections());
+    }
+  }
+
+  if (!keep_alive_) {
+    keep_alive_ =
+        executor_->schedule(
+            [this] { this->keep_connections_alive(); },
+            kKeepAliveInterval,
+            aws::utils::Priority::Low);
+  } else {
+    keep_alive_->reschedule(kKeepAliveInterval);
+  }
+}
+
 } //namespace core
 } //namespace kinesis
 } //namespace aws
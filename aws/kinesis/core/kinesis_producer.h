@@ -52,9 +52,16 @@ class KinesisProducer : boost::noncopyable {
         }),
         shutdown_(false) {
     create_kinesis_client(ca_path, ca_file);
+    create_transport(ca_path, ca_file);
+    request_serializer_ = std::make_shared<RequestSerializer>(executor_);
     create_cw_client(ca_path, ca_file);
     create_metrics_manager();
+    create_memory_budget();
     report_outstanding();
+    report_executor_metrics();
+    keep_connections_alive();
+    prewarm();
+    recover_spilled_streams();
     message_drainer_ = aws::thread([this] { this->drain_messages(); });
   }
 
@@ -71,15 +78,28 @@ class KinesisProducer : boost::noncopyable {
   static const std::chrono::microseconds kMessageDrainMinBackoff;
   static const std::chrono::microseconds kMessageDrainMaxBackoff;
   static constexpr const size_t kMessageMaxBatchSize = 16;
+  static const std::chrono::seconds kKeepAliveInterval;
+  static const std::chrono::seconds kExecutorMetricsInterval;
 
   void create_metrics_manager();
 
   void create_kinesis_client(const std::string& ca_path, const std::string& ca_file);
 
+  void create_transport(const std::string& ca_path, const std::string& ca_file);
+
   void create_cw_client(const std::string& ca_path, const std::string& ca_file);
 
+  void create_memory_budget();
+
   Pipeline* create_pipeline(const std::string& stream);
 
+  void prewarm();
+
+  void recover_spilled_streams();
+
+  std::shared_ptr<std::atomic<size_t>> warm_connections(const std::string& stream,
+                                                        size_t count);
+
   void drain_messages();
 
   void on_ipc_message(std::string&& message) noexcept;
@@ -88,16 +108,25 @@ class KinesisProducer : boost::noncopyable {
 
   void on_flush(const aws::kinesis::protobuf::Flush& flush_msg);
 
+  void flush_barrier(const aws::kinesis::protobuf::Flush& flush_msg);
+
   void on_metrics_request(const aws::kinesis::protobuf::Message& m);
 
   void on_set_credentials(
       const aws::kinesis::protobuf::SetCredentials& set_creds);
 
+  void on_update_configuration(
+      const aws::kinesis::protobuf::UpdateConfiguration& update);
+
   void on_stream_metadata(
       const aws::kinesis::protobuf::StreamMetadata& metadata);
 
   void report_outstanding();
 
+  void report_executor_metrics();
+
+  void keep_connections_alive();
+
   std::string region_;
 
   std::shared_ptr<Configuration> config_;
@@ -107,10 +136,17 @@ class KinesisProducer : boost::noncopyable {
       cw_creds_provider_;
   std::shared_ptr<Aws::Kinesis::KinesisClient> kinesis_client_;
   std::shared_ptr<Aws::CloudWatch::CloudWatchClient> cw_client_;
+  std::shared_ptr<PutRecordsTransport> transport_;
+  std::shared_ptr<RequestSerializer> request_serializer_;
   std::shared_ptr<aws::utils::Executor> executor_;
 
   std::shared_ptr<IpcManager> ipc_manager_;
   std::shared_ptr<aws::metrics::MetricsManager> metrics_manager_;
+  std::shared_ptr<MemoryBudget> memory_budget_;
+  // Put records responses being finished on SDK threads rather than on the
+  // executor, across all pipelines. Declared before the pipelines, which
+  // refer to it.
+  std::atomic<size_t> inline_completions_{0};
 
   aws::utils::ConcurrentHashMap<std::string, Pipeline> pipelines_;
 
@@ -121,6 +157,14 @@ class KinesisProducer : boost::noncopyable {
   aws::thread message_drainer_;
 
   std::shared_ptr<aws::utils::ScheduledCallback> report_outstanding_;
+  std::shared_ptr<aws::utils::ScheduledCallback> keep_alive_;
+  std::shared_ptr<aws::utils::ScheduledCallback> executor_metrics_;
+  std::array<aws::utils::Executor::QueueStats, aws::utils::kNumPriorities>
+      executor_stats_;
+  std::atomic<uint64_t> cross_node_batches_{0};
+  // Counts the IPC batches still running. They run concurrently, so a flush
+  // with an id uses this to wait for the puts read before it.
+  FlushTracker ipc_batches_;
 
   std::string get_stream_id_from_cache(const std::string& stream_name) const;
 };
@@ -105,6 +105,12 @@ std::string KinesisRecord::serialize() {
     return items_.front()->data();
   }
 
+  if (serialized_) {
+    auto result = std::move(*serialized_);
+    serialized_ = boost::none;
+    return result;
+  }
+
   std::string s;
   aggregated_record_.SerializeToString(&s);
 
@@ -116,6 +122,12 @@ std::string KinesisRecord::serialize() {
   return result;
 }
 
+void KinesisRecord::serialize_ahead() {
+  if (items_.size() > 1 && !serialized_) {
+    serialized_ = serialize();
+  }
+}
+
 std::string KinesisRecord::partition_key() const {
   if (items_.empty()) {
     throw std::runtime_error(
@@ -144,6 +156,7 @@ std::string KinesisRecord::explicit_hash_key() const {
 
 void KinesisRecord::after_add(const std::shared_ptr<UserRecord>& ur) {
   cached_accurate_size_valid_ = false;
+  serialized_ = boost::none;
 
   auto new_record = aggregated_record_.add_records();
   new_record->set_data(ur->data());
@@ -174,6 +187,7 @@ void KinesisRecord::after_add(const std::shared_ptr<UserRecord>& ur) {
 
 void KinesisRecord::after_remove(const std::shared_ptr<UserRecord>& ur) {
   cached_accurate_size_valid_ = false;
+  serialized_ = boost::none;
 
   aggregated_record_.mutable_records()->RemoveLast();
   estimated_size_ -= ur->data().length() + 3;
@@ -212,6 +226,7 @@ void KinesisRecord::after_remove(const std::shared_ptr<UserRecord>& ur) {
 
 void KinesisRecord::after_clear() {
   cached_accurate_size_valid_ = false;
+  serialized_ = boost::none;
   explicit_hash_keys_.clear();
   partition_keys_.clear();
   aggregated_record_.mutable_records()->Clear();
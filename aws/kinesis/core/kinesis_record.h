@@ -18,6 +18,8 @@
 
 #include <unordered_map>
 
+#include <boost/optional.hpp>
+
 #include <aws/kinesis/protobuf/messages.pb.h>
 #include <aws/kinesis/core/serializable_container.h>
 #include <aws/kinesis/core/user_record.h>
@@ -53,8 +55,15 @@ class KinesisRecord : public SerializableContainer<UserRecord> {
   size_t accurate_size() override;
   size_t estimated_size() override;
 
+  // Returns the serialized record, taking the result of serialize_ahead() if
+  // there is one.
   std::string serialize() override;
 
+  // Serializes an aggregated record now and keeps the result for the next
+  // serialize(), so that can be done off the thread that assembles the
+  // request. Changing the record discards it.
+  void serialize_ahead();
+
   std::string partition_key() const;
   std::string explicit_hash_key() const;
 
@@ -72,6 +81,7 @@ class KinesisRecord : public SerializableContainer<UserRecord> {
   size_t estimated_size_;
   size_t cached_accurate_size_;
   bool cached_accurate_size_valid_;
+  boost::optional<std::string> serialized_;
 };
 
 } //namespace core
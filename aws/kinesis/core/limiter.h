@@ -16,6 +16,8 @@
 #ifndef AWS_KINESIS_CORE_LIMITER_H_
 #define AWS_KINESIS_CORE_LIMITER_H_
 
+#include <cmath>
+
 #include <boost/noncopyable.hpp>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/ordered_index.hpp>
@@ -29,11 +31,15 @@
 #include <aws/utils/logging.h>
 #include <aws/utils/time_sensitive_queue.h>
 #include <aws/utils/token_bucket.h>
+#include <aws/mutex.h>
 
 namespace aws {
 namespace kinesis {
 namespace core {
 
+using Clock = std::chrono::steady_clock;
+using TimePoint = Clock::time_point;
+
 namespace detail {
 
 // The limiter in its current form is not going to eliminate throttling errors,
@@ -50,7 +56,9 @@ class ShardLimiter : boost::noncopyable {
   static const constexpr uint64_t kBytesPerSecLimit = 1024 * 1024;
   static const constexpr uint64_t kBytesPerRecordLimit = 1024 * 1024 * 10;
 
-  ShardLimiter(double token_growth_multiplier = 1.0) {
+  ShardLimiter(double token_growth_multiplier = 1.0)
+      : token_growth_multiplier_(token_growth_multiplier),
+        applied_token_growth_multiplier_(token_growth_multiplier) {
     token_bucket_.add_token_stream(
           kRecordsPerSecLimit,
           token_growth_multiplier * kRecordsPerSecLimit);
@@ -59,18 +67,25 @@ class ShardLimiter : boost::noncopyable {
           token_growth_multiplier * kBytesPerSecLimit);
   }
 
-  void put(std::shared_ptr<KinesisRecord> incoming,
-           const Callback& callback,
-           const Callback& expired_callback) {
+  TimePoint put(std::shared_ptr<KinesisRecord> incoming,
+                const Callback& callback,
+                const Callback& expired_callback) {
     queue_.put(std::move(incoming));
-    drain(callback, expired_callback);
+    return drain(callback, expired_callback);
   }
 
-  void drain(const Callback& callback, const Callback& expired_callback) {
+  // Sends the queued records there are tokens for. Returns when drain should
+  // be called again: when the next record can be sent or expires, whichever
+  // comes first, or TimePoint::max() if nothing is queued.
+  TimePoint drain(const Callback& callback, const Callback& expired_callback) {
     if (draining_.test_and_set()) {
-      return;
+      // The thread draining may have missed records put meanwhile, so look
+      // again in a millisecond.
+      return Clock::now() + std::chrono::milliseconds(1);
     }
 
+    apply_token_growth_multiplier();
+
     std::shared_ptr<KinesisRecord> kr;
     while (queue_.try_take(kr)) {
       internal_queue_.insert(std::move(kr));
@@ -78,29 +93,93 @@ class ShardLimiter : boost::noncopyable {
 
     internal_queue_.consume_expired(expired_callback);
 
+    double wait_seconds = 0;
     internal_queue_.consume_by_deadline([&](const auto& kr) {
       double bytes = kr->accurate_size();
       if (token_bucket_.try_take({1, bytes})) {
         callback(kr);
         return true;
       }
+      wait_seconds = token_bucket_.seconds_until({1, bytes});
       return false;
     });
 
+    auto next = TimePoint::max();
+    if (auto kr = internal_queue_.next_to_expire()) {
+      next = kr->expiration();
+      if (std::isfinite(wait_seconds)) {
+        next = std::min(
+            next,
+            Clock::now() +
+                std::chrono::duration_cast<Clock::duration>(
+                    std::chrono::duration<double>(wait_seconds)));
+      }
+    }
+
+    draining_.clear();
+    return next;
+  }
+
+  // Removes the queued records closest to expiring until at least bytes
+  // have been removed, appending them to dropped. Returns the bytes removed,
+  // which is 0 if another thread is draining.
+  uint64_t shed(uint64_t bytes,
+                std::vector<std::shared_ptr<KinesisRecord>>& dropped) {
+    if (draining_.test_and_set()) {
+      return 0;
+    }
+
+    std::shared_ptr<KinesisRecord> kr;
+    while (queue_.try_take(kr)) {
+      internal_queue_.insert(std::move(kr));
+    }
+
+    uint64_t shed = 0;
+    internal_queue_.consume_by_expiration([&](const auto& kr) {
+      if (shed >= bytes) {
+        return false;
+      }
+      shed += kr->accurate_size();
+      dropped.push_back(kr);
+      return true;
+    });
+
     draining_.clear();
+    return shed;
+  }
+
+  // Changes how fast tokens grow, relative to the per shard limits. Takes
+  // effect on the next drain.
+  void set_token_growth_multiplier(double token_growth_multiplier) {
+    token_growth_multiplier_ = token_growth_multiplier;
   }
 
  private:
+  void apply_token_growth_multiplier() {
+    double m = token_growth_multiplier_;
+    if (m != applied_token_growth_multiplier_) {
+      token_bucket_.set_rates({m * kRecordsPerSecLimit,
+                               m * kBytesPerSecLimit});
+      applied_token_growth_multiplier_ = m;
+    }
+  }
+
   // The bucket and internal queue are synchronized with the draining_ flag,
   // only one thread can be performing drain at a time.
   std::atomic_flag draining_ = ATOMIC_FLAG_INIT;
   aws::utils::TokenBucket token_bucket_;
+  std::atomic<double> token_growth_multiplier_;
+  double applied_token_growth_multiplier_;
   aws::utils::TimeSensitiveQueue<KinesisRecord> internal_queue_;
   aws::utils::ConcurrentLinkedQueue<std::shared_ptr<KinesisRecord>> queue_;
 };
 
 } // namespace detail
 
+// Normally every shard is drained on a fixed interval. With direct_send, the
+// limiter is event-driven instead: a shard is drained when a record is put to
+// it, and a wakeup is scheduled for when the earliest waiting record can be
+// sent or expires, so records don't sit out the rest of an interval.
 class Limiter : boost::noncopyable {
  public:
   Limiter(std::shared_ptr<aws::utils::Executor> executor,
@@ -110,30 +189,92 @@ class Limiter : boost::noncopyable {
       : executor_(executor),
         callback_(callback),
         expired_callback_(expired_callback),
-        limiters_([=](auto) {
-          return new detail::ShardLimiter(
-              (double) config->rate_limit() / 100.0);
+        config_(config),
+        event_driven_(config->direct_send()),
+        limiters_([this](auto) {
+          return new detail::ShardLimiter(this->token_growth_multiplier());
         }) {
-    poll();
+    if (!event_driven_) {
+      poll();
+    }
   }
 
   void add_error(const std::string& code, const std::string& msg) {
     // TODO react to throttling errors
   }
 
+  // Drops records waiting for capacity, those closest to expiring first,
+  // until at least bytes have been dropped or none are left. The caller owns
+  // the dropped records and has to fail them.
+  std::vector<std::shared_ptr<KinesisRecord>> shed(uint64_t bytes) {
+    std::vector<std::shared_ptr<KinesisRecord>> dropped;
+    uint64_t shed = 0;
+    limiters_.foreach([&](auto, auto limiter) {
+      if (shed < bytes) {
+        shed += limiter->shed(bytes - shed, dropped);
+      }
+    });
+    return dropped;
+  }
+
+  // Applies the rate limit currently in the configuration to every shard.
+  void update_rate_limit() {
+    auto m = token_growth_multiplier();
+    limiters_.foreach([=](auto, auto limiter) {
+      limiter->set_token_growth_multiplier(m);
+    });
+  }
+
   void put(const std::shared_ptr<KinesisRecord>& kr) {
     // Limiter doesn't work if we don't know which shard the record is going to
     auto shard_id = kr->items().front()->predicted_shard();
     if (!shard_id) {
       callback_(kr);
     } else {
-      limiters_[*shard_id].put(kr, callback_, expired_callback_);
+      put(kr, *shard_id);
+    }
+  }
+
+  // For records going to a known shard that isn't set as their predicted
+  // shard, because they shouldn't be retried if they land elsewhere.
+  void put(const std::shared_ptr<KinesisRecord>& kr, uint64_t shard_id) {
+    auto next = limiters_[shard_id].put(kr, callback_, expired_callback_);
+    if (event_driven_) {
+      wake_up_at(next);
     }
   }
 
  private:
   static constexpr const int kDrainDelayMillis = 25;
 
+  void wake_up() {
+    auto next = TimePoint::max();
+    limiters_.foreach([&](auto, auto limiter) {
+      next = std::min(next, limiter->drain(callback_, expired_callback_));
+    });
+    wake_up_at(next);
+  }
+
+  // Moves the wakeup earlier if needed; a later one also drains every shard.
+  void wake_up_at(TimePoint at) {
+    if (at == TimePoint::max()) {
+      return;
+    }
+    aws::lock_guard<aws::mutex> lk(wake_up_mutex_);
+    if (!scheduled_poll_) {
+      scheduled_poll_ = executor_->schedule([this] { this->wake_up(); },
+                                            at,
+                                            aws::utils::Priority::High);
+    } else if (scheduled_poll_->completed() ||
+               at < scheduled_poll_->expiration()) {
+      scheduled_poll_->reschedule(at);
+    }
+  }
+
+  double token_growth_multiplier() const {
+    return (double) config_->rate_limit() / 100.0;
+  }
+
   void poll() {
     limiters_.foreach([this](auto, auto limiter) {
       limiter->drain(callback_, expired_callback_);
@@ -141,7 +282,9 @@ class Limiter : boost::noncopyable {
 
     std::chrono::milliseconds delay(kDrainDelayMillis);
     if (!scheduled_poll_) {
-      scheduled_poll_ = executor_->schedule([this] { this->poll(); }, delay);
+      scheduled_poll_ = executor_->schedule([this] { this->poll(); },
+                                            delay,
+                                            aws::utils::Priority::High);
     } else {
       scheduled_poll_->reschedule(delay);
     }
@@ -150,7 +293,10 @@ class Limiter : boost::noncopyable {
   std::shared_ptr<aws::utils::Executor> executor_;
   detail::ShardLimiter::Callback callback_;
   detail::ShardLimiter::Callback expired_callback_;
+  std::shared_ptr<Configuration> config_;
+  const bool event_driven_;
   aws::utils::ConcurrentHashMap<uint64_t, detail::ShardLimiter> limiters_;
+  aws::mutex wake_up_mutex_;
   std::shared_ptr<aws::utils::ScheduledCallback> scheduled_poll_;
 };
 
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_KINESIS_CORE_MEMORY_BUDGET_H_
+#define AWS_KINESIS_CORE_MEMORY_BUDGET_H_
+
+#include <atomic>
+#include <functional>
+#include <stdexcept>
+#include <string>
+
+#include <boost/noncopyable.hpp>
+
+#include <aws/kinesis/core/user_record.h>
+#include <aws/mutex.h>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+// Bytes held by user records across all pipelines, from the time a record is
+// put until its result is returned. With a limit of 0 records are only
+// counted.
+//
+// What happens when the limit is exceeded depends on the policy:
+//
+// Fail: the record being put is failed right away.
+// DropOldest: the pipeline drops its records closest to expiring to make
+//   room, and fails the record being put only if it can't.
+// Backpressure: records are always accepted, but the wrapper is told to stop
+//   sending records once usage goes over the limit, and to resume once it is
+//   back down to kResumeRatio of the limit.
+class MemoryBudget : boost::noncopyable {
+ public:
+  enum class Policy {
+    Fail,
+    DropOldest,
+    Backpressure
+  };
+
+  // Called with true when the wrapper should pause, and false when it can
+  // resume, along with the bytes in use. Calls are serialized.
+  using BackpressureCallback = std::function<void (bool paused, uint64_t used)>;
+
+  static constexpr const double kResumeRatio = 0.9;
+
+  MemoryBudget(uint64_t limit = 0,
+               Policy policy = Policy::Fail,
+               BackpressureCallback backpressure_cb = BackpressureCallback())
+      : limit_(limit),
+        resume_at_(static_cast<uint64_t>(limit * kResumeRatio)),
+        policy_(policy),
+        backpressure_cb_(std::move(backpressure_cb)),
+        used_(0),
+        paused_(false) {}
+
+  static Policy parse_policy(const std::string& s) {
+    if (s == "fail") {
+      return Policy::Fail;
+    } else if (s == "drop_oldest") {
+      return Policy::DropOldest;
+    } else if (s == "backpressure") {
+      return Policy::Backpressure;
+    }
+    throw std::runtime_error("Unknown memory budget policy \"" + s + "\"");
+  }
+
+  // What a record is charged: its payload plus a fixed overhead for the
+  // record itself.
+  static uint64_t bytes(const UserRecord& ur) noexcept {
+    return ur.data().size() + ur.partition_key().size() + sizeof(UserRecord);
+  }
+
+  // Charges bytes to the budget. Returns false if that took usage over the
+  // limit and the caller has to apply the policy; the bytes are charged
+  // either way and must be released when the record finishes.
+  bool acquire(uint64_t bytes) {
+    auto used = used_.fetch_add(bytes) + bytes;
+    if (limit_ == 0 || used <= limit_) {
+      return true;
+    }
+    if (policy_ == Policy::Backpressure) {
+      update_backpressure();
+      return true;
+    }
+    return false;
+  }
+
+  void release(uint64_t bytes) {
+    used_ -= bytes;
+    if (paused_) {
+      update_backpressure();
+    }
+  }
+
+  // Sends a pause or resume if usage has crossed a watermark since the last
+  // one. acquire and release do this already; calling it periodically as well
+  // makes sure a resume isn't missed when the last release races with a pause.
+  void update_backpressure() {
+    if (policy_ != Policy::Backpressure || limit_ == 0) {
+      return;
+    }
+    aws::lock_guard<aws::mutex> lk(mutex_);
+    auto used = used_.load();
+    bool paused = paused_;
+    if (!paused && used > limit_) {
+      paused = true;
+    } else if (paused && used <= resume_at_) {
+      paused = false;
+    } else {
+      return;
+    }
+    paused_ = paused;
+    if (backpressure_cb_) {
+      backpressure_cb_(paused, used);
+    }
+  }
+
+  uint64_t used() const noexcept {
+    return used_;
+  }
+
+  uint64_t limit() const noexcept {
+    return limit_;
+  }
+
+  // Bytes over the limit, 0 if within it.
+  uint64_t excess() const noexcept {
+    auto used = used_.load();
+    return limit_ > 0 && used > limit_ ? used - limit_ : 0;
+  }
+
+  Policy policy() const noexcept {
+    return policy_;
+  }
+
+  bool paused() const noexcept {
+    return paused_;
+  }
+
+ private:
+  const uint64_t limit_;
+  const uint64_t resume_at_;
+  const Policy policy_;
+  BackpressureCallback backpressure_cb_;
+  std::atomic<uint64_t> used_;
+  std::atomic<bool> paused_;
+  aws::mutex mutex_;
+};
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
+
+#endif //AWS_KINESIS_CORE_MEMORY_BUDGET_H_
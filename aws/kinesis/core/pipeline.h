@@ -16,17 +16,25 @@
 #ifndef AWS_KINESIS_CORE_PIPELINE_H_
 #define AWS_KINESIS_CORE_PIPELINE_H_
 
+#include <boost/filesystem.hpp>
 #include <boost/format.hpp>
 #include <iomanip>
 #include <atomic>
+#include <deque>
 
 #include <aws/kinesis/core/aggregator.h>
 #include <aws/kinesis/core/collector.h>
 #include <aws/kinesis/core/configuration.h>
+#include <aws/kinesis/core/direct_sender.h>
+#include <aws/kinesis/core/flush_tracker.h>
 #include <aws/kinesis/core/ipc_manager.h>
 #include <aws/kinesis/core/limiter.h>
+#include <aws/kinesis/core/memory_budget.h>
 #include <aws/kinesis/core/put_records_context.h>
+#include <aws/kinesis/core/put_records_transport.h>
+#include <aws/kinesis/core/request_serializer.h>
 #include <aws/kinesis/core/retrier.h>
+#include <aws/kinesis/core/spill_log.h>
 #include <aws/kinesis/KinesisClient.h>
 #include <aws/kinesis/model/ListShardsRequest.h>
 #include <aws/metrics/metrics_manager.h>
@@ -51,7 +59,13 @@ class Pipeline : boost::noncopyable {
       std::shared_ptr<Configuration> config,
       std::shared_ptr<aws::utils::Executor> executor,
       std::shared_ptr<Aws::Kinesis::KinesisClient> kinesis_client,
+      std::shared_ptr<Aws::Utils::Threading::Executor> sdk_executor,
+      std::shared_ptr<PutRecordsTransport> transport,
+      std::shared_ptr<RequestSerializer> request_serializer,
       std::shared_ptr<aws::metrics::MetricsManager> metrics_manager,
+      std::shared_ptr<MemoryBudget> memory_budget,
+      std::atomic<size_t>& inline_completions,
+      size_t max_inline_completions,
       Retrier::UserRecordCallback finish_user_record_cb,
       StreamIdGetter stream_id_getter)
       : stream_(std::move(stream)),
@@ -60,10 +74,16 @@ class Pipeline : boost::noncopyable {
         stream_id_(""),
         stream_id_getter_(std::move(stream_id_getter)),
         config_(std::move(config)),
-        stats_logger_(stream_, config_->record_max_buffered_time()),
         executor_(std::move(executor)),
+        stats_logger_(stream_, config_->record_max_buffered_time(), executor_),
         kinesis_client_(std::move(kinesis_client)),
+        sdk_executor_(std::move(sdk_executor)),
+        transport_(std::move(transport)),
+        request_serializer_(std::move(request_serializer)),
         metrics_manager_(std::move(metrics_manager)),
+        memory_budget_(std::move(memory_budget)),
+        inline_completions_(inline_completions),
+        max_inline_completions_(max_inline_completions),
         finish_user_record_cb_(std::move(finish_user_record_cb)),
         shard_map_(
             std::make_shared<ShardMap>(
@@ -72,7 +92,11 @@ class Pipeline : boost::noncopyable {
                 stream_,
                 stream_arn_,
                 stream_id_getter_,
-                metrics_manager_)),
+                metrics_manager_,
+                ShardMap::kMinBackoff,
+                ShardMap::kMaxBackoff,
+                ShardMap::kClosedShardTtl,
+                shard_map_cache())),
         aggregator_(
             std::make_shared<Aggregator>(
                     executor_,
@@ -85,22 +109,45 @@ class Pipeline : boost::noncopyable {
             std::make_shared<Limiter>(
                 executor_,
                 [this](auto& kr) { this->collector_put(kr); },
-                [this](auto& kr) { this->retrier_put_kr(kr); },
+                [this](auto& kr) {
+                  this->retrier_put_kr(
+                      kr, "Expiration reached while waiting in limiter");
+                },
                 config_)),
         collector_(
             std::make_shared<Collector>(
                     executor_,
                     [this](auto prr) { this->send_put_records_request(prr); },
+                    [this](auto& kr) {
+                      this->retrier_put_kr(
+                          kr,
+                          "Expiration reached while held for the shard's "
+                          "requests in flight");
+                    },
                     config_,
                     stats_logger_.stage2(),
                     metrics_manager_)),
+        direct_sender_(
+            config_->direct_send()
+                ? std::make_shared<DirectSender>(
+                      [this](auto prr) { this->send_put_records_request(prr); },
+                      [this](auto& kr) {
+                        this->retrier_put_kr(
+                            kr,
+                            "Expiration reached while waiting for a request "
+                            "slot");
+                      },
+                      config_)
+                : nullptr),
         retrier_(
             std::make_shared<Retrier>(
                 config_,
                 [this](auto& ur) { this->finish_user_record(ur); },
                 [this](auto& ur) { this->aggregator_put(ur); },
                 [this](auto& actual_shard) { return shard_map_->hashrange(actual_shard); },
-                [this](auto& tp, auto predicted_shard) { shard_map_->invalidate(tp, predicted_shard); },
+                [this](auto& tp, auto predicted_shard, auto actual_shard) {
+                  shard_map_->invalidate(tp, predicted_shard, actual_shard);
+                },
                 [this](auto& code, auto& msg) {
                   limiter_->add_error(code, msg);
                 },
@@ -111,6 +158,13 @@ class Pipeline : boost::noncopyable {
                 .set_name(aws::metrics::constants::Names::UserRecordsReceived)
                 .set_stream(stream_)
                 .find()),
+        user_records_spilled_metric_(
+            metrics_manager_
+                ->finder()
+                .set_name(aws::metrics::constants::Names::UserRecordsSpilled)
+                .set_stream(stream_)
+                .find()),
+        spill_log_(spill_log()),
         outstanding_user_records_(0) {
 
         if (stream_id_getter_) {
@@ -122,19 +176,63 @@ class Pipeline : boost::noncopyable {
         } else {
           LOG(info) << "Created pipeline for stream \"" << stream_ << "\"";
         }
+
+        if (spill_log_) {
+          scheduled_replay_ = executor_->schedule(
+              [this] { this->replay_spilled(); },
+              TimePoint::max(),
+              aws::utils::Priority::Low);
+          replay_spilled();
+        }
   }
 
   void put(const std::shared_ptr<UserRecord>& ur) {
     outstanding_user_records_++;
+    ur->flush_epoch(flush_tracker_.accepted());
     user_records_rcvd_metric_->put(1);
-    aggregator_put(ur);
+    if (!spill(ur)) {
+      accept(ur);
+    }
   }
 
   void flush() {
+    if (direct_sender_) {
+      // Nothing is held back waiting for a flush.
+      return;
+    }
     aggregator_->flush();
     executor_->schedule(
         [this] { collector_->flush(); },
-        std::chrono::milliseconds(80));
+        std::chrono::milliseconds(80),
+        aws::utils::Priority::High);
+  }
+
+  // Flushes, and calls done once every record put before this call has
+  // finished.
+  void flush(const FlushTracker::Callback& done) {
+    flush_tracker_.flush(done);
+    flush();
+  }
+
+  // The stream's configuration, which has its override applied if it has one.
+  const Configuration& config() const noexcept {
+    return *config_;
+  }
+
+  // Applies an update that has already been validated against the global
+  // configuration. Deadline settings are read as records arrive and need
+  // nothing more here.
+  void update_configuration(
+      const aws::kinesis::protobuf::UpdateConfiguration& update) {
+    config_->update_from_protobuf_msg(update);
+    aggregator_->update_limits();
+    collector_->update_limits();
+    limiter_->update_rate_limit();
+  }
+
+  // True once a shard map is available for aggregation.
+  bool has_shard_map() {
+    return shard_map_->epoch() > 0;
   }
 
   uint64_t outstanding_user_records() const noexcept {
@@ -149,7 +247,197 @@ class Pipeline : boost::noncopyable {
 
  private:
 
+  std::shared_ptr<ShardMapCache> shard_map_cache() const {
+    if (config_->shard_map_cache_dir().empty()) {
+      return nullptr;
+    }
+    auto path = boost::filesystem::path(config_->shard_map_cache_dir()) /
+        (region_ + "-" + stream_ + ".shardmap");
+    return std::make_shared<ShardMapCache>(
+        path.string(),
+        std::chrono::milliseconds(config_->shard_map_cache_ttl()));
+  }
+
+  std::shared_ptr<SpillLog> spill_log() const {
+    if (config_->spill_dir().empty()) {
+      return nullptr;
+    }
+    auto path = boost::filesystem::path(config_->spill_dir()) /
+        (region_ + "-" + stream_);
+    try {
+      return std::make_shared<SpillLog>(path.string(),
+                                        config_->spill_max_bytes(),
+                                        config_->spill_keep_on_restart());
+    } catch (const std::exception& e) {
+      LOG(error) << "Could not open spill log " << path.string()
+                 << ", spilling is disabled for stream " << stream_ << ": "
+                 << e.what();
+      return nullptr;
+    }
+  }
+
+  // Writes the record to the spill log instead of keeping it in memory if
+  // memory use is over the high-water mark. Once records are in the log, new
+  // ones go there too until it is empty, so they are still sent in order.
+  bool spill(const std::shared_ptr<UserRecord>& ur) {
+    if (!spill_log_ ||
+        (memory_budget_->used() < config_->spill_high_water_mark() &&
+         spill_log_->empty())) {
+      return false;
+    }
+
+    SpillLog::Entry e;
+    e.source_id = ur->source_id();
+    e.partition_key = ur->partition_key();
+    e.explicit_hash_key = ur->explicit_hash_key().value_or("");
+    e.data = ur->data();
+    e.deadline = to_system_time(ur->deadline());
+    e.expiration = to_system_time(ur->expiration());
+    {
+      aws::lock_guard<aws::mutex> lk(spill_mutex_);
+      if (!spill_log_->append(e)) {
+        return false;
+      }
+      spilled_flush_epochs_.push_back(ur->flush_epoch());
+    }
+    user_records_spilled_metric_->put(1);
+    arm_replay();
+    return true;
+  }
+
+  // Replay only runs while there's something in the log.
+  void arm_replay() {
+    if (scheduled_replay_->completed()) {
+      scheduled_replay_->reschedule(spill_replay_interval());
+    }
+  }
+
+  // Reads spilled records back while memory use is below the replay mark,
+  // and sends them on like newly put records.
+  void replay_spilled() {
+    auto replay_below =
+        config_->spill_high_water_mark() * kSpillReplayRatio;
+    SpillLog::Entry e;
+    uint64_t flush_epoch = 0;
+    for (size_t i = 0;
+         i < kSpillReplayBatchSize &&
+             memory_budget_->used() < replay_below &&
+             take_spilled(e, flush_epoch);
+         i++) {
+      auto ur = from_spill_entry(e);
+      if (ur->recovered()) {
+        outstanding_user_records_++;
+        ur->flush_epoch(flush_tracker_.accepted());
+      } else {
+        ur->flush_epoch(flush_epoch);
+      }
+      if (ur->expired()) {
+        // Finishing the record releases its bytes, so it is charged like any
+        // other even though it never goes further.
+        memory_budget_->acquire(MemoryBudget::bytes(*ur));
+        retrier_->fail(ur,
+                       "Expired",
+                       "Record " + std::to_string(ur->source_id()) +
+                           " has reached expiration in the spill log");
+      } else {
+        accept(ur);
+      }
+    }
+
+    bool empty;
+    {
+      aws::lock_guard<aws::mutex> lk(spill_mutex_);
+      empty = spill_log_->empty();
+    }
+    if (!empty) {
+      scheduled_replay_->reschedule(spill_replay_interval());
+    }
+  }
+
+  // Takes the oldest spilled record, and the flush epoch it was accepted in
+  // if it was spilled by this run.
+  bool take_spilled(SpillLog::Entry& e, uint64_t& flush_epoch) {
+    aws::lock_guard<aws::mutex> lk(spill_mutex_);
+    if (!spill_log_->take(e)) {
+      return false;
+    }
+    if (!e.recovered) {
+      flush_epoch = spilled_flush_epochs_.front();
+      spilled_flush_epochs_.pop_front();
+    }
+    return true;
+  }
+
+  std::shared_ptr<UserRecord> from_spill_entry(SpillLog::Entry& e) {
+    aws::kinesis::protobuf::Message m;
+    m.set_id(e.source_id);
+    auto pr = m.mutable_put_record();
+    pr->set_stream_name(stream_);
+    pr->set_partition_key(std::move(e.partition_key));
+    if (!e.explicit_hash_key.empty()) {
+      pr->set_explicit_hash_key(std::move(e.explicit_hash_key));
+    }
+    pr->set_data(std::move(e.data));
+    auto ur = std::make_shared<UserRecord>(m);
+    ur->set_expiration(from_system_time(e.expiration));
+    ur->set_deadline(from_system_time(e.deadline));
+    if (e.recovered) {
+      ur->set_recovered();
+    }
+    return ur;
+  }
+
+  // The log keeps wall clock times so they stay meaningful across restarts.
+  static SpillLog::Clock::time_point to_system_time(TimePoint tp) {
+    return SpillLog::Clock::now() +
+        std::chrono::duration_cast<SpillLog::Clock::duration>(
+            tp - std::chrono::steady_clock::now());
+  }
+
+  static TimePoint from_system_time(SpillLog::Clock::time_point tp) {
+    return std::chrono::steady_clock::now() +
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            tp - SpillLog::Clock::now());
+  }
+
+  // Admits the record into memory and starts aggregating it, or fails it if
+  // the memory budget doesn't allow it.
+  void accept(const std::shared_ptr<UserRecord>& ur) {
+    if (!admit(ur)) {
+      retrier_->fail(ur,
+                     "MemoryBudgetExceeded",
+                     "The producer's memory budget of " +
+                         std::to_string(memory_budget_->limit()) +
+                         " bytes is used up");
+      return;
+    }
+    aggregator_put(ur);
+  }
+
+  // Charges the record to the memory budget, applying the budget's policy if
+  // that takes it over. Returns false if the record has to be failed.
+  bool admit(const std::shared_ptr<UserRecord>& ur) {
+    if (memory_budget_->acquire(MemoryBudget::bytes(*ur))) {
+      return true;
+    }
+    if (memory_budget_->policy() != MemoryBudget::Policy::DropOldest) {
+      return false;
+    }
+    // Only records still waiting in the limiter can be dropped; the rest are
+    // already being sent. Failing them releases their bytes right away.
+    for (auto& kr : limiter_->shed(memory_budget_->excess())) {
+      retrier_->fail(kr,
+                     "MemoryBudgetExceeded",
+                     "Dropped to make room for newer records");
+    }
+    return memory_budget_->excess() == 0;
+  }
+
   void aggregator_put(const std::shared_ptr<UserRecord>& ur) {
+    if (direct_sender_) {
+      direct_put(ur);
+      return;
+    }
     auto kr = aggregator_->put(ur);
     if (kr) {
       limiter_put(kr);
@@ -160,12 +448,31 @@ class Pipeline : boost::noncopyable {
     limiter_->put(kr);
   }
 
+  // Sends the record in a KinesisRecord of its own. The shard is predicted
+  // only for the limiter; like records sent without aggregation, it isn't
+  // retried if it lands on another shard.
+  void direct_put(const std::shared_ptr<UserRecord>& ur) {
+    ur->reset_predicted_shard();
+    auto kr = std::make_shared<KinesisRecord>();
+    kr->add(ur);
+    auto shard_id = shard_map_->shard_id(ur->hash_key());
+    if (shard_id) {
+      limiter_->put(kr, *shard_id);
+    } else {
+      direct_sender_->put(kr);
+    }
+  }
+
   uint64_t putrecords_buffer_duration() const noexcept {
     return std::min(max_putrecords_buffer_time,
         (uint64_t)(config_->record_max_buffered_time() * putrecords_buffer_ratio));
   }
 
   void collector_put(const std::shared_ptr<KinesisRecord>& kr) {
+    if (direct_sender_) {
+      direct_sender_->put(kr);
+      return;
+    }
     if (config_->aggregation_enabled()) {
       kr->extend_deadline_from_now(std::chrono::milliseconds(putrecords_buffer_duration()));
     }
@@ -176,13 +483,43 @@ class Pipeline : boost::noncopyable {
   }
 
   void finish_user_record(const std::shared_ptr<UserRecord>& ur) {
+    // The callback may move strings out of the record.
+    auto bytes = MemoryBudget::bytes(*ur);
     finish_user_record_cb_(ur);
+    memory_budget_->release(bytes);
     outstanding_user_records_--;
+    flush_tracker_.finished(ur->flush_epoch());
   }
 
   void send_put_records_request(const std::shared_ptr<PutRecordsRequest>& prr) {
     auto prc = std::make_shared<PutRecordsContext>(stream_, stream_arn_, stream_id_, prr->items());
+    if (config_->parallel_serialization()) {
+      request_serializer_->serialize(prc->get_records(), [this, prc] {
+        this->send_put_records_context(prc);
+      });
+    } else {
+      send_put_records_context(prc);
+    }
+  }
+
+  void send_put_records_context(const std::shared_ptr<PutRecordsContext>& prc) {
     prc->set_start(std::chrono::steady_clock::now());
+    if (transport_) {
+      transport_->send(prc, [this](auto& ctx) {
+        this->put_records_completed(ctx);
+      });
+      return;
+    }
+    if (config_->direct_request_encoding()) {
+      // This is what PutRecordsAsync does, except that it would copy the
+      // request as a plain PutRecordsRequest.
+      sdk_executor_->Submit([this, prc] {
+        prc->set_outcome(
+            this->kinesis_client_->PutRecords(prc->to_encoded_sdk_request()));
+        this->put_records_completed(prc);
+      });
+      return;
+    }
     kinesis_client_->PutRecordsAsync(
         prc->to_sdk_request(),
         [this](auto /*client*/,
@@ -192,32 +529,63 @@ class Pipeline : boost::noncopyable {
           auto ctx = std::dynamic_pointer_cast<PutRecordsContext>(
               std::const_pointer_cast<Aws::Client::AsyncCallerContext>(
                   sdk_ctx));
-          ctx->set_end(std::chrono::steady_clock::now());
           ctx->set_outcome(outcome);
-          this->request_completed(ctx);
-          // At the time of writing, the SDK can spawn a large number of
-          // threads in order to achieve request parallelism. These threads will
-          // later put items into the IPC manager after they finish the logic in
-          // the retrier. This can overwhelm the queue in the IPC manager, which
-          // is guarded by a no-backoff spin lock and never intended for
-          // use under high contention. To workaround this, we sumbit a task
-          // into the pipeline's executor instead. This limits the contention on
-          // the IPC manager's queue to the size of the executor's thread pool.
-          this->executor_->submit([=] { this->retrier_->put(ctx); });
+          this->put_records_completed(ctx);
         },
         prc);
   }
 
+  void put_records_completed(const std::shared_ptr<PutRecordsContext>& ctx) {
+    ctx->set_end(std::chrono::steady_clock::now());
+    request_completed(ctx);
+    auto shards = collector_->shards(ctx->get_records());
+    // With the elastic thread pool, requests are finished right here, saving
+    // the hop through the executor, but only as many at once across all
+    // pipelines as the producer's executor has threads. The pool itself can
+    // have up to thread_pool_size threads completing requests, so the rest
+    // take the hop below.
+    if (config_->use_elastic_thread_pool()) {
+      if (inline_completions_++ < max_inline_completions_) {
+        retry_and_release(ctx, shards);
+        inline_completions_--;
+        return;
+      }
+      inline_completions_--;
+    }
+    // At the time of writing, the SDK can spawn a large number of
+    // threads in order to achieve request parallelism. These threads will
+    // later put items into the IPC manager after they finish the logic in
+    // the retrier. This can overwhelm the queue in the IPC manager, which
+    // is guarded by a no-backoff spin lock and never intended for
+    // use under high contention. To workaround this, we sumbit a task
+    // into the pipeline's executor instead. This limits the contention on
+    // the IPC manager's queue to the size of the executor's thread pool.
+    executor_->submit([=] { this->retry_and_release(ctx, shards); },
+                      aws::utils::Priority::High);
+  }
+
+  // The request's in-flight slots are given up only after the retrier has
+  // requeued its failed records, so records that were waiting for those
+  // slots don't get ahead of them.
+  void retry_and_release(const std::shared_ptr<PutRecordsContext>& ctx,
+                         const std::vector<uint64_t>& shards) {
+    retrier_->put(ctx);
+    if (direct_sender_) {
+      direct_sender_->request_completed();
+    } else {
+      collector_->request_completed(shards);
+    }
+  }
+
   void request_completed(std::shared_ptr<PutRecordsContext> context) {
     stats_logger_.request_complete(context);
   }
 
-  void retrier_put_kr(const std::shared_ptr<KinesisRecord>& kr) {
+  void retrier_put_kr(const std::shared_ptr<KinesisRecord>& kr,
+                      const char* message) {
     executor_->submit([=] {
-      retrier_->put(kr,
-                    "Expired",
-                    "Expiration reached while waiting in limiter");
-    });
+      retrier_->put(kr, "Expired", message);
+    }, aws::utils::Priority::High);
   }
 
   std::string region_;
@@ -226,22 +594,45 @@ class Pipeline : boost::noncopyable {
   std::string stream_id_;
   StreamIdGetter stream_id_getter_;
   std::shared_ptr<Configuration> config_;
-  aws::utils::processing_statistics_logger stats_logger_;
   std::shared_ptr<aws::utils::Executor> executor_;
+  aws::utils::processing_statistics_logger stats_logger_;
   std::shared_ptr<Aws::Kinesis::KinesisClient> kinesis_client_;
+  std::shared_ptr<Aws::Utils::Threading::Executor> sdk_executor_;
+  std::shared_ptr<PutRecordsTransport> transport_;
+  std::shared_ptr<RequestSerializer> request_serializer_;
   std::shared_ptr<aws::metrics::MetricsManager> metrics_manager_;
+  std::shared_ptr<MemoryBudget> memory_budget_;
+  // Shared by the producer's pipelines.
+  std::atomic<size_t>& inline_completions_;
+  size_t max_inline_completions_;
   Retrier::UserRecordCallback finish_user_record_cb_;
 
   std::shared_ptr<ShardMap> shard_map_;
   std::shared_ptr<Aggregator> aggregator_;
   std::shared_ptr<Limiter> limiter_;
   std::shared_ptr<Collector> collector_;
+  std::shared_ptr<DirectSender> direct_sender_;
   std::shared_ptr<Retrier> retrier_;
 
   std::shared_ptr<aws::metrics::Metric> user_records_rcvd_metric_;
+  std::shared_ptr<aws::metrics::Metric> user_records_spilled_metric_;
+  std::shared_ptr<SpillLog> spill_log_;
+  std::shared_ptr<aws::utils::ScheduledCallback> scheduled_replay_;
+  // Appending and taking spilled records is done under this lock, so that
+  // the epochs are kept in the same order as the records in the log.
+  aws::mutex spill_mutex_;
+  std::deque<uint64_t> spilled_flush_epochs_;
   std::atomic<uint64_t> outstanding_user_records_;
+  FlushTracker flush_tracker_;
   const float putrecords_buffer_ratio = 0.2;
   const uint64_t max_putrecords_buffer_time = 50;
+  static constexpr const double kSpillReplayRatio = 0.9;
+  static constexpr const size_t kSpillReplayBatchSize = 1000;
+
+  // Not a static constant, which the duration constructor would odr-use.
+  static std::chrono::milliseconds spill_replay_interval() {
+    return std::chrono::milliseconds(50);
+  }
 
 
 };
@@ -17,8 +17,11 @@
 #define AWS_KINESIS_CORE_PUT_RECORDS_CONTEXT_H_
 
 #include <memory>
+#include <string>
 #include <vector>
 
+#include <boost/optional.hpp>
+
 #include <aws/core/client/AsyncCallerContext.h>
 #include <aws/core/utils/Outcome.h>
 #include <aws/kinesis/KinesisClient.h>
@@ -26,11 +29,35 @@
 #include <aws/kinesis/model/PutRecordsRequestEntry.h>
 #include <aws/kinesis/model/PutRecordsResult.h>
 #include <aws/kinesis/core/kinesis_record.h>
+#include <aws/kinesis/core/put_records_encoder.h>
 
 namespace aws {
 namespace kinesis {
 namespace core {
 
+// A PutRecordsRequest whose records are written into the body straight from
+// the KinesisRecords by encode_put_records. The SDK still serializes the other
+// members, and signs and sends the request as usual.
+//
+// The SDK's async calls keep a copy of the request as a plain
+// PutRecordsRequest, which loses the override, so this has to be sent with
+// the blocking call.
+class EncodedPutRecordsRequest : public Aws::Kinesis::Model::PutRecordsRequest {
+ public:
+  explicit EncodedPutRecordsRequest(
+      std::vector<std::shared_ptr<KinesisRecord>> records)
+      : records_(std::move(records)) {}
+
+  Aws::String SerializePayload() const override {
+    return encode_put_records(
+        records_,
+        Aws::Kinesis::Model::PutRecordsRequest::SerializePayload());
+  }
+
+ private:
+  std::vector<std::shared_ptr<KinesisRecord>> records_;
+};
+
 class PutRecordsContext : public Aws::Client::AsyncCallerContext {
  public:
   PutRecordsContext(std::string stream,
@@ -93,6 +120,14 @@ class PutRecordsContext : public Aws::Client::AsyncCallerContext {
     return req;
   }
 
+  EncodedPutRecordsRequest to_encoded_sdk_request() const {
+    EncodedPutRecordsRequest req(records_);
+    req.SetStreamName(stream_);
+    if (!stream_arn_.empty()) req.SetStreamARN(stream_arn_);
+    if (!stream_id_.empty()) req.SetStreamId(stream_id_);
+    return req;
+  }
+
   PutRecordsContext& set_start(std::chrono::steady_clock::time_point t) {
     start_ = t;
     return *this;
@@ -108,6 +143,19 @@ class PutRecordsContext : public Aws::Client::AsyncCallerContext {
     return *this;
   }
 
+  // For transports that have the raw body of a successful response. The
+  // retrier then reads the results from it instead of from the outcome.
+  PutRecordsContext& set_response_body(std::string body) {
+    outcome_ = Aws::Kinesis::Model::PutRecordsOutcome(
+        Aws::Kinesis::Model::PutRecordsResult());
+    response_body_ = std::move(body);
+    return *this;
+  }
+
+  const boost::optional<std::string>& get_response_body() const {
+    return response_body_;
+  }
+
  private:
   std::string stream_;
   std::string stream_arn_;
@@ -116,6 +164,7 @@ class PutRecordsContext : public Aws::Client::AsyncCallerContext {
   std::chrono::steady_clock::time_point end_;
   std::vector<std::shared_ptr<KinesisRecord>> records_;
   Aws::Kinesis::Model::PutRecordsOutcome outcome_;
+  boost::optional<std::string> response_body_;
 };
 
 } //namespace core
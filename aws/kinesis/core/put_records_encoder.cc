@@ -0,0 +1,101 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <aws/kinesis/core/put_records_encoder.h>
+
+#include <stdexcept>
+
+#include <aws/utils/base64.h>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+namespace {
+
+// Room for the member names and punctuation of one entry.
+const size_t kEntryOverhead = 64;
+
+void append_json_string(const std::string& s, std::string& out) {
+  static const char kHex[] = "0123456789abcdef";
+  out += '"';
+  for (unsigned char c : s) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += (char) c;
+    } else if (c < 0x20) {
+      out += "\\u00";
+      out += kHex[c >> 4];
+      out += kHex[c & 0xF];
+    } else {
+      out += (char) c;
+    }
+  }
+  out += '"';
+}
+
+} //namespace
+
+std::string encode_put_records(
+    const std::vector<std::shared_ptr<KinesisRecord>>& records,
+    const std::string& payload) {
+  auto open = payload.find('{');
+  if (open == std::string::npos) {
+    throw std::runtime_error("PutRecords payload is not a JSON object");
+  }
+
+  size_t size = payload.size() + 16;
+  for (auto& kr : records) {
+    size += aws::utils::base64_encoded_size(kr->accurate_size()) +
+        kEntryOverhead;
+  }
+  std::string out;
+  out.reserve(size);
+
+  out.append(payload, 0, open + 1);
+  out += "\"Records\":[";
+  for (size_t i = 0; i < records.size(); i++) {
+    auto& kr = records[i];
+    if (i > 0) {
+      out += ',';
+    }
+    out += "{\"Data\":\"";
+    // A record on its own is sent as is, so there's no need to copy it out.
+    if (kr->size() == 1) {
+      auto& data = kr->items().front()->data();
+      aws::utils::base64_encode(data.data(), data.size(), out);
+    } else {
+      auto data = kr->serialize();
+      aws::utils::base64_encode(data.data(), data.size(), out);
+    }
+    out += "\",\"PartitionKey\":";
+    append_json_string(kr->partition_key(), out);
+    out += ",\"ExplicitHashKey\":";
+    append_json_string(kr->explicit_hash_key(), out);
+    out += '}';
+  }
+  out += ']';
+
+  auto rest = payload.find_first_not_of(" \t\r\n", open + 1);
+  if (rest != std::string::npos && payload[rest] != '}') {
+    out += ',';
+  }
+  out.append(payload, open + 1, std::string::npos);
+  return out;
+}
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
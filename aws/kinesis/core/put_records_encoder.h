@@ -0,0 +1,44 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_KINESIS_CORE_PUT_RECORDS_ENCODER_H_
+#define AWS_KINESIS_CORE_PUT_RECORDS_ENCODER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <aws/kinesis/core/kinesis_record.h>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+// Writes the JSON body of a PutRecords request straight from the records,
+// without first copying each into the SDK's request model and from there
+// into the SDK's JSON document.
+//
+// payload is the body the SDK serializes for the request's other members: a
+// JSON object without "Records". The records are added as its first member.
+// Throws std::runtime_error if payload is not an object.
+std::string encode_put_records(
+    const std::vector<std::shared_ptr<KinesisRecord>>& records,
+    const std::string& payload);
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
+
+#endif //AWS_KINESIS_CORE_PUT_RECORDS_ENCODER_H_
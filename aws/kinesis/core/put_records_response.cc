@@ -0,0 +1,287 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <aws/kinesis/core/put_records_response.h>
+
+#include <cctype>
+#include <stdexcept>
+
+#include <aws/kinesis/core/shard_map.h>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+namespace {
+
+// Deeper than any PutRecords response; only there to bound the recursion
+// on garbage.
+const int kMaxDepth = 64;
+
+class Reader {
+ public:
+  explicit Reader(boost::string_ref body)
+      : p_(body.data()),
+        end_(body.data() + body.size()) {}
+
+  void parse(const PutRecordsResponseCallback& callback) {
+    expect('{');
+    if (!consume('}')) {
+      do {
+        bool escaped;
+        auto name = string(escaped);
+        expect(':');
+        if (name == "Records") {
+          records(callback);
+        } else {
+          skip_value(0);
+        }
+      } while (consume(','));
+      expect('}');
+    }
+    skip_whitespace();
+    if (p_ != end_) {
+      fail("trailing data");
+    }
+  }
+
+ private:
+  void records(const PutRecordsResponseCallback& callback) {
+    expect('[');
+    if (consume(']')) {
+      return;
+    }
+    do {
+      PutRecordsResponseEntry entry;
+      expect('{');
+      if (!consume('}')) {
+        do {
+          bool escaped;
+          auto name = string(escaped);
+          expect(':');
+          boost::string_ref* field = nullptr;
+          if (name == "ShardId") {
+            field = &entry.shard_id;
+          } else if (name == "SequenceNumber") {
+            field = &entry.sequence_number;
+          } else if (name == "ErrorCode") {
+            field = &entry.error_code;
+          } else if (name == "ErrorMessage") {
+            field = &entry.error_message;
+          }
+          if (field && peek() == '"') {
+            *field = string(escaped);
+            entry.escaped |= escaped;
+          } else {
+            skip_value(0);
+          }
+        } while (consume(','));
+        expect('}');
+      }
+      if (entry.success()) {
+        entry.shard_number = ShardMap::shard_id_from_str(entry.shard_id);
+      }
+      callback(entry);
+    } while (consume(','));
+    expect(']');
+  }
+
+  // Returns the contents of the string at p_ as they appear in the body.
+  boost::string_ref string(bool& escaped) {
+    expect('"');
+    auto start = p_;
+    escaped = false;
+    while (p_ != end_ && *p_ != '"') {
+      if (*p_ == '\\') {
+        escaped = true;
+        if (++p_ == end_) {
+          break;
+        }
+      }
+      p_++;
+    }
+    if (p_ == end_) {
+      fail("unterminated string");
+    }
+    return boost::string_ref(start, p_++ - start);
+  }
+
+  void skip_value(int depth) {
+    if (depth > kMaxDepth) {
+      fail("too deeply nested");
+    }
+    char c = peek();
+    if (c == '"') {
+      bool escaped;
+      string(escaped);
+    } else if (c == '{') {
+      p_++;
+      if (!consume('}')) {
+        do {
+          bool escaped;
+          string(escaped);
+          expect(':');
+          skip_value(depth + 1);
+        } while (consume(','));
+        expect('}');
+      }
+    } else if (c == '[') {
+      p_++;
+      if (!consume(']')) {
+        do {
+          skip_value(depth + 1);
+        } while (consume(','));
+        expect(']');
+      }
+    } else {
+      // Numbers, true, false and null.
+      auto start = p_;
+      while (p_ != end_ && (std::isalnum((unsigned char) *p_) ||
+                            *p_ == '-' || *p_ == '+' || *p_ == '.')) {
+        p_++;
+      }
+      if (p_ == start) {
+        fail("expected a value");
+      }
+    }
+  }
+
+  void skip_whitespace() {
+    while (p_ != end_ &&
+           (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) {
+      p_++;
+    }
+  }
+
+  char peek() {
+    skip_whitespace();
+    return p_ == end_ ? 0 : *p_;
+  }
+
+  bool consume(char c) {
+    if (peek() == c) {
+      p_++;
+      return true;
+    }
+    return false;
+  }
+
+  void expect(char c) {
+    if (!consume(c)) {
+      fail(std::string("expected '") + c + "'");
+    }
+  }
+
+  [[noreturn]] void fail(const std::string& what) {
+    throw std::runtime_error("Malformed PutRecords response: " + what);
+  }
+
+  const char* p_;
+  const char* end_;
+};
+
+void append_utf8(uint32_t cp, std::string& out) {
+  if (cp < 0x80) {
+    out += (char) cp;
+  } else if (cp < 0x800) {
+    out += (char) (0xC0 | (cp >> 6));
+    out += (char) (0x80 | (cp & 0x3F));
+  } else if (cp < 0x10000) {
+    out += (char) (0xE0 | (cp >> 12));
+    out += (char) (0x80 | ((cp >> 6) & 0x3F));
+    out += (char) (0x80 | (cp & 0x3F));
+  } else {
+    out += (char) (0xF0 | (cp >> 18));
+    out += (char) (0x80 | ((cp >> 12) & 0x3F));
+    out += (char) (0x80 | ((cp >> 6) & 0x3F));
+    out += (char) (0x80 | (cp & 0x3F));
+  }
+}
+
+// Reads the 4 hex digits of a \u escape at s[i], or returns -1.
+int32_t hex4(boost::string_ref s, size_t i) {
+  if (i + 4 > s.size()) {
+    return -1;
+  }
+  int32_t v = 0;
+  for (size_t j = i; j < i + 4; j++) {
+    char c = s[j];
+    v <<= 4;
+    if (c >= '0' && c <= '9') {
+      v |= c - '0';
+    } else if (c >= 'a' && c <= 'f') {
+      v |= c - 'a' + 10;
+    } else if (c >= 'A' && c <= 'F') {
+      v |= c - 'A' + 10;
+    } else {
+      return -1;
+    }
+  }
+  return v;
+}
+
+} //namespace
+
+std::string PutRecordsResponseEntry::text(boost::string_ref s) const {
+  if (!escaped || s.find('\\') == boost::string_ref::npos) {
+    return s.to_string();
+  }
+
+  std::string out;
+  out.reserve(s.size());
+  for (size_t i = 0; i < s.size(); i++) {
+    if (s[i] != '\\' || i + 1 == s.size()) {
+      out += s[i];
+      continue;
+    }
+    char c = s[++i];
+    switch (c) {
+      case 'b': out += '\b'; break;
+      case 'f': out += '\f'; break;
+      case 'n': out += '\n'; break;
+      case 'r': out += '\r'; break;
+      case 't': out += '\t'; break;
+      case 'u': {
+        int32_t cp = hex4(s, i + 1);
+        if (cp < 0) {
+          out += "\\u";
+          break;
+        }
+        i += 4;
+        if (cp >= 0xD800 && cp < 0xDC00 && i + 2 < s.size() &&
+            s[i + 1] == '\\' && s[i + 2] == 'u') {
+          int32_t low = hex4(s, i + 3);
+          if (low >= 0xDC00 && low < 0xE000) {
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+            i += 6;
+          }
+        }
+        append_utf8(cp, out);
+        break;
+      }
+      default: out += c;
+    }
+  }
+  return out;
+}
+
+void parse_put_records_response(boost::string_ref body,
+                                const PutRecordsResponseCallback& callback) {
+  Reader(body).parse(callback);
+}
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
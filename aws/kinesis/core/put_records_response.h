@@ -0,0 +1,65 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_KINESIS_CORE_PUT_RECORDS_RESPONSE_H_
+#define AWS_KINESIS_CORE_PUT_RECORDS_RESPONSE_H_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include <boost/utility/string_ref.hpp>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+// The result for one record of a PutRecords call. The strings point into the
+// response it was read from, so an entry is only good while that lives.
+struct PutRecordsResponseEntry {
+  boost::string_ref shard_id;
+  uint64_t shard_number = 0;
+  boost::string_ref sequence_number;
+  boost::string_ref error_code;
+  boost::string_ref error_message;
+
+  // Whether the strings are JSON text that may still contain escapes. Shard
+  // ids and sequence numbers never need escaping, so only the error strings
+  // have to go through text().
+  bool escaped = false;
+
+  bool success() const {
+    return !sequence_number.empty();
+  }
+
+  std::string text(boost::string_ref s) const;
+};
+
+using PutRecordsResponseCallback =
+    std::function<void (const PutRecordsResponseEntry&)>;
+
+// Reads the JSON body of a PutRecords response in a single pass, calling
+// callback for each entry of "Records" in order, without building a
+// document or copying any strings. Other members are skipped.
+//
+// Throws std::runtime_error if the body is malformed.
+void parse_put_records_response(boost::string_ref body,
+                                const PutRecordsResponseCallback& callback);
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
+
+#endif //AWS_KINESIS_CORE_PUT_RECORDS_RESPONSE_H_
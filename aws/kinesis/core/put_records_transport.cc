@@ -0,0 +1,644 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <aws/kinesis/core/put_records_transport.h>
+
+#include <array>
+#include <limits>
+#include <stdexcept>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/asio/buffers_iterator.hpp>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/ssl/stream.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/version.hpp>
+
+#if BOOST_VERSION >= 107300
+#include <boost/asio/ssl/host_name_verification.hpp>
+#else
+#include <boost/asio/ssl/rfc2818_verification.hpp>
+#endif
+
+#include <aws/kinesis/core/put_records_encoder.h>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+namespace {
+
+const char kContentType[] = "application/x-amz-json-1.1";
+const char kTarget[] = "Kinesis_20131202.PutRecords";
+
+// Content length of a response that ends when the server closes the
+// connection.
+const size_t kUntilClose = std::numeric_limits<size_t>::max();
+
+// Returns the string value of the member name of a JSON object, or an empty
+// string. Only meant for the flat objects errors are reported in.
+std::string json_string(const std::string& json, const std::string& name) {
+  auto pos = json.find("\"" + name + "\"");
+  if (pos == std::string::npos) {
+    return "";
+  }
+  pos = json.find_first_not_of(" \t\r\n", pos + name.size() + 2);
+  if (pos == std::string::npos || json[pos] != ':') {
+    return "";
+  }
+  pos = json.find_first_not_of(" \t\r\n", pos + 1);
+  if (pos == std::string::npos || json[pos] != '"') {
+    return "";
+  }
+  std::string value;
+  for (pos++; pos < json.size() && json[pos] != '"'; pos++) {
+    if (json[pos] == '\\' && pos + 1 < json.size()) {
+      pos++;
+    }
+    value += json[pos];
+  }
+  return value;
+}
+
+Aws::Kinesis::Model::PutRecordsOutcome error_outcome(
+    const std::string& name,
+    const std::string& message,
+    bool retryable,
+    Aws::Kinesis::KinesisErrors type = Aws::Kinesis::KinesisErrors::UNKNOWN) {
+  return Aws::Kinesis::Model::PutRecordsOutcome(
+      Aws::Client::AWSError<Aws::Kinesis::KinesisErrors>(
+          type,
+          name,
+          message,
+          retryable));
+}
+
+// Error responses carry the error type and message in a JSON body, e.g.
+// {"__type":"ResourceNotFoundException","message":"..."}; the type may be
+// qualified with a namespace ending in '#'.
+Aws::Kinesis::Model::PutRecordsOutcome error_outcome(int status,
+                                                     const std::string& body) {
+  auto type = json_string(body, "__type");
+  auto hash = type.find('#');
+  if (hash != std::string::npos) {
+    type = type.substr(hash + 1);
+  }
+  auto message = json_string(body, "message");
+  if (message.empty()) {
+    message = json_string(body, "Message");
+  }
+  if (type.empty()) {
+    type = "HttpError";
+    message = "HTTP status " + std::to_string(status) + ": " + body;
+  }
+  return error_outcome(type, message, status >= 500);
+}
+
+} //namespace
+
+struct PutRecordsTransport::Connection {
+  using Socket = boost::asio::ip::tcp::socket;
+  using TlsStream = boost::asio::ssl::stream<Socket>;
+
+  Connection(boost::asio::io_context& io_context,
+             boost::asio::ssl::context* ssl_context,
+             const std::string& host)
+      : strand(boost::asio::make_strand(io_context)),
+        resolver(strand),
+        timer(strand) {
+    if (!ssl_context) {
+      plain.reset(new Socket(strand));
+      return;
+    }
+    tls.reset(new TlsStream(strand, *ssl_context));
+    if (SSL_CTX_get_verify_mode(ssl_context->native_handle()) &
+        SSL_VERIFY_PEER) {
+#if BOOST_VERSION >= 107300
+      tls->set_verify_callback(boost::asio::ssl::host_name_verification(host));
+#else
+      tls->set_verify_callback(boost::asio::ssl::rfc2818_verification(host));
+#endif
+    }
+  }
+
+  Socket& socket() {
+    return tls ? tls->next_layer() : *plain;
+  }
+
+  template <typename F>
+  void with_stream(F&& f) {
+    if (tls) {
+      f(*tls);
+    } else {
+      f(*plain);
+    }
+  }
+
+  void close() {
+    boost::system::error_code ignored;
+    resolver.cancel();
+    socket().close(ignored);
+  }
+
+  // All handlers run on the strand, including the timer's.
+  boost::asio::strand<boost::asio::io_context::executor_type> strand;
+  boost::asio::ip::tcp::resolver resolver;
+  boost::asio::steady_timer timer;
+  std::unique_ptr<TlsStream> tls;
+  std::unique_ptr<Socket> plain;
+  boost::asio::streambuf buffer;
+  bool connected = false;
+  // Requests completed on this connection.
+  size_t served = 0;
+  // Tells the timer whether it's still timing the step it was armed for.
+  uint64_t generation = 0;
+  bool timed_out = false;
+};
+
+struct PutRecordsTransport::Exchange {
+  std::shared_ptr<PutRecordsContext> prc;
+  Callback done;
+  std::string head;
+  std::string body;
+  bool responded = false;
+  bool retried = false;
+};
+
+PutRecordsTransport::PutRecordsTransport(
+    std::shared_ptr<aws::utils::Executor> executor,
+    std::string host,
+    uint16_t port,
+    std::shared_ptr<boost::asio::ssl::context> ssl_context,
+    std::string region,
+    CredentialsGetter credentials,
+    std::string user_agent,
+    size_t max_connections,
+    std::chrono::milliseconds connect_timeout,
+    std::chrono::milliseconds request_timeout)
+    : executor_(std::move(executor)),
+      host_(std::move(host)),
+      port_(std::to_string(port)),
+      ssl_context_(std::move(ssl_context)),
+      credentials_(std::move(credentials)),
+      max_connections_(std::max<size_t>(max_connections, 1)),
+      connect_timeout_(connect_timeout),
+      request_timeout_(request_timeout),
+      signer_(std::move(region), "kinesis"),
+      connections_(0) {
+  if (!executor_.lock()->io_reactor()) {
+    throw std::runtime_error(
+        "PutRecordsTransport needs an executor with an io_context");
+  }
+  host_header_ = host_;
+  if (port != (ssl_context_ ? 443 : 80)) {
+    host_header_ += ":" + port_;
+  }
+  head_template_ =
+      "POST / HTTP/1.1\r\n"
+      "Host: " + host_header_ + "\r\n"
+      "Content-Type: " + kContentType + "\r\n"
+      "X-Amz-Target: " + kTarget + "\r\n"
+      "User-Agent: " + user_agent + "\r\n"
+      "Connection: keep-alive\r\n";
+}
+
+void PutRecordsTransport::send(const std::shared_ptr<PutRecordsContext>& prc,
+                               Callback done) {
+  std::string payload = "{\"StreamName\":\"" + prc->get_stream() + "\"";
+  if (!prc->get_stream_arn().empty()) {
+    payload += ",\"StreamARN\":\"" + prc->get_stream_arn() + "\"";
+  }
+  if (!prc->get_stream_id().empty()) {
+    payload += ",\"StreamId\":\"" + prc->get_stream_id() + "\"";
+  }
+  payload += "}";
+
+  auto ex = std::make_shared<Exchange>();
+  ex->prc = prc;
+  ex->done = std::move(done);
+  ex->body = encode_put_records(prc->get_records(), payload);
+  ex->head = request_head(*prc, ex->body);
+  dispatch(ex);
+}
+
+size_t PutRecordsTransport::connections() {
+  aws::lock_guard<aws::utils::SpinLock> lk(mutex_);
+  return connections_;
+}
+
+std::shared_ptr<boost::asio::ssl::context>
+PutRecordsTransport::make_ssl_context(bool verify_certificate,
+                                      const std::string& ca_path,
+                                      const std::string& ca_file) {
+  using boost::asio::ssl::context;
+  auto ctx = std::make_shared<context>(context::tls_client);
+  ctx->set_options(context::default_workarounds |
+                   context::no_sslv2 |
+                   context::no_sslv3 |
+                   context::no_tlsv1 |
+                   context::no_tlsv1_1);
+  if (verify_certificate) {
+    ctx->set_default_verify_paths();
+    if (!ca_path.empty()) {
+      ctx->add_verify_path(ca_path);
+    }
+    if (!ca_file.empty()) {
+      ctx->load_verify_file(ca_file);
+    }
+    ctx->set_verify_mode(boost::asio::ssl::verify_peer);
+  } else {
+    ctx->set_verify_mode(boost::asio::ssl::verify_none);
+  }
+  return ctx;
+}
+
+void PutRecordsTransport::dispatch(const ExchangePtr& ex) {
+  ConnectionPtr conn;
+  {
+    aws::lock_guard<aws::utils::SpinLock> lk(mutex_);
+    if (!idle_.empty()) {
+      // The most recently used connection is the least likely to have been
+      // closed by the server in the meantime.
+      conn = std::move(idle_.back());
+      idle_.pop_back();
+    } else if (connections_ < max_connections_) {
+      connections_++;
+    } else {
+      waiting_.push_back(ex);
+      return;
+    }
+  }
+  if (!conn && !(conn = new_connection())) {
+    fail_shutdown(ex);
+    return;
+  }
+  start(conn, ex);
+}
+
+void PutRecordsTransport::start(const ConnectionPtr& conn,
+                                const ExchangePtr& ex) {
+  boost::asio::post(conn->strand,
+                    [this, self = shared_from_this(), conn, ex] {
+    if (conn->connected) {
+      this->write(conn, ex);
+    } else {
+      this->connect(conn, ex);
+    }
+  });
+}
+
+void PutRecordsTransport::connect(const ConnectionPtr& conn,
+                                  const ExchangePtr& ex) {
+  arm_timer(conn, connect_timeout_);
+  conn->resolver.async_resolve(
+      host_,
+      port_,
+      [this, self = shared_from_this(), conn, ex](auto& ec, auto results) {
+    if (ec) {
+      this->fail(conn, ex, "Could not resolve " + host_ + ": " + ec.message());
+      return;
+    }
+    boost::asio::async_connect(
+        conn->socket(),
+        results,
+        [this, self, conn, ex](auto& ec, auto& /*endpoint*/) {
+      if (ec) {
+        this->fail(conn,
+                   ex,
+                   "Could not connect to " + host_ + ": " + ec.message());
+        return;
+      }
+      boost::system::error_code ignored;
+      conn->socket().set_option(boost::asio::ip::tcp::no_delay(true), ignored);
+      if (!conn->tls) {
+        conn->connected = true;
+        this->write(conn, ex);
+        return;
+      }
+      SSL_set_tlsext_host_name(conn->tls->native_handle(), host_.c_str());
+      conn->tls->async_handshake(
+          boost::asio::ssl::stream_base::client,
+          [this, self, conn, ex](auto& ec) {
+        if (ec) {
+          this->fail(conn, ex, "TLS handshake failed: " + ec.message());
+          return;
+        }
+        conn->connected = true;
+        this->write(conn, ex);
+      });
+    });
+  });
+}
+
+void PutRecordsTransport::write(const ConnectionPtr& conn,
+                                const ExchangePtr& ex) {
+  arm_timer(conn, request_timeout_);
+  std::array<boost::asio::const_buffer, 2> buffers = {{
+    boost::asio::buffer(ex->head),
+    boost::asio::buffer(ex->body)
+  }};
+  conn->with_stream([&](auto& stream) {
+    boost::asio::async_write(
+        stream,
+        buffers,
+        [this, self = this->shared_from_this(), conn, ex](auto& ec, size_t) {
+      if (ec) {
+        this->fail(conn, ex, "Failed to send request: " + ec.message());
+        return;
+      }
+      this->read_headers(conn, ex);
+    });
+  });
+}
+
+void PutRecordsTransport::read_headers(const ConnectionPtr& conn,
+                                       const ExchangePtr& ex) {
+  conn->with_stream([&](auto& stream) {
+    boost::asio::async_read_until(
+        stream,
+        conn->buffer,
+        "\r\n\r\n",
+        [this, self = this->shared_from_this(), conn, ex](auto& ec, size_t n) {
+      if (ec) {
+        this->fail(conn, ex, "Failed to read response: " + ec.message());
+        return;
+      }
+      ex->responded = true;
+
+      auto begin = boost::asio::buffers_begin(conn->buffer.data());
+      std::string head(begin, begin + n);
+      conn->buffer.consume(n);
+
+      int status = 0;
+      size_t content_length = kUntilClose;
+      bool keep_alive = boost::starts_with(head, "HTTP/1.1");
+      bool chunked = false;
+      size_t pos = 0;
+      for (bool first = true; ; first = false) {
+        auto end = head.find("\r\n", pos);
+        if (end == std::string::npos || end == pos) {
+          break;
+        }
+        auto line = head.substr(pos, end - pos);
+        pos = end + 2;
+        if (first) {
+          auto space = line.find(' ');
+          if (!boost::starts_with(line, "HTTP/") ||
+              space == std::string::npos) {
+            break;
+          }
+          status = std::atoi(line.c_str() + space + 1);
+          continue;
+        }
+        auto colon = line.find(':');
+        if (colon == std::string::npos) {
+          continue;
+        }
+        auto name = boost::trim_copy(line.substr(0, colon));
+        auto value = boost::trim_copy(line.substr(colon + 1));
+        if (boost::iequals(name, "Content-Length")) {
+          content_length = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (boost::iequals(name, "Connection")) {
+          keep_alive = !boost::iequals(value, "close");
+        } else if (boost::iequals(name, "Transfer-Encoding")) {
+          chunked = !boost::iequals(value, "identity");
+        }
+      }
+
+      if (status < 100 || chunked) {
+        this->fail(conn, ex, chunked
+            ? "Chunked responses are not supported"
+            : "Malformed response");
+        return;
+      }
+      if (status == 204 || status == 304 || status < 200) {
+        content_length = 0;
+      }
+      this->read_body(conn, ex, status, content_length, keep_alive);
+    });
+  });
+}
+
+void PutRecordsTransport::read_body(const ConnectionPtr& conn,
+                                    const ExchangePtr& ex,
+                                    int status,
+                                    size_t content_length,
+                                    bool keep_alive) {
+  auto done_reading =
+      [this, self = shared_from_this(), conn, ex, status, content_length,
+       keep_alive](const boost::system::error_code& ec, size_t) {
+    if (ec && !(content_length == kUntilClose &&
+                (ec == boost::asio::error::eof ||
+                 ec == boost::asio::ssl::error::stream_truncated))) {
+      this->fail(conn, ex, "Failed to read response: " + ec.message());
+      return;
+    }
+    auto len = std::min(conn->buffer.size(), content_length);
+    auto begin = boost::asio::buffers_begin(conn->buffer.data());
+    std::string body(begin, begin + len);
+    conn->buffer.consume(len);
+    this->complete(conn,
+                   ex,
+                   status,
+                   std::move(body),
+                   keep_alive && content_length != kUntilClose);
+  };
+
+  auto have = conn->buffer.size();
+  if (content_length != kUntilClose && have >= content_length) {
+    done_reading(boost::system::error_code(), 0);
+    return;
+  }
+  conn->with_stream([&](auto& stream) {
+    if (content_length == kUntilClose) {
+      boost::asio::async_read(stream,
+                              conn->buffer,
+                              boost::asio::transfer_all(),
+                              done_reading);
+    } else {
+      boost::asio::async_read(
+          stream,
+          conn->buffer,
+          boost::asio::transfer_exactly(content_length - have),
+          done_reading);
+    }
+  });
+}
+
+void PutRecordsTransport::arm_timer(const ConnectionPtr& conn,
+                                    std::chrono::milliseconds timeout) {
+  auto generation = ++conn->generation;
+  conn->timed_out = false;
+  conn->timer.expires_after(timeout);
+  conn->timer.async_wait([conn, generation](auto& ec) {
+    if (ec || conn->generation != generation) {
+      return;
+    }
+    conn->timed_out = true;
+    conn->close();
+  });
+}
+
+void PutRecordsTransport::complete(const ConnectionPtr& conn,
+                                   const ExchangePtr& ex,
+                                   int status,
+                                   std::string body,
+                                   bool keep_alive) {
+  conn->generation++;
+  conn->timer.cancel();
+  conn->served++;
+  if (status == 200) {
+    ex->prc->set_response_body(std::move(body));
+  } else {
+    ex->prc->set_outcome(error_outcome(status, body));
+  }
+  if (!keep_alive) {
+    conn->close();
+  }
+  release(conn, keep_alive);
+  ex->done(ex->prc);
+}
+
+void PutRecordsTransport::fail(const ConnectionPtr& conn,
+                               const ExchangePtr& ex,
+                               const std::string& reason) {
+  // A kept-alive connection may have been closed by the server while it sat
+  // in the pool. If so, nothing of the request got processed, and it's sent
+  // once more on a fresh connection instead of being reported.
+  bool stale = conn->served > 0 && !conn->timed_out && !ex->responded &&
+      !ex->retried;
+  bool timed_out = conn->timed_out;
+  conn->generation++;
+  conn->timer.cancel();
+  conn->close();
+  release(conn, false);
+
+  if (stale) {
+    ex->retried = true;
+    dispatch(ex);
+    return;
+  }
+
+  if (timed_out) {
+    ex->prc->set_outcome(error_outcome(
+        "RequestTimeout",
+        "Request timed out: " + reason,
+        true,
+        Aws::Kinesis::KinesisErrors::NETWORK_CONNECTION));
+  } else {
+    ex->prc->set_outcome(error_outcome(
+        "NetworkError",
+        reason,
+        true,
+        Aws::Kinesis::KinesisErrors::NETWORK_CONNECTION));
+  }
+  ex->done(ex->prc);
+}
+
+void PutRecordsTransport::release(ConnectionPtr conn, bool reusable) {
+  ExchangePtr next;
+  {
+    aws::lock_guard<aws::utils::SpinLock> lk(mutex_);
+    if (!waiting_.empty()) {
+      next = std::move(waiting_.front());
+      waiting_.pop_front();
+    } else if (reusable) {
+      idle_.push_back(conn);
+    } else {
+      connections_--;
+    }
+  }
+  if (next) {
+    if (!reusable && !(conn = new_connection())) {
+      fail_shutdown(next);
+      return;
+    }
+    start(conn, next);
+  }
+}
+
+void PutRecordsTransport::fail_shutdown(const ExchangePtr& ex) {
+  {
+    aws::lock_guard<aws::utils::SpinLock> lk(mutex_);
+    connections_--;
+  }
+  ex->prc->set_outcome(error_outcome(
+      "NetworkError",
+      "Shutting down",
+      false,
+      Aws::Kinesis::KinesisErrors::NETWORK_CONNECTION));
+  ex->done(ex->prc);
+}
+
+PutRecordsTransport::ConnectionPtr PutRecordsTransport::new_connection() {
+  auto executor = executor_.lock();
+  if (!executor) {
+    return nullptr;
+  }
+  return std::make_shared<Connection>(*executor->io_reactor(),
+                                      ssl_context_.get(),
+                                      host_);
+}
+
+std::string PutRecordsTransport::request_head(const PutRecordsContext& prc,
+                                              const std::string& body) {
+  auto creds = credentials_();
+  auto date =
+      aws::auth::SigV4Signer::amz_date(std::chrono::system_clock::now());
+  const auto& token = creds.GetSessionToken();
+
+  aws::auth::SigV4Signer::Headers headers;
+  headers.reserve(5);
+  headers.emplace_back("content-type", kContentType);
+  headers.emplace_back("host", host_header_);
+  headers.emplace_back("x-amz-date", date);
+  if (!token.empty()) {
+    headers.emplace_back("x-amz-security-token", token);
+  }
+  headers.emplace_back("x-amz-target", kTarget);
+  auto auth =
+      signer_.authorization("POST", "/", "", headers, body, creds, date);
+
+  std::string head;
+  head.reserve(head_template_.size() + auth.size() + token.size() + 128);
+  head += head_template_;
+  head += "X-Amz-Date: ";
+  head += date;
+  head += "\r\n";
+  if (!token.empty()) {
+    head += "X-Amz-Security-Token: ";
+    head += token;
+    head += "\r\n";
+  }
+  head += "Content-Length: ";
+  head += std::to_string(body.size());
+  head += "\r\nAuthorization: ";
+  head += auth;
+  head += "\r\n\r\n";
+  return head;
+}
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
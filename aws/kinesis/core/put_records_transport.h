@@ -0,0 +1,161 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_KINESIS_CORE_PUT_RECORDS_TRANSPORT_H_
+#define AWS_KINESIS_CORE_PUT_RECORDS_TRANSPORT_H_
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/asio/ssl/context.hpp>
+#include <boost/noncopyable.hpp>
+
+#include <aws/auth/sigv4_signer.h>
+#include <aws/kinesis/core/put_records_context.h>
+#include <aws/mutex.h>
+#include <aws/utils/executor.h>
+#include <aws/utils/spin_lock.h>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+// Sends PutRecords requests over keep-alive HTTP/1.1 connections of its own,
+// instead of through the SDK's generic HTTP client.
+//
+// Bodies are written by encode_put_records and signed with SigV4; the headers
+// that are the same for every request are built once. Connections live on the
+// io_contexts of the executor, so their I/O and the completions are handled by
+// the same threads as the rest of the pipeline. Up to max_connections are
+// opened and kept for reuse; requests beyond that wait for one to free up.
+//
+// The body of a successful response is handed over as is, for the retrier to
+// parse (see PutRecordsContext::set_response_body). Anything else becomes an
+// error outcome named after the service's error type, like the SDK reports
+// them, or NetworkError or RequestTimeout.
+class PutRecordsTransport
+    : boost::noncopyable,
+      public std::enable_shared_from_this<PutRecordsTransport> {
+ public:
+  using Callback =
+      std::function<void (const std::shared_ptr<PutRecordsContext>&)>;
+  using CredentialsGetter = std::function<Aws::Auth::AWSCredentials ()>;
+
+  // ssl_context is nullptr for plain HTTP. The executor has to have an
+  // io_reactor().
+  PutRecordsTransport(std::shared_ptr<aws::utils::Executor> executor,
+                      std::string host,
+                      uint16_t port,
+                      std::shared_ptr<boost::asio::ssl::context> ssl_context,
+                      std::string region,
+                      CredentialsGetter credentials,
+                      std::string user_agent,
+                      size_t max_connections,
+                      std::chrono::milliseconds connect_timeout,
+                      std::chrono::milliseconds request_timeout);
+
+  // Sends the records of prc, then calls done once its outcome, or the body
+  // of a successful response, has been set. done runs on one of the
+  // executor's threads.
+  void send(const std::shared_ptr<PutRecordsContext>& prc, Callback done);
+
+  // Connections open or being opened.
+  size_t connections();
+
+  static std::shared_ptr<boost::asio::ssl::context> make_ssl_context(
+      bool verify_certificate,
+      const std::string& ca_path,
+      const std::string& ca_file);
+
+ private:
+  struct Connection;
+  struct Exchange;
+
+  using ConnectionPtr = std::shared_ptr<Connection>;
+  using ExchangePtr = std::shared_ptr<Exchange>;
+
+  void dispatch(const ExchangePtr& ex);
+
+  void start(const ConnectionPtr& conn, const ExchangePtr& ex);
+
+  void connect(const ConnectionPtr& conn, const ExchangePtr& ex);
+
+  void write(const ConnectionPtr& conn, const ExchangePtr& ex);
+
+  void read_headers(const ConnectionPtr& conn, const ExchangePtr& ex);
+
+  void read_body(const ConnectionPtr& conn,
+                 const ExchangePtr& ex,
+                 int status,
+                 size_t content_length,
+                 bool keep_alive);
+
+  void arm_timer(const ConnectionPtr& conn, std::chrono::milliseconds timeout);
+
+  void complete(const ConnectionPtr& conn,
+                const ExchangePtr& ex,
+                int status,
+                std::string body,
+                bool keep_alive);
+
+  void fail(const ConnectionPtr& conn,
+            const ExchangePtr& ex,
+            const std::string& reason);
+
+  // Hands conn to the next waiting request, or back to the pool. A
+  // connection that can't be reused is replaced if a request is waiting.
+  void release(ConnectionPtr conn, bool reusable);
+
+  // Returns nullptr once the executor is gone.
+  ConnectionPtr new_connection();
+
+  // Gives up on ex, whose connection couldn't be made, and the slot that was
+  // taken for it.
+  void fail_shutdown(const ExchangePtr& ex);
+
+  std::string request_head(const PutRecordsContext& prc,
+                           const std::string& body);
+
+  // Handlers keep the transport alive, so owning the executor could leave
+  // the last reference to it on one of its own threads.
+  std::weak_ptr<aws::utils::Executor> executor_;
+  const std::string host_;
+  const std::string port_;
+  std::shared_ptr<boost::asio::ssl::context> ssl_context_;
+  CredentialsGetter credentials_;
+  const size_t max_connections_;
+  const std::chrono::milliseconds connect_timeout_;
+  const std::chrono::milliseconds request_timeout_;
+
+  aws::auth::SigV4Signer signer_;
+  std::string host_header_;
+  // The request line and the headers that don't change between requests.
+  std::string head_template_;
+
+  aws::utils::SpinLock mutex_;
+  std::vector<ConnectionPtr> idle_;
+  std::deque<ExchangePtr> waiting_;
+  size_t connections_;
+};
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
+
+#endif //AWS_KINESIS_CORE_PUT_RECORDS_TRANSPORT_H_
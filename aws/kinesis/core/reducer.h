@@ -16,6 +16,7 @@
 #ifndef AWS_KINESIS_CORE_REDUCER_H_
 #define AWS_KINESIS_CORE_REDUCER_H_
 
+#include <atomic>
 #include <mutex>
 
 #include <aws/utils/logging.h>
@@ -72,7 +73,8 @@ class Reducer : boost::noncopyable {
         scheduled_callback_(
             executor_->schedule(
                 [this] { this->deadline_reached(); },
-                TimePoint::max())) {}
+                TimePoint::max(),
+                aws::utils::Priority::High)) {}
 
   // Put a record. If this triggers a flush, an instance of U will be returned,
   // otherwise null will be returned.
@@ -108,6 +110,23 @@ class Reducer : boost::noncopyable {
     trigger_flush(flush_reason);
   }
 
+  // Changes the limits that trigger a flush. If the records already held
+  // exceed the new limits, they are flushed right away.
+  void set_limits(size_t size_limit, size_t count_limit) {
+    size_limit_ = size_limit;
+    count_limit_ = count_limit;
+
+    Lock lock(lock_);
+    FlushReason flush_reason;
+    flush_reason.record_count(container_->size() >= count_limit)
+        .data_size(container_->estimated_size() >= size_limit);
+    lock.unlock();
+
+    if (flush_reason.flush_required()) {
+      trigger_flush(flush_reason);
+    }
+  }
+
   // Records in the process of being flushed won't be counted
   size_t size() const {
     return container_->size();
@@ -198,8 +217,8 @@ class Reducer : boost::noncopyable {
 
   std::shared_ptr<aws::utils::Executor> executor_;
   std::function<void (std::shared_ptr<U>)> flush_callback_;
-  const size_t size_limit_;
-  const size_t count_limit_;
+  std::atomic<size_t> size_limit_;
+  std::atomic<size_t> count_limit_;
   FlushPredicate flush_predicate_;
   Mutex lock_;
   std::shared_ptr<U> container_;
@@ -0,0 +1,112 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_KINESIS_CORE_REQUEST_SERIALIZER_H_
+#define AWS_KINESIS_CORE_REQUEST_SERIALIZER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include <aws/kinesis/core/kinesis_record.h>
+#include <aws/utils/executor.h>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+// Serializes the aggregated KinesisRecords of a request before it's assembled,
+// in chunks spread over the executor's threads, so that building the body only
+// has to concatenate (see KinesisRecord::serialize_ahead).
+//
+// Requests with less than two chunks of aggregated records, or an executor with
+// a single thread, aren't worth the hand-off; those are left as they are and
+// serialized during assembly, as before.
+class RequestSerializer : boost::noncopyable {
+ public:
+  static constexpr const size_t kDefaultMinChunkBytes = 128 * 1024;
+
+  RequestSerializer(std::shared_ptr<aws::utils::Executor> executor,
+                    size_t min_chunk_bytes = kDefaultMinChunkBytes)
+      : executor_(std::move(executor)),
+        min_chunk_bytes_(std::max<size_t>(min_chunk_bytes, 1)) {}
+
+  // Calls done once the records are ready to be assembled. That is right here
+  // if nothing was handed off, otherwise on the executor thread that finished
+  // the last chunk.
+  void serialize(const std::vector<std::shared_ptr<KinesisRecord>>& records,
+                 aws::utils::Task done) {
+    std::vector<std::shared_ptr<KinesisRecord>> aggregated;
+    size_t total_bytes = 0;
+    for (auto& kr : records) {
+      if (kr->size() > 1) {
+        total_bytes += kr->accurate_size();
+        aggregated.push_back(kr);
+      }
+    }
+
+    auto num_chunks = std::min(executor_->num_threads(),
+                               total_bytes / min_chunk_bytes_);
+    if (num_chunks < 2) {
+      done();
+      return;
+    }
+
+    auto pending = std::make_shared<Pending>(std::move(done), num_chunks);
+    auto chunk_bytes = total_bytes / num_chunks;
+    auto it = aggregated.begin();
+    for (size_t i = 0; i < num_chunks; i++) {
+      Chunk chunk;
+      size_t bytes = 0;
+      while (it != aggregated.end() &&
+             (bytes < chunk_bytes || i == num_chunks - 1)) {
+        bytes += (*it)->accurate_size();
+        chunk.push_back(std::move(*it++));
+      }
+      executor_->submit([pending, chunk = std::move(chunk)] {
+        for (auto& kr : chunk) {
+          kr->serialize_ahead();
+        }
+        if (--pending->chunks_left == 0) {
+          pending->done();
+        }
+      }, aws::utils::Priority::High);
+    }
+  }
+
+ private:
+  using Chunk = std::vector<std::shared_ptr<KinesisRecord>>;
+
+  struct Pending {
+    Pending(aws::utils::Task d, size_t chunks)
+        : done(std::move(d)),
+          chunks_left(chunks) {}
+
+    aws::utils::Task done;
+    std::atomic<size_t> chunks_left;
+  };
+
+  std::shared_ptr<aws::utils::Executor> executor_;
+  const size_t min_chunk_bytes_;
+};
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
+
+#endif //AWS_KINESIS_CORE_REQUEST_SERIALIZER_H_
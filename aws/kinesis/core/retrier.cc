@@ -43,7 +43,7 @@ MetricsPutter& MetricsPutter::operator ()(
 
 void
 Retrier::handle_put_records_result(std::shared_ptr<PutRecordsContext> prc) {
-  auto outcome = prc->get_outcome();
+  auto& outcome = prc->get_outcome();
   auto start = prc->get_start();
   auto end = prc->get_end();
 
@@ -63,7 +63,36 @@ Retrier::handle_put_records_result(std::shared_ptr<PutRecordsContext> prc) {
     }
   } else {
     detail::MetricsPutter metrics_putter(metrics_manager_, prc->get_stream());
-    auto result = outcome.GetResult().GetRecords();
+
+    // The entries point into the response, whichever form it's in, so
+    // nothing is copied until a result is handed to a record.
+    std::vector<PutRecordsResponseEntry> result;
+    result.reserve(prc->get_records().size());
+    if (prc->get_response_body()) {
+      try {
+        parse_put_records_response(
+            *prc->get_response_body(),
+            [&](auto& entry) { result.push_back(entry); });
+      } catch (const std::exception& ex) {
+        LOG(error) << ex.what();
+        for (auto& kr : prc->get_records()) {
+          retry_not_expired(kr, start, end, "Malformed Response", ex.what());
+        }
+        return;
+      }
+    } else {
+      for (auto& r : outcome.GetResult().GetRecords()) {
+        PutRecordsResponseEntry entry;
+        entry.shard_id = r.GetShardId();
+        entry.sequence_number = r.GetSequenceNumber();
+        entry.error_code = r.GetErrorCode();
+        entry.error_message = r.GetErrorMessage();
+        if (entry.success()) {
+          entry.shard_number = ShardMap::shard_id_from_str(entry.shard_id);
+        }
+        result.push_back(entry);
+      }
+    }
 
     // If somehow there's a size mismatch, subsequent code may crash from
     // array out of bounds, so we're going to explicitly catch it here and
@@ -86,7 +115,7 @@ Retrier::handle_put_records_result(std::shared_ptr<PutRecordsContext> prc) {
     for (size_t i = 0; i < result.size(); i++) {
       auto& kr = prc->get_records()[i];
       auto& put_result = result[i];
-      bool success = put_result.GetSequenceNumber().size() > 0;
+      bool success = put_result.success();
       auto predicted_shard = kr->items().front()->predicted_shard();
 
       using aws::metrics::constants::Names;
@@ -98,7 +127,8 @@ Retrier::handle_put_records_result(std::shared_ptr<PutRecordsContext> prc) {
       } else {
         metrics_putter
             (Names::KinesisRecordsPut, 0, predicted_shard)
-            (Names::ErrorsByCode, 1, predicted_shard, put_result.GetErrorCode())
+            (Names::ErrorsByCode, 1, predicted_shard,
+             put_result.text(put_result.error_code))
             (Names::AllErrors, 1, predicted_shard);
       }
 
@@ -107,19 +137,23 @@ Retrier::handle_put_records_result(std::shared_ptr<PutRecordsContext> prc) {
         //So either all user records in a kinesis record landed on the correct shard
         //or none did. So we can invalidate just once per kinesis record.
         bool should_invalidate_on_incorrect_shard = true;
-        auto hashrange_actual_shard = shard_map_hashrange_cb_(ShardMap::shard_id_from_str(put_result.GetShardId()));
+        auto actual_shard = put_result.shard_number;
+        auto hashrange_actual_shard = shard_map_hashrange_cb_(actual_shard);
+        auto shard_id = put_result.shard_id.to_string();
+        auto sequence_number = put_result.sequence_number.to_string();
         for (auto& ur : kr->items()) {  
           should_invalidate_on_incorrect_shard &= succeed_if_correct_shard(ur,
                                    start,
                                    end,
-                                   put_result.GetShardId(),
-                                   put_result.GetSequenceNumber(),
+                                   actual_shard,
+                                   shard_id,
+                                   sequence_number,
                                    should_invalidate_on_incorrect_shard,
                                    hashrange_actual_shard);
         }
       } else {
-        auto& err_code = put_result.GetErrorCode();
-        auto& err_msg = put_result.GetErrorMessage();
+        auto err_code = put_result.text(put_result.error_code);
+        auto err_msg = put_result.text(put_result.error_message);
         if (!(config_->fail_if_throttled() &&
               err_code == "ProvisionedThroughputExceededException")) {
           retry_not_expired(kr, start, end, err_code, err_msg);
@@ -194,11 +228,11 @@ void Retrier::fail(const std::shared_ptr<UserRecord>& ur,
 bool Retrier::succeed_if_correct_shard(const std::shared_ptr<UserRecord>& ur,
                                        TimePoint start,
                                        TimePoint end,
-                                       const std::string& shard_id,                                     
+                                       const uint64_t actual_shard,
+                                       const std::string& shard_id,
                                        const std::string& sequence_number,
                                        const bool should_invalidate_on_incorrect_shard,
                                        const boost::optional<std::pair<uint128_t, uint128_t>>& hashrange_actual_shard) {
-  const uint64_t actual_shard = ShardMap::shard_id_from_str(shard_id);
   if (ur->predicted_shard() && *ur->predicted_shard() != actual_shard) {
     // retry if shard is not found or hash key of the user record doesn't fit into the actual shard's hashrange
     if (!hashrange_actual_shard || 
@@ -237,7 +271,7 @@ void Retrier::invalidate_cache(const std::shared_ptr<UserRecord>& ur,
                   << "predicted shard " << *ur->predicted_shard() << "; this "
                   << "usually means the sharp map has changed.";   
 
-    shard_map_invalidate_cb_(start, ur->predicted_shard());
+    shard_map_invalidate_cb_(start, ur->predicted_shard(), actual_shard);
   }
 }
 
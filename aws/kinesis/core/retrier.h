@@ -21,6 +21,7 @@
 #include <aws/kinesis/core/configuration.h>
 #include <aws/kinesis/core/put_records_context.h>
 #include <aws/kinesis/core/put_records_request.h>
+#include <aws/kinesis/core/put_records_response.h>
 #include <aws/kinesis/core/shard_map.h>
 #include <aws/kinesis/model/Shard.h>
 #include <aws/metrics/metrics_manager.h>
@@ -61,7 +62,9 @@ class Retrier {
   using UserRecordCallback =
       std::function<void (const std::shared_ptr<UserRecord>&)>;
   using ShardMapGetHashrangeCallback = std::function<boost::optional<std::pair<uint128_t, uint128_t>> (const uint64_t&)>;
-  using ShardMapInvalidateCallback = std::function<void (const TimePoint&, const boost::optional<uint64_t>)>;
+  using ShardMapInvalidateCallback = std::function<void (const TimePoint&,
+                                                          const boost::optional<uint64_t>,
+                                                          const boost::optional<uint64_t>)>;
   using ErrorCallback =
       std::function<void (const std::string&, const std::string&)>;
 
@@ -92,6 +95,22 @@ class Retrier {
     retry_not_expired(kr, now, now, err_code, err_msg);
   }
 
+  // Fails the records without retrying, e.g. when they're rejected before
+  // being sent.
+  void fail(const std::shared_ptr<KinesisRecord>& kr,
+            const std::string& err_code,
+            const std::string& err_msg) {
+    auto now = std::chrono::steady_clock::now();
+    fail(kr, now, now, err_code, err_msg);
+  }
+
+  void fail(const std::shared_ptr<UserRecord>& ur,
+            const std::string& err_code,
+            const std::string& err_msg) {
+    auto now = std::chrono::steady_clock::now();
+    fail(ur, now, now, err_code, err_msg);
+  }
+
  private:
   void handle_put_records_result(std::shared_ptr<PutRecordsContext> prc);
 
@@ -122,6 +141,7 @@ class Retrier {
   bool succeed_if_correct_shard(const std::shared_ptr<UserRecord>& ur,
                                 TimePoint start,
                                 TimePoint end,
+                                const uint64_t actual_shard,
                                 const std::string& shard_id,
                                 const std::string& sequence_number,
                                 const bool should_invalidate_on_incorrect_shard,
@@ -0,0 +1,183 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_KINESIS_CORE_SHARD_BOUNDARIES_H_
+#define AWS_KINESIS_CORE_SHARD_BOUNDARIES_H_
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/optional.hpp>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+// Maps hash keys to the shard whose ending hash key is the first one greater
+// than or equal to the key.
+//
+// The 128 bit ending hash keys are split into high and low 64 bit halves and
+// stored as separate arrays, so a probe touches 16 bytes instead of a
+// multiprecision number plus a shard id. For single lookups the arrays are
+// laid out in Eytzinger (BFS) order, which keeps the first levels of the
+// search in a few cache lines and lets us prefetch the levels below. For
+// batches, the keys are sorted and merge-walked against the boundaries in
+// ascending order instead.
+//
+// Immutable after construction, so it can be read from any number of threads.
+class ShardBoundaries {
+ public:
+  using uint128_t = boost::multiprecision::uint128_t;
+
+  ShardBoundaries() = default;
+
+  // end_hash_key_to_shard_id must be sorted by ending hash key.
+  explicit ShardBoundaries(
+      const std::vector<std::pair<uint128_t, uint64_t>>& end_hash_key_to_shard_id)
+      : sorted_hi_(end_hash_key_to_shard_id.size()),
+        sorted_lo_(end_hash_key_to_shard_id.size()),
+        sorted_shard_ids_(end_hash_key_to_shard_id.size()),
+        hi_(end_hash_key_to_shard_id.size() + 1),
+        lo_(end_hash_key_to_shard_id.size() + 1),
+        shard_ids_(end_hash_key_to_shard_id.size() + 1) {
+    for (size_t i = 0; i < end_hash_key_to_shard_id.size(); i++) {
+      sorted_hi_[i] = high(end_hash_key_to_shard_id[i].first);
+      sorted_lo_[i] = low(end_hash_key_to_shard_id[i].first);
+      sorted_shard_ids_[i] = end_hash_key_to_shard_id[i].second;
+    }
+    size_t i = 0;
+    build(i, 1);
+  }
+
+  size_t size() const noexcept {
+    return sorted_shard_ids_.size();
+  }
+
+  boost::optional<uint64_t> find(const uint128_t& hash_key) const noexcept {
+    const uint64_t key_hi = high(hash_key);
+    const uint64_t key_lo = low(hash_key);
+    const size_t n = size();
+
+    size_t k = 1;
+    while (k <= n) {
+      prefetch(k * kPrefetchDistance);
+      k = 2 * k + (less(hi_[k], lo_[k], key_hi, key_lo) ? 1 : 0);
+    }
+    // k now encodes the path taken; the answer is the last node where we went
+    // left, which we get by stripping the trailing right turns (1 bits) and the
+    // final left turn.
+    while (k & 1) {
+      k >>= 1;
+    }
+    k >>= 1;
+
+    if (k == 0) {
+      return boost::none;
+    }
+    return shard_ids_[k];
+  }
+
+  // Looks up a batch of hash keys at once. The result at index i is the shard
+  // for hash_keys[i].
+  std::vector<boost::optional<uint64_t>>
+  find(const std::vector<uint128_t>& hash_keys) const {
+    std::vector<std::pair<uint64_t, uint64_t>> keys(hash_keys.size());
+    for (size_t i = 0; i < hash_keys.size(); i++) {
+      keys[i] = {high(hash_keys[i]), low(hash_keys[i])};
+    }
+
+    std::vector<size_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](auto a, auto b) {
+      return keys[a] < keys[b];
+    });
+
+    std::vector<boost::optional<uint64_t>> result(keys.size());
+    size_t boundary = 0;
+    for (auto i : order) {
+      while (boundary < size() &&
+             less(sorted_hi_[boundary],
+                  sorted_lo_[boundary],
+                  keys[i].first,
+                  keys[i].second)) {
+        boundary++;
+      }
+      if (boundary == size()) {
+        break;
+      }
+      result[i] = sorted_shard_ids_[boundary];
+    }
+    return result;
+  }
+
+ private:
+  // 4 levels down from node k, the 16 nodes start at 16 * k. With 8 byte
+  // elements they share two cache lines, so the search fetches them while it
+  // walks the 4 levels in between.
+  static constexpr const size_t kPrefetchDistance = 16;
+
+  static uint64_t high(const uint128_t& v) noexcept {
+    return static_cast<uint64_t>(v >> 64);
+  }
+
+  static uint64_t low(const uint128_t& v) noexcept {
+    return static_cast<uint64_t>(v & uint128_t(UINT64_MAX));
+  }
+
+  static bool less(uint64_t a_hi,
+                   uint64_t a_lo,
+                   uint64_t b_hi,
+                   uint64_t b_lo) noexcept {
+    return a_hi < b_hi || (a_hi == b_hi && a_lo < b_lo);
+  }
+
+  void prefetch(size_t k) const noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+    if (k < hi_.size()) {
+      __builtin_prefetch(&hi_[k]);
+      __builtin_prefetch(&lo_[k]);
+    }
+#endif
+  }
+
+  // In-order traversal of the implicit tree fills it with the sorted values.
+  void build(size_t& i, size_t k) {
+    if (k <= size()) {
+      build(i, 2 * k);
+      hi_[k] = sorted_hi_[i];
+      lo_[k] = sorted_lo_[i];
+      shard_ids_[k] = sorted_shard_ids_[i];
+      i++;
+      build(i, 2 * k + 1);
+    }
+  }
+
+  std::vector<uint64_t> sorted_hi_;
+  std::vector<uint64_t> sorted_lo_;
+  std::vector<uint64_t> sorted_shard_ids_;
+
+  // Eytzinger order, 1-indexed; element 0 is unused.
+  std::vector<uint64_t> hi_;
+  std::vector<uint64_t> lo_;
+  std::vector<uint64_t> shard_ids_;
+};
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
+
+#endif //AWS_KINESIS_CORE_SHARD_BOUNDARIES_H_
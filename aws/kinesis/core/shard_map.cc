@@ -13,7 +13,9 @@
  * limitations under the License.
  */
 
+#include <limits>
 #include <thread>
+#include <tuple>
 #include <aws/kinesis/core/shard_map.h>
 
 #include <aws/kinesis/model/ListShardsRequest.h>
@@ -25,6 +27,7 @@ namespace core {
 const std::chrono::milliseconds ShardMap::kMinBackoff{1000};
 const std::chrono::milliseconds ShardMap::kMaxBackoff{30000};
 const std::chrono::milliseconds ShardMap::kClosedShardTtl{60000};
+const std::chrono::milliseconds ShardMap::kMaxCacheRevalidationDelay{60000};
 
 ShardMap::ShardMap(
     std::shared_ptr<aws::utils::Executor> executor,
@@ -35,7 +38,8 @@ ShardMap::ShardMap(
     std::shared_ptr<aws::metrics::MetricsManager> metrics_manager,
     std::chrono::milliseconds min_backoff,
     std::chrono::milliseconds max_backoff,
-    std::chrono::milliseconds closed_shard_ttl)
+    std::chrono::milliseconds closed_shard_ttl,
+    std::shared_ptr<ShardMapCache> cache)
     : executor_(std::move(executor)),
       stream_(std::move(stream)),
       stream_arn_(std::move(stream_arn)),
@@ -46,24 +50,102 @@ ShardMap::ShardMap(
       max_backoff_(max_backoff),
       closed_shard_ttl_(closed_shard_ttl),
       backoff_(min_backoff_),
-      list_shards_callback_(list_shards_callback) {
-  update();
-  std::thread cleanup_thread_(&ShardMap::cleanup, this);
-  cleanup_thread_.detach();
+      list_shards_callback_(list_shards_callback),
+      cache_(std::move(cache)) {
+  if (!cache_ || !start_from_cache()) {
+    update();
+  }
+  // cleanup() reschedules through scheduled_cleanup_, so the member has to be
+  // set before the callback can first fire.
+  scheduled_cleanup_ =
+      executor_->schedule([this] { this->cleanup(); },
+                          TimePoint::max(),
+                          aws::utils::Priority::Low);
+  scheduled_cleanup_->reschedule(closed_shard_ttl_ / 2);
+}
+
+ShardMap::~ShardMap() {
+  if (scheduled_cleanup_) {
+    scheduled_cleanup_->cancel();
+  }
+  if (scheduled_callback_) {
+    scheduled_callback_->cancel();
+  }
+}
+
+// Serves the shard map saved by an earlier run until it has been refreshed.
+// The refresh happens at a random point before the cached copy expires, so
+// that producers restarted together don't all call ListShards together.
+bool ShardMap::start_from_cache() {
+  auto contents = cache_->load();
+  if (!contents) {
+    return false;
+  }
+
+  std::unordered_set<uint64_t> open_shard_ids;
+  {
+    WriteLock lock(shard_cache_mutex_);
+    for (const auto& shard : contents->shards) {
+      shard_id_to_shard_hashkey_cache_.insert(
+          {shard.shard_id, {shard.starting_hash_key, shard.ending_hash_key}});
+      open_shard_ids.insert(shard.shard_id);
+    }
+  }
+  auto snapshot = build_snapshot(open_shard_ids);
+  if (!snapshot) {
+    LOG(warning) << "Shard map cache " << cache_->path() << " for stream \""
+                 << stream_ << "\" is inconsistent; ignoring it";
+    return false;
+  }
+  publish(std::move(snapshot));
+  state_ = READY;
+  updated_at_ = std::chrono::steady_clock::now();
+
+  auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+      contents->written_at + cache_->ttl() - std::chrono::system_clock::now());
+  auto max_delay = std::min(remaining, kMaxCacheRevalidationDelay);
+  auto delay = std::chrono::milliseconds(
+      aws::utils::random_int(0, std::max<int64_t>(max_delay.count(), 1)));
+  scheduled_callback_ =
+      executor_->schedule([this] {
+            WriteLock lock(mutex_);
+            this->update();
+          },
+          delay);
+
+  LOG(info) << "Loaded shard map for stream \"" << stream_ << "\" from "
+            << cache_->path() << " with " << open_shard_ids.size()
+            << " shards; refreshing in " << delay.count() << " ms";
+  return true;
+}
+
+// Must be called with the write lock held.
+void ShardMap::store_in_cache() {
+  if (!cache_) {
+    return;
+  }
+
+  std::vector<ShardMapCache::Shard> shards;
+  {
+    ReadLock lock(shard_cache_mutex_);
+    for (auto id : snapshot_->open_shard_ids) {
+      const auto it = shard_id_to_shard_hashkey_cache_.find(id);
+      if (it != shard_id_to_shard_hashkey_cache_.end()) {
+        shards.push_back({id, it->second.first, it->second.second});
+      }
+    }
+  }
+  cache_->store(shards);
 }
 
 boost::optional<uint64_t> ShardMap::shard_id(const uint128_t& hash_key) {
-  ReadLock lock(mutex_, aws::defer_lock);
-
-  if (lock.try_lock() && state_ == READY) {
-    auto it = std::lower_bound(end_hash_key_to_shard_id_.begin(),
-                               end_hash_key_to_shard_id_.end(),
-                               hash_key,
-                               [](const auto& pair, auto key) {
-                                 return pair.first < key;
-                               });
-    if (it != end_hash_key_to_shard_id_.end()) {
-      return it->second;
+  ReaderGuard guard(*this);
+  auto snapshot = current_.load();
+
+  if (snapshot) {
+    auto shard_id = snapshot->boundaries.find(hash_key);
+    if (shard_id) {
+      return shard_id;
     } else {
       LOG(error) << "Could not map hash key to shard id. Something's wrong"
                  << " with the shard map. Hash key = " << hash_key;
@@ -73,6 +155,23 @@ boost::optional<uint64_t> ShardMap::shard_id(const uint128_t& hash_key) {
   return boost::none;
 }
 
+std::vector<boost::optional<uint64_t>>
+ShardMap::shard_ids(const std::vector<uint128_t>& hash_keys) {
+  ReaderGuard guard(*this);
+  auto snapshot = current_.load();
+
+  if (!snapshot) {
+    return std::vector<boost::optional<uint64_t>>(hash_keys.size());
+  }
+  return snapshot->boundaries.find(hash_keys);
+}
+
+uint64_t ShardMap::epoch() {
+  ReaderGuard guard(*this);
+  auto snapshot = current_.load();
+  return snapshot ? snapshot->epoch : 0;
+}
+
 boost::optional<std::pair<ShardMap::uint128_t, ShardMap::uint128_t>> ShardMap::hashrange(const uint64_t& shard_id) {
   ReadLock lock(shard_cache_mutex_);
   const auto& it = shard_id_to_shard_hashkey_cache_.find(shard_id);
@@ -83,15 +182,24 @@ boost::optional<std::pair<ShardMap::uint128_t, ShardMap::uint128_t>> ShardMap::h
 }
 
 
-void ShardMap::invalidate(const TimePoint& seen_at, const boost::optional<uint64_t> predicted_shard) {
+void ShardMap::invalidate(const TimePoint& seen_at,
+                          const boost::optional<uint64_t> predicted_shard,
+                          const boost::optional<uint64_t> actual_shard) {
   WriteLock lock(mutex_);
   
   if (seen_at > updated_at_ && state_ == READY) {
-    if (!predicted_shard || open_shards_.count(*predicted_shard)) {
+    if (!predicted_shard || snapshot_->open_shard_ids.count(*predicted_shard)) {
       std::chrono::duration<double, std::milli> fp_ms = seen_at - updated_at_;
       LOG(info) << "Deciding to update shard map for \"" << stream_ 
-                <<"\" with a gap between seen_at and updated_at_ of " << fp_ms.count() << " ms " << "predicted shard: " << predicted_shard;
-      update();
+                <<"\" with a gap between seen_at and updated_at_ of " << fp_ms.count() << " ms " << "predicted shard: " << predicted_shard
+                << " actual shard: " << actual_shard;
+      // Child shards always have higher ids than their parents, so a record
+      // landing in a newer shard means the predicted shard was resharded.
+      if (predicted_shard && actual_shard && *actual_shard > *predicted_shard) {
+        update_incremental(*predicted_shard);
+      } else {
+        update();
+      }
     }
   }
 }
@@ -103,7 +211,11 @@ void ShardMap::update() {
 
   state_ = UPDATING;
   LOG(info) << "Updating shard map for stream \"" << stream_ << "\"";
-  clear_all_stored_shards();
+  // The current snapshot keeps serving lookups until the new one is complete.
+  pending_end_hash_key_to_shard_id_.clear();
+  pending_open_shard_ids_.clear();
+  pending_retired_shard_ids_.clear();
+  list_shards_after_ = boost::none;
   if (scheduled_callback_) {
     scheduled_callback_->cancel();
   }
@@ -113,6 +225,97 @@ void ShardMap::update() {
   list_shards();
 }
 
+// Replaces the predicted shard with the shards that succeeded it, without
+// listing the whole stream again.
+void ShardMap::update_incremental(uint64_t predicted_shard) {
+  if (state_ == UPDATING) {
+    return;
+  }
+
+  if (update_from_cache(predicted_shard)) {
+    return;
+  }
+
+  auto& open_shard_ids = snapshot_->open_shard_ids;
+  if (open_shard_ids.empty()) {
+    update();
+    return;
+  }
+
+  state_ = UPDATING;
+  // Shards created since the last update all have ids greater than any shard
+  // we know of, so listing after the newest open shard finds all of them.
+  list_shards_after_ =
+      *std::max_element(open_shard_ids.begin(), open_shard_ids.end());
+  LOG(info) << "Incrementally updating shard map for stream \"" << stream_
+            << "\" with shards after " << shard_id_to_str(*list_shards_after_);
+  pending_open_shard_ids_.clear();
+  pending_retired_shard_ids_.clear();
+  if (scheduled_callback_) {
+    scheduled_callback_->cancel();
+  }
+
+  list_shards();
+}
+
+// Tries to replace the predicted shard using hash key ranges that are already
+// in the cache, e.g. because another record already triggered an update for a
+// sibling. Returns false if the cache doesn't describe a consistent map.
+bool ShardMap::update_from_cache(uint64_t predicted_shard) {
+  auto open_shard_ids = snapshot_->open_shard_ids;
+
+  {
+    ReadLock lock(shard_cache_mutex_);
+    const auto predicted = shard_id_to_shard_hashkey_cache_.find(predicted_shard);
+    if (predicted == shard_id_to_shard_hashkey_cache_.end()) {
+      return false;
+    }
+
+    auto overlaps = [](const auto& a, const auto& b) {
+      return a.first <= b.second && b.first <= a.second;
+    };
+
+    std::unordered_map<uint64_t, std::pair<uint128_t, uint128_t>> successors;
+    for (const auto& kv : shard_id_to_shard_hashkey_cache_) {
+      if (kv.first > predicted_shard &&
+          !open_shard_ids.count(kv.first) &&
+          overlaps(kv.second, predicted->second)) {
+        successors.insert(kv);
+      }
+    }
+    if (successors.empty()) {
+      return false;
+    }
+
+    // Drop the open shards the successors took over from, i.e. the predicted
+    // shard and, for a merge, its adjacent parent.
+    for (auto it = open_shard_ids.begin(); it != open_shard_ids.end();) {
+      const auto range = shard_id_to_shard_hashkey_cache_.find(*it);
+      const bool replaced =
+          range != shard_id_to_shard_hashkey_cache_.end() &&
+          std::any_of(successors.begin(), successors.end(), [&](auto& kv) {
+            return overlaps(kv.second, range->second);
+          });
+      it = replaced ? open_shard_ids.erase(it) : std::next(it);
+    }
+    for (const auto& kv : successors) {
+      open_shard_ids.insert(kv.first);
+    }
+  }
+
+  auto snapshot = build_snapshot(open_shard_ids);
+  if (!snapshot) {
+    return false;
+  }
+  auto num_shards = snapshot->boundaries.size();
+  publish(std::move(snapshot));
+  updated_at_ = std::chrono::steady_clock::now();
+  store_in_cache();
+  LOG(info) << "Updated shard map for stream \"" << stream_
+            << "\" from cached hash key ranges. Found " << num_shards << " shards";
+  return true;
+}
+
 void ShardMap::list_shards(const Aws::String& next_token) {
   Aws::Kinesis::Model::ListShardsRequest req;
   req.SetMaxResults(1000);
@@ -128,7 +331,12 @@ void ShardMap::list_shards(const Aws::String& next_token) {
       req.SetStreamId(stream_id);
     }
     Aws::Kinesis::Model::ShardFilter shardFilter;
-    shardFilter.SetType(Aws::Kinesis::Model::ShardFilterType::AT_LATEST);
+    if (list_shards_after_) {
+      shardFilter.SetType(Aws::Kinesis::Model::ShardFilterType::AFTER_SHARD_ID);
+      shardFilter.SetShardId(shard_id_to_str(*list_shards_after_));
+    } else {
+      shardFilter.SetType(Aws::Kinesis::Model::ShardFilterType::AT_LATEST);
+    }
     req.SetShardFilter(shardFilter);
   }
   list_shards_callback_(
@@ -149,14 +357,33 @@ void ShardMap::list_shards_callback(
   auto& shards = outcome.GetResult().GetShards();  
 
   {
-    WriteLock lock(shard_cache_mutex_);
+    WriteLock lock(mutex_);
+    WriteLock cache_lock(shard_cache_mutex_);
     for (auto& shard : shards) {
       const auto& range = shard.GetHashKeyRange();
       const auto& hashkey_start = uint128_t(range.GetStartingHashKey());
       const auto& hashkey_end = uint128_t(range.GetEndingHashKey());
       const auto& shard_id = shard_id_from_str(shard.GetShardId());
-      end_hash_key_to_shard_id_.push_back({hashkey_end, shard_id});
-      open_shards_.insert({shard_id, shard});      
+      if (list_shards_after_) {
+        // AFTER_SHARD_ID also returns closed shards. Those, and the parents of
+        // every shard returned, no longer take records.
+        if (shard.GetSequenceNumberRange().GetEndingSequenceNumber().empty()) {
+          pending_open_shard_ids_.insert(shard_id);
+        } else {
+          pending_retired_shard_ids_.insert(shard_id);
+        }
+        if (!shard.GetParentShardId().empty()) {
+          pending_retired_shard_ids_.insert(
+              shard_id_from_str(shard.GetParentShardId()));
+        }
+        if (!shard.GetAdjacentParentShardId().empty()) {
+          pending_retired_shard_ids_.insert(
+              shard_id_from_str(shard.GetAdjacentParentShardId()));
+        }
+      } else {
+        pending_end_hash_key_to_shard_id_.push_back({hashkey_end, shard_id});
+        pending_open_shard_ids_.insert(shard_id);
+      }
       shard_id_to_shard_hashkey_cache_.insert({shard_id, {hashkey_start, hashkey_end}});
     }
   }
@@ -167,14 +394,27 @@ void ShardMap::list_shards_callback(
     return;
   }
 
-  sort_all_open_shards();
-
   WriteLock lock(mutex_);
+  if (list_shards_after_) {
+    list_shards_incremental_done();
+    return;
+  }
+  std::sort(pending_end_hash_key_to_shard_id_.begin(),
+            pending_end_hash_key_to_shard_id_.end());
+  auto snapshot = std::make_unique<Snapshot>();
+  snapshot->epoch = next_epoch_++;
+  snapshot->boundaries = ShardBoundaries(pending_end_hash_key_to_shard_id_);
+  snapshot->open_shard_ids = std::move(pending_open_shard_ids_);
+  pending_end_hash_key_to_shard_id_.clear();
+  pending_open_shard_ids_.clear();
+  auto num_shards = snapshot->boundaries.size();
+  publish(std::move(snapshot));
   state_ = READY;
   updated_at_ = std::chrono::steady_clock::now();
+  store_in_cache();
   LOG(info) << "Successfully updated shard map for stream \""
             << stream_ << (stream_arn_.empty() ? "\"" : "\" (arn: \"" + stream_arn_ + "\"). Found ")
-            << end_hash_key_to_shard_id_.size() << " shards";
+            << num_shards << " shards";
 }
 
 void ShardMap::update_fail(const std::string &code, const std::string &msg) {
@@ -188,8 +428,10 @@ void ShardMap::update_fail(const std::string &code, const std::string &msg) {
 
   if (!scheduled_callback_) {
     scheduled_callback_ =
-        executor_->schedule([
-            this] { this->update(); },
+        executor_->schedule([this] {
+              WriteLock lock(mutex_);
+              this->update();
+            },
             backoff_);
   } else {
     scheduled_callback_->reschedule(backoff_);
@@ -198,43 +440,127 @@ void ShardMap::update_fail(const std::string &code, const std::string &msg) {
   backoff_ = std::min(backoff_ * 3 / 2, max_backoff_);
 }
 
-void ShardMap::clear_all_stored_shards() {
-  end_hash_key_to_shard_id_.clear();
-  open_shards_.clear();
+// Merges the shards found by an incremental update into the current snapshot.
+// Must be called with the write lock held.
+void ShardMap::list_shards_incremental_done() {
+  auto open_shard_ids = snapshot_->open_shard_ids;
+  open_shard_ids.insert(pending_open_shard_ids_.begin(),
+                        pending_open_shard_ids_.end());
+  for (auto id : pending_retired_shard_ids_) {
+    open_shard_ids.erase(id);
+  }
+  pending_open_shard_ids_.clear();
+  pending_retired_shard_ids_.clear();
+  list_shards_after_ = boost::none;
+
+  auto snapshot = build_snapshot(open_shard_ids);
+  if (!snapshot) {
+    LOG(warning) << "Incremental shard map update for stream \"" << stream_
+                 << "\" did not produce a consistent shard map; falling back"
+                 << " to a full update";
+    state_ = INVALID;
+    update();
+    return;
+  }
+  auto num_shards = snapshot->boundaries.size();
+  publish(std::move(snapshot));
+  state_ = READY;
+  updated_at_ = std::chrono::steady_clock::now();
+  store_in_cache();
+  LOG(info) << "Successfully updated shard map for stream \"" << stream_
+            << "\" incrementally. Found " << num_shards << " shards";
 }
 
-void ShardMap::sort_all_open_shards() {
-  std::sort(end_hash_key_to_shard_id_.begin(),
-          end_hash_key_to_shard_id_.end());
+// Builds a snapshot of the given shards from their cached hash key ranges.
+// Returns nullptr unless the ranges cover the whole hash key space exactly
+// once. Must be called with the write lock held.
+std::unique_ptr<ShardMap::Snapshot> ShardMap::build_snapshot(
+    const std::unordered_set<uint64_t>& open_shard_ids) {
+  // (starting hash key, ending hash key, shard id)
+  std::vector<std::tuple<uint128_t, uint128_t, uint64_t>> ranges;
+  {
+    ReadLock lock(shard_cache_mutex_);
+    for (auto id : open_shard_ids) {
+      const auto it = shard_id_to_shard_hashkey_cache_.find(id);
+      if (it == shard_id_to_shard_hashkey_cache_.end()) {
+        return nullptr;
+      }
+      ranges.emplace_back(it->second.first, it->second.second, id);
+    }
+  }
+  std::sort(ranges.begin(), ranges.end());
+
+  std::vector<std::pair<uint128_t, uint64_t>> end_hash_key_to_shard_id;
+  uint128_t next_start = 0;
+  bool covered = false;
+  for (const auto& r : ranges) {
+    if (covered || std::get<0>(r) != next_start) {
+      return nullptr;
+    }
+    covered = std::get<1>(r) == std::numeric_limits<uint128_t>::max();
+    next_start = std::get<1>(r) + 1;
+    end_hash_key_to_shard_id.emplace_back(std::get<1>(r), std::get<2>(r));
+  }
+  if (!covered) {
+    return nullptr;
+  }
+
+  auto snapshot = std::make_unique<Snapshot>();
+  snapshot->epoch = next_epoch_++;
+  snapshot->boundaries = ShardBoundaries(end_hash_key_to_shard_id);
+  snapshot->open_shard_ids = open_shard_ids;
+  return snapshot;
+}
+
+// Must be called with the write lock held.
+void ShardMap::publish(std::unique_ptr<Snapshot> snapshot) {
+  auto previous = std::move(snapshot_);
+  snapshot_ = std::move(snapshot);
+  current_ = snapshot_.get();
+  if (previous) {
+    wait_for_readers();
+  }
+}
+
+// Waits until no reader can still be looking at a snapshot that was replaced
+// before this call. Readers register on the active side of readers_, so we flip
+// the active side and wait for the inactive one to drain. This is done twice,
+// because a reader may have picked its side just before the previous flip.
+void ShardMap::wait_for_readers() {
+  for (int i = 0; i < 2; i++) {
+    auto side = reader_side_.fetch_xor(1);
+    while (readers_[side] != 0) {
+      aws::this_thread::yield();
+    }
+  }
 }
 
 void ShardMap::cleanup() {
-  while (true) {
-    try {
-      std::this_thread::sleep_for(closed_shard_ttl_ / 2); 
-      const auto now = std::chrono::steady_clock::now();   
-      // readlock on the main mutex and the state_ check ensures that we are not runing list shards so it's safe to
-      // clean up the map.
-      ReadLock lock(mutex_);
-      // if it's been a while since the last shardmap update, we can remove the unused closed shards.
-      if (updated_at_ + closed_shard_ttl_ < now && state_ == READY) {
-        if (open_shards_.size() != shard_id_to_shard_hashkey_cache_.size()) {
-          WriteLock lock(shard_cache_mutex_);
-          for (auto it = shard_id_to_shard_hashkey_cache_.begin(); it != shard_id_to_shard_hashkey_cache_.end();) {
-            if (open_shards_.count(it->first) == 0) {
-              it = shard_id_to_shard_hashkey_cache_.erase(it);
-            } else {
-              ++it;
-            }
+  try {
+    const auto now = std::chrono::steady_clock::now();   
+    // readlock on the main mutex and the state_ check ensures that we are not runing list shards so it's safe to
+    // clean up the map.
+    ReadLock lock(mutex_);
+    // if it's been a while since the last shardmap update, we can remove the unused closed shards.
+    if (updated_at_ + closed_shard_ttl_ < now && state_ == READY) {
+      auto& open_shard_ids = snapshot_->open_shard_ids;
+      if (open_shard_ids.size() != shard_id_to_shard_hashkey_cache_.size()) {
+        WriteLock lock(shard_cache_mutex_);
+        for (auto it = shard_id_to_shard_hashkey_cache_.begin(); it != shard_id_to_shard_hashkey_cache_.end();) {
+          if (open_shard_ids.count(it->first) == 0) {
+            it = shard_id_to_shard_hashkey_cache_.erase(it);
+          } else {
+            ++it;
           }
-        } 
-      }
-    } catch (const std::exception &e) {
-      LOG(error) << "Exception occurred while cleaning up shardmap cache : " << e.what();
-    } catch (...) {
-      LOG(error) << "Unknown exception while cleaning up shardmap cache.";
+        }
+      } 
     }
+  } catch (const std::exception &e) {
+    LOG(error) << "Exception occurred while cleaning up shardmap cache : " << e.what();
+  } catch (...) {
+    LOG(error) << "Unknown exception while cleaning up shardmap cache.";
   }
+  scheduled_cleanup_->reschedule(closed_shard_ttl_ / 2);
 }
 
 } //namespace core
@@ -20,13 +20,19 @@
 #include <boost/noncopyable.hpp>
 #include <boost/optional.hpp>
 #include <boost/optional/optional_io.hpp>
+#include <boost/utility/string_ref.hpp>
 
 #include <aws/kinesis/KinesisClient.h>
 #include <aws/kinesis/model/Shard.h>
+#include <aws/kinesis/core/shard_boundaries.h>
+#include <aws/kinesis/core/shard_map_cache.h>
 #include <aws/metrics/metrics_manager.h>
 #include <aws/mutex.h>
 #include <aws/utils/utils.h>
-#include <thread>
+#include <array>
+#include <atomic>
+#include <stdexcept>
+#include <unordered_set>
 
 namespace aws {
 namespace kinesis {
@@ -44,6 +50,13 @@ class ShardMap : boost::noncopyable {
   
   using StreamIdGetter = std::function<std::string(const std::string&)>;
 
+  static const std::chrono::milliseconds kMinBackoff;
+  static const std::chrono::milliseconds kMaxBackoff;
+  static const std::chrono::milliseconds kClosedShardTtl;
+
+  // If a cache is given and holds a fresh shard map, the shard map starts out
+  // ready with it and is refreshed from Kinesis in the background. Every
+  // successful update is written back to the cache.
   ShardMap(std::shared_ptr<aws::utils::Executor> executor,
            ListShardsCallBack list_shards_callback,
            std::string stream,
@@ -53,16 +66,59 @@ class ShardMap : boost::noncopyable {
               = std::make_shared<aws::metrics::NullMetricsManager>(),
            std::chrono::milliseconds min_backoff = kMinBackoff,
            std::chrono::milliseconds max_backoff = kMaxBackoff,
-           std::chrono::milliseconds closed_shard_ttl = kClosedShardTtl);
+           std::chrono::milliseconds closed_shard_ttl = kClosedShardTtl,
+           std::shared_ptr<ShardMapCache> cache = nullptr);
 
+  virtual ~ShardMap();
+
+  // Never blocks. While an update is in progress, lookups keep being answered
+  // from the last complete snapshot of the shard map.
   virtual boost::optional<uint64_t> shard_id(const uint128_t& hash_key);
-  boost::optional<std::pair<uint128_t, uint128_t>> hashrange(const uint64_t& shard_id);
 
-  void invalidate(const TimePoint& seen_at, const boost::optional<uint64_t> predicted_shard);
+  // Batch version of shard_id(); the result at index i is the shard for
+  // hash_keys[i]. All keys are looked up in the same snapshot.
+  std::vector<boost::optional<uint64_t>>
+  shard_ids(const std::vector<uint128_t>& hash_keys);
+
+  boost::optional<std::pair<uint128_t, uint128_t>> hashrange(const uint64_t& shard_id);
 
-  static uint64_t shard_id_from_str(const std::string& shard_id) {
-    auto parts = aws::utils::split_on_first(shard_id, "-");
-    return std::stoull(parts.at(1));
+  // Identifies the snapshot currently used by shard_id(). It increases every
+  // time a new shard map is published, so anything cached from an earlier
+  // lookup can be validated against it. 0 means no shard map is available yet.
+  uint64_t epoch();
+
+  // Called when a record landed in a shard other than the predicted one. If
+  // the actual shard is newer than the predicted one, the predicted shard was
+  // most likely split or merged, and only the shards created since the last
+  // update are fetched and patched into the map. Anything else triggers a full
+  // update.
+  void invalidate(const TimePoint& seen_at,
+                  const boost::optional<uint64_t> predicted_shard,
+                  const boost::optional<uint64_t> actual_shard = boost::none);
+
+  // Reads the number out of a shard id such as "shardId-000000000001".
+  // Throws std::out_of_range if there's no '-', and std::invalid_argument if
+  // what follows it doesn't start with a digit.
+  static uint64_t shard_id_from_str(boost::string_ref shard_id) {
+    auto dash = shard_id.find('-');
+    if (dash == boost::string_ref::npos) {
+      throw std::out_of_range("No '-' in shard id " + shard_id.to_string());
+    }
+    size_t i = dash + 1;
+    if (i == shard_id.size() || shard_id[i] < '0' || shard_id[i] > '9') {
+      throw std::invalid_argument("Bad shard id " + shard_id.to_string());
+    }
+    uint64_t id = 0;
+    for (; i < shard_id.size() && shard_id[i] >= '0' && shard_id[i] <= '9';
+         i++) {
+      uint64_t digit = shard_id[i] - '0';
+      if (id > (UINT64_MAX - digit) / 10) {
+        throw std::out_of_range("Shard id out of range " +
+                                shard_id.to_string());
+      }
+      id = id * 10 + digit;
+    }
+    return id;
   }
 
   static std::string shard_id_to_str(uint64_t id) {
@@ -85,18 +141,49 @@ class ShardMap : boost::noncopyable {
     READY
   };
 
-  static const std::chrono::milliseconds kMinBackoff;
-  static const std::chrono::milliseconds kMaxBackoff;
-  static const std::chrono::milliseconds kClosedShardTtl;
+  // An immutable view of the shard map. Once published, a snapshot is never
+  // modified; updates build a new one on the side and swap it in when it is
+  // complete.
+  struct Snapshot {
+    uint64_t epoch = 0;
+    ShardBoundaries boundaries;
+    std::unordered_set<uint64_t> open_shard_ids;
+  };
+
+  // Announces a reader on the currently active side of the grace period
+  // counters, so that a writer doesn't free the snapshot being read.
+  class ReaderGuard : boost::noncopyable {
+   public:
+    explicit ReaderGuard(ShardMap& shard_map)
+        : readers_(shard_map.readers_[shard_map.reader_side_.load()]) {
+      readers_++;
+    }
+
+    ~ReaderGuard() {
+      readers_--;
+    }
+
+   private:
+    std::atomic<uint64_t>& readers_;
+  };
+
+  static const std::chrono::milliseconds kMaxCacheRevalidationDelay;
 
+  bool start_from_cache();
+  void store_in_cache();
   void update();
+  void update_incremental(uint64_t predicted_shard);
+  bool update_from_cache(uint64_t predicted_shard);
   void list_shards(const std::string& next_token = "");
   void list_shards_callback(const Aws::Kinesis::Model::ListShardsOutcome& outcome);
+  void list_shards_incremental_done();
 
   void update_fail(const std::string& code, const std::string& msg = "");
 
-  void clear_all_stored_shards();
-  void sort_all_open_shards();
+  std::unique_ptr<Snapshot> build_snapshot(
+      const std::unordered_set<uint64_t>& open_shard_ids);
+  void publish(std::unique_ptr<Snapshot> snapshot);
+  void wait_for_readers();
   void cleanup();
 
   std::shared_ptr<aws::utils::Executor> executor_;
@@ -105,8 +192,16 @@ class ShardMap : boost::noncopyable {
   StreamIdGetter stream_id_getter_;
   std::shared_ptr<aws::metrics::MetricsManager> metrics_manager_;
   State state_;
-  std::vector<std::pair<uint128_t, uint64_t>> end_hash_key_to_shard_id_;
-  std::unordered_map<uint64_t, Aws::Kinesis::Model::Shard> open_shards_;
+  std::unique_ptr<Snapshot> snapshot_;
+  std::vector<std::pair<uint128_t, uint64_t>> pending_end_hash_key_to_shard_id_;
+  std::unordered_set<uint64_t> pending_open_shard_ids_;
+  std::unordered_set<uint64_t> pending_retired_shard_ids_;
+  // Set while an incremental update is listing the shards after this one.
+  boost::optional<uint64_t> list_shards_after_;
+  std::atomic<const Snapshot*> current_{nullptr};
+  std::array<std::atomic<uint64_t>, 2> readers_{};
+  std::atomic<size_t> reader_side_{0};
+  uint64_t next_epoch_ = 1;
   std::unordered_map<uint64_t, std::pair<uint128_t, uint128_t>> shard_id_to_shard_hashkey_cache_;
   
   Mutex mutex_;
@@ -117,7 +212,9 @@ class ShardMap : boost::noncopyable {
   std::chrono::milliseconds backoff_;
   std::chrono::milliseconds closed_shard_ttl_;
   std::shared_ptr<aws::utils::ScheduledCallback> scheduled_callback_;
+  std::shared_ptr<aws::utils::ScheduledCallback> scheduled_cleanup_;
   ListShardsCallBack list_shards_callback_;
+  std::shared_ptr<ShardMapCache> cache_;
 };
 
 } //namespace core
@@ -0,0 +1,170 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstring>
+#include <fstream>
+
+#include <aws/kinesis/core/shard_map_cache.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <aws/utils/logging.h>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+namespace {
+
+// Layout of the file, all fields native-endian uint64:
+//   magic, written_at (ms since the epoch), number of shards, checksum,
+//   then per shard: id, starting key (high, low), ending key (high, low).
+const uint64_t kMagic = 0x314d53534c504b00; // "\0KPLSSM1"
+const size_t kHeaderFields = 4;
+const size_t kShardFields = 5;
+
+uint64_t high(const ShardMapCache::uint128_t& v) {
+  return static_cast<uint64_t>(v >> 64);
+}
+
+uint64_t low(const ShardMapCache::uint128_t& v) {
+  return static_cast<uint64_t>(v & ShardMapCache::uint128_t(UINT64_MAX));
+}
+
+ShardMapCache::uint128_t join(uint64_t high, uint64_t low) {
+  return (ShardMapCache::uint128_t(high) << 64) | low;
+}
+
+// FNV-1a over the shard fields, to catch truncated or corrupted files.
+uint64_t checksum(const uint64_t* fields, size_t count) {
+  uint64_t hash = 0xcbf29ce484222325;
+  auto bytes = reinterpret_cast<const unsigned char*>(fields);
+  for (size_t i = 0; i < count * sizeof(uint64_t); i++) {
+    hash ^= bytes[i];
+    hash *= 0x100000001b3;
+  }
+  return hash;
+}
+
+} //namespace
+
+boost::optional<ShardMapCache::Contents> ShardMapCache::load() const {
+  namespace bip = boost::interprocess;
+
+  boost::system::error_code ec;
+  if (!boost::filesystem::exists(path_, ec)) {
+    return boost::none;
+  }
+
+  try {
+    bip::file_mapping file(path_.c_str(), bip::read_only);
+    bip::mapped_region region(file, bip::read_only);
+
+    const auto size = region.get_size();
+    if (size < kHeaderFields * sizeof(uint64_t) || size % sizeof(uint64_t)) {
+      LOG(warning) << "Ignoring shard map cache " << path_ << ": bad size";
+      return boost::none;
+    }
+    std::vector<uint64_t> fields(size / sizeof(uint64_t));
+    std::memcpy(fields.data(), region.get_address(), size);
+
+    const auto num_shards = fields[2];
+    if (fields[0] != kMagic ||
+        fields.size() != kHeaderFields + num_shards * kShardFields ||
+        fields[3] != checksum(&fields[kHeaderFields],
+                              num_shards * kShardFields)) {
+      LOG(warning) << "Ignoring shard map cache " << path_ << ": corrupted";
+      return boost::none;
+    }
+
+    Contents contents;
+    contents.written_at = std::chrono::system_clock::time_point(
+        std::chrono::milliseconds(fields[1]));
+    const auto now = std::chrono::system_clock::now();
+    if (contents.written_at > now || contents.written_at + ttl_ < now) {
+      LOG(info) << "Ignoring shard map cache " << path_ << ": expired";
+      return boost::none;
+    }
+
+    contents.shards.reserve(num_shards);
+    for (size_t i = kHeaderFields; i < fields.size(); i += kShardFields) {
+      contents.shards.push_back({
+          fields[i],
+          join(fields[i + 1], fields[i + 2]),
+          join(fields[i + 3], fields[i + 4])});
+    }
+    return contents;
+  } catch (const std::exception& e) {
+    LOG(warning) << "Could not read shard map cache " << path_ << ": "
+                 << e.what();
+    return boost::none;
+  }
+}
+
+void ShardMapCache::store(const std::vector<Shard>& shards) const {
+  std::vector<uint64_t> fields;
+  fields.reserve(kHeaderFields + shards.size() * kShardFields);
+  fields.push_back(kMagic);
+  fields.push_back(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch()).count());
+  fields.push_back(shards.size());
+  fields.push_back(0);
+  for (const auto& s : shards) {
+    fields.push_back(s.shard_id);
+    fields.push_back(high(s.starting_hash_key));
+    fields.push_back(low(s.starting_hash_key));
+    fields.push_back(high(s.ending_hash_key));
+    fields.push_back(low(s.ending_hash_key));
+  }
+  fields[3] = checksum(&fields[kHeaderFields], shards.size() * kShardFields);
+
+  try {
+    const boost::filesystem::path path(path_);
+    if (path.has_parent_path()) {
+      boost::filesystem::create_directories(path.parent_path());
+    }
+    auto tmp = path;
+    tmp += boost::filesystem::unique_path(".%%%%-%%%%-%%%%.tmp");
+    {
+      std::ofstream out(tmp.string(), std::ios::binary | std::ios::trunc);
+      out.write(reinterpret_cast<const char*>(fields.data()),
+                fields.size() * sizeof(uint64_t));
+      out.close();
+      if (!out) {
+        boost::system::error_code ec;
+        boost::filesystem::remove(tmp, ec);
+        LOG(warning) << "Could not write shard map cache " << tmp.string();
+        return;
+      }
+    }
+    boost::system::error_code ec;
+    boost::filesystem::rename(tmp, path, ec);
+    if (ec) {
+      LOG(warning) << "Could not write shard map cache " << path_ << ": "
+                   << ec.message();
+      boost::filesystem::remove(tmp, ec);
+    }
+  } catch (const std::exception& e) {
+    LOG(warning) << "Could not write shard map cache " << path_ << ": "
+                 << e.what();
+  }
+}
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_KINESIS_CORE_SHARD_MAP_CACHE_H_
+#define AWS_KINESIS_CORE_SHARD_MAP_CACHE_H_
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <boost/multiprecision/cpp_int.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+// Keeps the last known shard map of a stream in a file, so that a restarted
+// daemon can start aggregating right away instead of waiting for ListShards.
+//
+// The file is written to a temporary file and renamed into place, so readers
+// never see a partially written map, and it is memory-mapped when read.
+// Failures are logged and otherwise ignored; the cache is only an
+// optimization.
+class ShardMapCache : boost::noncopyable {
+ public:
+  using uint128_t = boost::multiprecision::uint128_t;
+
+  struct Shard {
+    uint64_t shard_id;
+    uint128_t starting_hash_key;
+    uint128_t ending_hash_key;
+  };
+
+  struct Contents {
+    std::chrono::system_clock::time_point written_at;
+    std::vector<Shard> shards;
+  };
+
+  ShardMapCache(std::string path, std::chrono::milliseconds ttl)
+      : path_(std::move(path)),
+        ttl_(ttl) {}
+
+  // Returns the cached shards, or none if the file is missing, malformed or
+  // older than the ttl.
+  boost::optional<Contents> load() const;
+
+  void store(const std::vector<Shard>& shards) const;
+
+  const std::string& path() const noexcept {
+    return path_;
+  }
+
+  std::chrono::milliseconds ttl() const noexcept {
+    return ttl_;
+  }
+
+ private:
+  std::string path_;
+  std::chrono::milliseconds ttl_;
+};
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
+
+#endif //AWS_KINESIS_CORE_SHARD_MAP_CACHE_H_
@@ -0,0 +1,408 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include <aws/kinesis/core/spill_log.h>
+
+#include <boost/filesystem.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <aws/utils/logging.h>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+namespace {
+
+namespace bip = boost::interprocess;
+namespace fs = boost::filesystem;
+
+// Each segment starts with a header of native-endian uint64 fields: magic,
+// write offset, read offset, reserved. Records follow, each a uint32 payload
+// length and uint32 checksum of the payload, then the payload: source id,
+// deadline and expiration (ms since the epoch) as uint64, lengths of the
+// partition key, explicit hash key and data as uint32, then those bytes.
+const uint64_t kMagic = 0x314c50534c504b00; // "\0KPLSPL1"
+const uint64_t kHeaderSize = 4 * sizeof(uint64_t);
+const uint64_t kFrameHeaderSize = 2 * sizeof(uint32_t);
+const uint64_t kPayloadFixedSize = 3 * sizeof(uint64_t) + 3 * sizeof(uint32_t);
+const char* kExtension = ".spill";
+
+// FNV-1a, to catch records torn by a crash or corrupted on disk.
+uint32_t checksum(const char* data, size_t len) {
+  uint32_t hash = 0x811c9dc5;
+  for (size_t i = 0; i < len; i++) {
+    hash ^= static_cast<unsigned char>(data[i]);
+    hash *= 0x01000193;
+  }
+  return hash;
+}
+
+int64_t to_millis(SpillLog::Clock::time_point tp) {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+      tp.time_since_epoch()).count();
+}
+
+SpillLog::Clock::time_point from_millis(int64_t ms) {
+  return SpillLog::Clock::time_point(
+      std::chrono::duration_cast<SpillLog::Clock::duration>(
+          std::chrono::milliseconds(ms)));
+}
+
+template <typename T>
+void write(char*& p, T v) {
+  std::memcpy(p, &v, sizeof(T));
+  p += sizeof(T);
+}
+
+void write(char*& p, const std::string& s) {
+  std::memcpy(p, s.data(), s.size());
+  p += s.size();
+}
+
+template <typename T>
+T read(const char*& p) {
+  T v;
+  std::memcpy(&v, p, sizeof(T));
+  p += sizeof(T);
+  return v;
+}
+
+std::string read(const char*& p, size_t len) {
+  std::string s(p, len);
+  p += len;
+  return s;
+}
+
+} //namespace
+
+struct SpillLog::Segment {
+  Segment(std::string path, bool recovered)
+      : path(std::move(path)),
+        recovered(recovered),
+        file(this->path.c_str(), bip::read_write),
+        region(file, bip::read_write) {}
+
+  uint64_t* header() {
+    return static_cast<uint64_t*>(region.get_address());
+  }
+
+  char* base() {
+    return static_cast<char*>(region.get_address());
+  }
+
+  uint64_t capacity() const {
+    return region.get_size();
+  }
+
+  uint64_t& write_offset() {
+    return header()[1];
+  }
+
+  uint64_t& read_offset() {
+    return header()[2];
+  }
+
+  bool exhausted() {
+    return read_offset() >= write_offset();
+  }
+
+  // Size of the record at offset, or 0 if there isn't a valid one.
+  uint64_t frame_size(uint64_t offset) {
+    if (offset + kFrameHeaderSize > write_offset()) {
+      return 0;
+    }
+    const char* p = base() + offset;
+    auto len = read<uint32_t>(p);
+    auto sum = read<uint32_t>(p);
+    if (len < kPayloadFixedSize ||
+        offset + kFrameHeaderSize + len > write_offset() ||
+        checksum(p, len) != sum) {
+      return 0;
+    }
+    return kFrameHeaderSize + len;
+  }
+
+  const std::string path;
+  // Written by an earlier run; nothing more is appended to it.
+  const bool recovered;
+  bip::file_mapping file;
+  bip::mapped_region region;
+};
+
+SpillLog::SpillLog(std::string dir,
+                   uint64_t max_bytes,
+                   bool keep,
+                   uint64_t segment_size)
+    : dir_(std::move(dir)),
+      max_bytes_(max_bytes),
+      keep_(keep),
+      segment_size_(segment_size) {
+  fs::create_directories(dir_);
+  recover();
+}
+
+SpillLog::~SpillLog() {
+  if (!keep_) {
+    delete_all();
+  }
+}
+
+bool SpillLog::append(const Entry& e) {
+  const uint64_t payload_size = kPayloadFixedSize + e.partition_key.size() +
+      e.explicit_hash_key.size() + e.data.size();
+  if (payload_size > UINT32_MAX) {
+    return false;
+  }
+  const uint64_t frame_size = kFrameHeaderSize + payload_size;
+
+  aws::lock_guard<aws::mutex> lk(mutex_);
+  Segment* s = segments_.empty() ? nullptr : segments_.back().get();
+  if (!s || s->recovered || s->write_offset() + frame_size > s->capacity()) {
+    auto capacity = std::max(segment_size_, kHeaderSize + frame_size);
+    if (disk_bytes_ + capacity > max_bytes_) {
+      return false;
+    }
+    try {
+      segments_.push_back(create_segment(capacity));
+    } catch (const std::exception& ex) {
+      LOG(error) << "Could not create spill segment in " << dir_ << ": "
+                 << ex.what();
+      return false;
+    }
+    disk_bytes_ += capacity;
+    s = segments_.back().get();
+  }
+
+  char* frame = s->base() + s->write_offset();
+  char* p = frame + kFrameHeaderSize;
+  write<uint64_t>(p, e.source_id);
+  write<int64_t>(p, to_millis(e.deadline));
+  write<int64_t>(p, to_millis(e.expiration));
+  write<uint32_t>(p, e.partition_key.size());
+  write<uint32_t>(p, e.explicit_hash_key.size());
+  write<uint32_t>(p, e.data.size());
+  write(p, e.partition_key);
+  write(p, e.explicit_hash_key);
+  write(p, e.data);
+
+  char* h = frame;
+  write<uint32_t>(h, payload_size);
+  write<uint32_t>(h, checksum(frame + kFrameHeaderSize, payload_size));
+  // Only now does the record become visible to a later run.
+  s->write_offset() += frame_size;
+  size_++;
+  return true;
+}
+
+bool SpillLog::take(Entry& e) {
+  aws::lock_guard<aws::mutex> lk(mutex_);
+  while (!segments_.empty()) {
+    auto& s = *segments_.front();
+    if (s.exhausted()) {
+      if (segments_.size() == 1 && !s.recovered) {
+        // Start over at the beginning rather than making a new segment.
+        s.write_offset() = kHeaderSize;
+        s.read_offset() = kHeaderSize;
+        size_ = 0;
+        return false;
+      }
+      auto path = s.path;
+      disk_bytes_ -= s.capacity();
+      segments_.pop_front();
+      boost::system::error_code ec;
+      fs::remove(path, ec);
+      continue;
+    }
+
+    auto frame_size = s.frame_size(s.read_offset());
+    if (frame_size == 0) {
+      // Segments are checked when recovered, and this run's are only written
+      // by us, so this means the file was modified underneath us.
+      LOG(error) << "Dropping corrupted records in " << s.path;
+      s.read_offset() = s.write_offset();
+      continue;
+    }
+
+    const char* p = s.base() + s.read_offset() + kFrameHeaderSize;
+    e.source_id = read<uint64_t>(p);
+    e.deadline = from_millis(read<int64_t>(p));
+    e.expiration = from_millis(read<int64_t>(p));
+    auto partition_key_len = read<uint32_t>(p);
+    auto explicit_hash_key_len = read<uint32_t>(p);
+    auto data_len = read<uint32_t>(p);
+    if (kPayloadFixedSize + partition_key_len + explicit_hash_key_len +
+            data_len != frame_size - kFrameHeaderSize) {
+      LOG(error) << "Dropping corrupted records in " << s.path;
+      s.read_offset() = s.write_offset();
+      continue;
+    }
+    e.partition_key = read(p, partition_key_len);
+    e.explicit_hash_key = read(p, explicit_hash_key_len);
+    e.data = read(p, data_len);
+    e.recovered = s.recovered;
+
+    s.read_offset() += frame_size;
+    if (size_ > 0) {
+      size_--;
+    }
+    return true;
+  }
+  // Also resets the count after dropping corrupted records.
+  size_ = 0;
+  return false;
+}
+
+bool SpillLog::empty() const {
+  return size_ == 0;
+}
+
+size_t SpillLog::size() const {
+  return size_;
+}
+
+std::unique_ptr<SpillLog::Segment> SpillLog::create_segment(
+    uint64_t capacity) {
+  std::stringstream name;
+  name << std::setw(20) << std::setfill('0') << next_seq_++ << kExtension;
+  auto path = (fs::path(dir_) / name.str()).string();
+
+  // Write the whole file out instead of just setting its size, so that a full
+  // disk fails here rather than with SIGBUS when the mapping is written to.
+  {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    std::vector<char> zeros(std::min<uint64_t>(capacity, 1024 * 1024), 0);
+    for (uint64_t written = 0; written < capacity && out;
+         written += zeros.size()) {
+      out.write(zeros.data(),
+                std::min<uint64_t>(zeros.size(), capacity - written));
+    }
+    out.close();
+    if (!out) {
+      boost::system::error_code ec;
+      fs::remove(path, ec);
+      throw std::runtime_error("Could not write " + path);
+    }
+  }
+
+  std::unique_ptr<Segment> s(new Segment(path, false));
+  s->header()[0] = kMagic;
+  s->header()[3] = 0;
+  s->write_offset() = kHeaderSize;
+  s->read_offset() = kHeaderSize;
+  return s;
+}
+
+// Picks up the segments of an earlier run, in the order they were written.
+// Records that don't check out, and everything after them in the same
+// segment, are dropped.
+void SpillLog::recover() {
+  std::vector<std::pair<uint64_t, std::string>> files;
+  for (auto& entry : fs::directory_iterator(dir_)) {
+    auto path = entry.path();
+    if (path.extension() != kExtension) {
+      continue;
+    }
+    try {
+      files.emplace_back(std::stoull(path.stem().string()), path.string());
+    } catch (const std::exception&) {
+      LOG(warning) << "Ignoring unexpected file " << path.string()
+                   << " in spill directory";
+    }
+  }
+  std::sort(files.begin(), files.end());
+
+  for (auto& f : files) {
+    next_seq_ = std::max(next_seq_, f.first + 1);
+    boost::system::error_code ec;
+    if (!keep_ || fs::file_size(f.second, ec) < kHeaderSize) {
+      fs::remove(f.second, ec);
+      continue;
+    }
+
+    std::unique_ptr<Segment> s;
+    try {
+      s.reset(new Segment(f.second, true));
+    } catch (const std::exception& ex) {
+      LOG(warning) << "Could not open spill segment " << f.second << ": "
+                   << ex.what();
+      continue;
+    }
+
+    auto read_offset = s->read_offset();
+    if (s->header()[0] != kMagic ||
+        read_offset < kHeaderSize ||
+        read_offset > s->write_offset() ||
+        s->write_offset() > s->capacity()) {
+      LOG(warning) << "Deleting corrupted spill segment " << f.second;
+      s.reset();
+      fs::remove(f.second, ec);
+      continue;
+    }
+
+    size_t count = 0;
+    auto offset = read_offset;
+    while (offset < s->write_offset()) {
+      auto frame_size = s->frame_size(offset);
+      if (frame_size == 0) {
+        LOG(warning) << "Dropping corrupted records at offset " << offset
+                     << " of " << f.second;
+        s->write_offset() = offset;
+        break;
+      }
+      offset += frame_size;
+      count++;
+    }
+
+    if (count == 0) {
+      s.reset();
+      fs::remove(f.second, ec);
+      continue;
+    }
+
+    LOG(info) << "Recovered " << count << " spilled records from "
+              << f.second;
+    disk_bytes_ += s->capacity();
+    size_ += count;
+    segments_.push_back(std::move(s));
+  }
+}
+
+void SpillLog::delete_all() {
+  aws::lock_guard<aws::mutex> lk(mutex_);
+  std::vector<std::string> paths;
+  for (auto& s : segments_) {
+    paths.push_back(s->path);
+  }
+  segments_.clear();
+  boost::system::error_code ec;
+  for (auto& path : paths) {
+    fs::remove(path, ec);
+  }
+  // Only succeeds if nothing else is in there.
+  fs::remove(dir_, ec);
+}
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
@@ -0,0 +1,117 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_KINESIS_CORE_SPILL_LOG_H_
+#define AWS_KINESIS_CORE_SPILL_LOG_H_
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include <boost/noncopyable.hpp>
+
+#include <aws/mutex.h>
+
+namespace aws {
+namespace kinesis {
+namespace core {
+
+// Append-only log of user records for one stream, used to hold records on
+// disk instead of in memory while the stream can't keep up.
+//
+// The log is a directory of fixed size segment files that are memory-mapped
+// while in use. Records are taken back out in the order they were appended,
+// and a segment is deleted once all its records have been taken. Since the
+// data lives in the page cache as soon as it is written, a log kept across
+// restarts survives the daemon crashing, but not the host.
+//
+// All methods are thread safe.
+class SpillLog : boost::noncopyable {
+ public:
+  using Clock = std::chrono::system_clock;
+
+  struct Entry {
+    uint64_t source_id = 0;
+    std::string partition_key;
+    // Empty if the record has none.
+    std::string explicit_hash_key;
+    std::string data;
+    Clock::time_point deadline;
+    Clock::time_point expiration;
+    // Written by an earlier run of the daemon.
+    bool recovered = false;
+  };
+
+  static constexpr const uint64_t kDefaultSegmentSize = 8 * 1024 * 1024;
+
+  // Opens the log in dir, creating the directory if needed. Segments left
+  // there by an earlier run are kept and their records taken first if keep is
+  // true, and deleted otherwise. Throws if the directory can't be created.
+  //
+  // The segments take up at most max_bytes of disk. Records larger than a
+  // segment get a segment of their own.
+  SpillLog(std::string dir,
+           uint64_t max_bytes,
+           bool keep,
+           uint64_t segment_size = kDefaultSegmentSize);
+
+  // Deletes the segments unless the log is kept across restarts.
+  ~SpillLog();
+
+  // Returns false if the log is full or the record could not be written.
+  bool append(const Entry& e);
+
+  // Takes the oldest record. Returns false if there is none.
+  bool take(Entry& e);
+
+  bool empty() const;
+
+  // Records appended but not yet taken.
+  size_t size() const;
+
+  const std::string& dir() const noexcept {
+    return dir_;
+  }
+
+ private:
+  struct Segment;
+
+  std::unique_ptr<Segment> create_segment(uint64_t capacity);
+
+  void recover();
+
+  void delete_all();
+
+  const std::string dir_;
+  const uint64_t max_bytes_;
+  const bool keep_;
+  const uint64_t segment_size_;
+
+  aws::mutex mutex_;
+  // Records are read from the front and appended to the back.
+  std::deque<std::unique_ptr<Segment>> segments_;
+  uint64_t next_seq_ = 0;
+  uint64_t disk_bytes_ = 0;
+  // Read without the lock, so that checking for an empty log is cheap.
+  std::atomic<size_t> size_{0};
+};
+
+} //namespace core
+} //namespace kinesis
+} //namespace aws
+
+#endif //AWS_KINESIS_CORE_SPILL_LOG_H_
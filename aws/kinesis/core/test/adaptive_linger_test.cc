@@ -0,0 +1,98 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <aws/kinesis/core/adaptive_linger.h>
+
+namespace {
+
+using Linger = aws::kinesis::core::AdaptiveLinger;
+
+const auto kMaxWait = std::chrono::milliseconds(100);
+
+// Feeds n records of the given size spaced gap apart, returning the wait
+// chosen for the last.
+Linger::Clock::duration feed(Linger& linger,
+                             Linger::TimePoint& now,
+                             size_t n,
+                             std::chrono::microseconds gap,
+                             size_t bytes = 100,
+                             size_t count_limit = 1000000) {
+  Linger::Clock::duration wait;
+  for (size_t i = 0; i < n; i++) {
+    now += gap;
+    wait = linger.arrived(bytes, count_limit, 51200, kMaxWait, now);
+  }
+  return wait;
+}
+
+double millis(Linger::Clock::duration d) {
+  return std::chrono::duration<double, std::milli>(d).count();
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(AdaptiveLinger)
+
+BOOST_AUTO_TEST_CASE(FirstRecord) {
+  Linger linger;
+  BOOST_CHECK(linger.arrived(100, 1000, 51200, kMaxWait) == kMaxWait);
+}
+
+BOOST_AUTO_TEST_CASE(ColdShard) {
+  Linger linger;
+  auto now = Linger::Clock::now();
+  // Records a second apart would never share an aggregated record.
+  auto wait = feed(linger, now, 10, std::chrono::seconds(1));
+  BOOST_CHECK(wait == Linger::Clock::duration::zero());
+}
+
+BOOST_AUTO_TEST_CASE(HotShard) {
+  Linger linger;
+  auto now = Linger::Clock::now();
+  // 512 records of 100 bytes fill an aggregated record in about 5ms.
+  auto wait = feed(linger, now, 50, std::chrono::microseconds(10));
+  BOOST_CHECK_CLOSE(millis(wait), 2 * 512 * 0.01, 1);
+
+  // Filled by count first.
+  wait = feed(linger, now, 50, std::chrono::microseconds(10), 100, 10);
+  BOOST_CHECK_CLOSE(millis(wait), 2 * 10 * 0.01, 1);
+}
+
+BOOST_AUTO_TEST_CASE(WarmShard) {
+  Linger linger;
+  auto now = Linger::Clock::now();
+  // A record every 10ms won't fill an aggregated record in time, but waiting
+  // still gets several records into it.
+  auto wait = feed(linger, now, 50, std::chrono::milliseconds(10));
+  BOOST_CHECK(wait == kMaxWait);
+}
+
+BOOST_AUTO_TEST_CASE(Recovers) {
+  Linger linger;
+  auto now = Linger::Clock::now();
+  feed(linger, now, 10, std::chrono::microseconds(10));
+
+  // One long pause doesn't make the shard cold, since it counts for no more
+  // than twice the longest wait.
+  auto wait = feed(linger, now, 1, std::chrono::hours(1));
+  BOOST_CHECK(wait == kMaxWait);
+
+  wait = feed(linger, now, 100, std::chrono::microseconds(10));
+  BOOST_CHECK_CLOSE(millis(wait), 2 * 512 * 0.01, 5);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
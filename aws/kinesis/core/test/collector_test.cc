@@ -0,0 +1,263 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <aws/kinesis/core/collector.h>
+#include <aws/kinesis/core/test/test_utils.h>
+#include <aws/utils/io_service_executor.h>
+#include <aws/utils/utils.h>
+
+namespace {
+
+using Requests =
+    std::vector<std::shared_ptr<aws::kinesis::core::PutRecordsRequest>>;
+
+auto make_kinesis_record(uint64_t shard_id) {
+  auto ur = aws::kinesis::test::make_user_record();
+  ur->predicted_shard(shard_id);
+  auto kr = std::make_shared<aws::kinesis::core::KinesisRecord>();
+  kr->add(ur);
+  return kr;
+}
+
+struct Fixture {
+  Fixture(size_t collection_max_count, uint64_t shard_max_in_flight)
+      : config(std::make_shared<aws::kinesis::core::Configuration>()),
+        flush_stats("Test", "KinesisRecords", "PutRecordsRequests") {
+    config->collection_max_count(collection_max_count);
+    config->shard_max_in_flight(shard_max_in_flight);
+    collector = std::make_shared<aws::kinesis::core::Collector>(
+        std::make_shared<aws::utils::IoServiceExecutor>(1),
+        [this](auto prr) { this->flushed.push_back(prr); },
+        [this](auto& kr) {
+          aws::lock_guard<aws::mutex> lk(this->expired_mutex);
+          this->expired.push_back(kr);
+        },
+        config,
+        flush_stats);
+  }
+
+  size_t expired_count() {
+    aws::lock_guard<aws::mutex> lk(expired_mutex);
+    return expired.size();
+  }
+
+  void complete(
+      const std::shared_ptr<aws::kinesis::core::PutRecordsRequest>& prr) {
+    collector->request_completed(collector->shards(prr->items()));
+  }
+
+  std::shared_ptr<aws::kinesis::core::Configuration> config;
+  aws::utils::flush_statistics_aggregator flush_stats;
+  std::shared_ptr<aws::kinesis::core::Collector> collector;
+  Requests flushed;
+  aws::mutex expired_mutex;
+  std::vector<std::shared_ptr<aws::kinesis::core::KinesisRecord>> expired;
+};
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(Collector)
+
+BOOST_AUTO_TEST_CASE(NoShardLimit) {
+  Fixture f(1, 0);
+  for (int i = 0; i < 3; i++) {
+    auto prr = f.collector->put(make_kinesis_record(1));
+    BOOST_REQUIRE(prr);
+    // Nothing is tracked without a limit.
+    BOOST_CHECK(f.collector->shards(prr->items()).empty());
+  }
+  BOOST_CHECK_EQUAL(f.collector->held(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ShardWindow) {
+  Fixture f(1, 1);
+
+  auto first = f.collector->put(make_kinesis_record(1));
+  BOOST_REQUIRE(first);
+
+  auto held = make_kinesis_record(1);
+  BOOST_CHECK(!f.collector->put(held));
+  BOOST_CHECK_EQUAL(f.collector->held(), 1);
+
+  // Other shards aren't affected
+  BOOST_CHECK(f.collector->put(make_kinesis_record(2)));
+
+  f.complete(first);
+  BOOST_CHECK_EQUAL(f.collector->held(), 0);
+  BOOST_REQUIRE_EQUAL(f.flushed.size(), 1);
+  BOOST_REQUIRE_EQUAL(f.flushed[0]->size(), 1);
+  BOOST_CHECK(f.flushed[0]->items()[0] == held);
+}
+
+BOOST_AUTO_TEST_CASE(PartOfRequestHeld) {
+  Fixture f(2, 1);
+
+  BOOST_CHECK(!f.collector->put(make_kinesis_record(1)));
+  auto first = f.collector->put(make_kinesis_record(1));
+  BOOST_REQUIRE(first);
+  BOOST_CHECK_EQUAL(first->size(), 2);
+
+  auto held = make_kinesis_record(1);
+  auto other = make_kinesis_record(2);
+  BOOST_CHECK(!f.collector->put(held));
+  auto second = f.collector->put(other);
+  BOOST_REQUIRE(second);
+  BOOST_REQUIRE_EQUAL(second->size(), 1);
+  BOOST_CHECK(second->items()[0] == other);
+  BOOST_CHECK_EQUAL(f.collector->held(), 1);
+
+  // Released records are sent in a request of their own.
+  f.complete(first);
+  BOOST_CHECK_EQUAL(f.collector->held(), 0);
+  BOOST_REQUIRE_EQUAL(f.flushed.size(), 1);
+  BOOST_REQUIRE_EQUAL(f.flushed[0]->size(), 1);
+  BOOST_CHECK(f.flushed[0]->items()[0] == held);
+}
+
+BOOST_AUTO_TEST_CASE(HeldBeforeNew) {
+  Fixture f(2, 1);
+
+  BOOST_CHECK(!f.collector->put(make_kinesis_record(1)));
+  auto first = f.collector->put(make_kinesis_record(1));
+  BOOST_REQUIRE(first);
+
+  auto held1 = make_kinesis_record(1);
+  auto held2 = make_kinesis_record(1);
+  BOOST_CHECK(!f.collector->put(held1));
+  BOOST_CHECK(!f.collector->put(held2));
+  BOOST_CHECK_EQUAL(f.collector->held(), 2);
+
+  // Collected while the window is full, so it's newer than the held records.
+  auto newer = make_kinesis_record(1);
+  BOOST_CHECK(!f.collector->put(newer));
+
+  // The held records go out first, without waiting for the newer one.
+  f.complete(first);
+  BOOST_REQUIRE_EQUAL(f.flushed.size(), 1);
+  auto released = f.flushed[0]->items();
+  BOOST_REQUIRE_EQUAL(released.size(), 2);
+  BOOST_CHECK(std::find(released.begin(), released.end(), held1) !=
+              released.end());
+  BOOST_CHECK(std::find(released.begin(), released.end(), held2) !=
+              released.end());
+
+  // The release took the shard's slot, so the newer record waits for it.
+  f.collector->flush();
+  BOOST_CHECK_EQUAL(f.flushed.size(), 1);
+  BOOST_CHECK_EQUAL(f.collector->held(), 1);
+
+  f.complete(f.flushed[0]);
+  BOOST_REQUIRE_EQUAL(f.flushed.size(), 2);
+  BOOST_REQUIRE_EQUAL(f.flushed[1]->size(), 1);
+  BOOST_CHECK(f.flushed[1]->items()[0] == newer);
+}
+
+BOOST_AUTO_TEST_CASE(ReleasedOneRequestPerSlot) {
+  Fixture f(1, 2);
+
+  auto first = f.collector->put(make_kinesis_record(1));
+  auto second = f.collector->put(make_kinesis_record(1));
+  BOOST_REQUIRE(first);
+  BOOST_REQUIRE(second);
+  auto held1 = make_kinesis_record(1);
+  auto held2 = make_kinesis_record(1);
+  BOOST_CHECK(!f.collector->put(held1));
+  BOOST_CHECK(!f.collector->put(held2));
+
+  // Each completion opens one slot, which takes one request's worth of held
+  // records, oldest first.
+  f.complete(first);
+  BOOST_REQUIRE_EQUAL(f.flushed.size(), 1);
+  BOOST_CHECK(f.flushed[0]->items()[0] == held1);
+  f.complete(second);
+  BOOST_REQUIRE_EQUAL(f.flushed.size(), 2);
+  BOOST_CHECK(f.flushed[1]->items()[0] == held2);
+  BOOST_CHECK_EQUAL(f.collector->held(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ShardsTakenBeforeRetry) {
+  Fixture f(1, 1);
+
+  auto first = f.collector->put(make_kinesis_record(1));
+  BOOST_REQUIRE(first);
+  BOOST_CHECK(!f.collector->put(make_kinesis_record(1)));
+
+  // Retrying can give a record a new predicted shard; the slot released is
+  // still the one the request was counted against.
+  auto shards = f.collector->shards(first->items());
+  first->items()[0]->items()[0]->predicted_shard(2);
+  f.collector->request_completed(shards);
+  BOOST_CHECK_EQUAL(f.collector->held(), 0);
+  BOOST_CHECK_EQUAL(f.flushed.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(HeldRecordsExpire) {
+  Fixture f(1, 1);
+
+  auto first = f.collector->put(make_kinesis_record(1));
+  BOOST_REQUIRE(first);
+  auto expiring = make_kinesis_record(1);
+  expiring->set_expiration_from_now(std::chrono::milliseconds(50));
+  auto kept = make_kinesis_record(1);
+  BOOST_CHECK(!f.collector->put(expiring));
+  BOOST_CHECK(!f.collector->put(kept));
+
+  for (int i = 0; i < 200 && f.expired_count() == 0; i++) {
+    aws::utils::sleep_for(std::chrono::milliseconds(10));
+  }
+  BOOST_REQUIRE_EQUAL(f.expired_count(), 1);
+  BOOST_CHECK(f.expired[0] == expiring);
+  BOOST_CHECK_EQUAL(f.collector->held(), 1);
+
+  // Only the record that hasn't expired is sent.
+  f.complete(first);
+  BOOST_REQUIRE_EQUAL(f.flushed.size(), 1);
+  BOOST_REQUIRE_EQUAL(f.flushed[0]->size(), 1);
+  BOOST_CHECK(f.flushed[0]->items()[0] == kept);
+}
+
+BOOST_AUTO_TEST_CASE(LimitUpdated) {
+  Fixture f(1, 0);
+
+  // Raising the limit starts counting requests from the next one.
+  f.config->shard_max_in_flight(1);
+  auto first = f.collector->put(make_kinesis_record(1));
+  BOOST_REQUIRE(first);
+  auto held = make_kinesis_record(1);
+  BOOST_CHECK(!f.collector->put(held));
+
+  // Lowering it to 0 opens every window, but requests already counted are
+  // still tracked so that held records aren't stranded.
+  f.config->shard_max_in_flight(0);
+  auto newer = make_kinesis_record(1);
+  BOOST_CHECK(!f.collector->put(newer));
+  BOOST_CHECK_EQUAL(f.collector->held(), 2);
+  f.complete(first);
+  BOOST_CHECK_EQUAL(f.collector->held(), 0);
+  BOOST_REQUIRE_EQUAL(f.flushed.size(), 2);
+  BOOST_CHECK(f.flushed[0]->items()[0] == held);
+  BOOST_CHECK(f.flushed[1]->items()[0] == newer);
+
+  // Once those have completed, nothing is tracked anymore.
+  f.complete(f.flushed[0]);
+  f.complete(f.flushed[1]);
+  auto prr = f.collector->put(make_kinesis_record(1));
+  BOOST_REQUIRE(prr);
+  BOOST_CHECK(f.collector->shards(prr->items()).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
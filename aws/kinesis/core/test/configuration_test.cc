@@ -0,0 +1,142 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <aws/kinesis/core/configuration.h>
+
+namespace {
+
+using Config = aws::kinesis::core::Configuration;
+
+aws::kinesis::protobuf::StreamOverride* add_override(
+    aws::kinesis::protobuf::Message& m,
+    const std::string& stream) {
+  auto o = m.mutable_configuration()->add_stream_overrides();
+  o->set_stream(stream);
+  return o;
+}
+
+std::shared_ptr<Config> make_config(const aws::kinesis::protobuf::Message& m) {
+  auto config = std::make_shared<Config>();
+  config->transfer_from_protobuf_msg(m);
+  return config;
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(Configuration)
+
+BOOST_AUTO_TEST_CASE(FindStreamOverride) {
+  aws::kinesis::protobuf::Message m;
+  add_override(m, "*")->set_rate_limit(1);
+  add_override(m, "clicks-*")->set_rate_limit(2);
+  add_override(m, "clicks-eu-*")->set_rate_limit(3);
+  add_override(m, "clicks-eu-west")->set_rate_limit(4);
+  auto config = make_config(m);
+
+  BOOST_CHECK_EQUAL(config->find_stream_override("alerts")->rate_limit(), 1);
+  BOOST_CHECK_EQUAL(config->find_stream_override("clicks-us")->rate_limit(), 2);
+  BOOST_CHECK_EQUAL(config->find_stream_override("clicks-eu-north")->rate_limit(),
+                    3);
+  BOOST_CHECK_EQUAL(config->find_stream_override("clicks-eu-west")->rate_limit(),
+                    4);
+  BOOST_CHECK_EQUAL(
+      config->find_stream_override("clicks-eu-west-2")->rate_limit(),
+      3);
+
+  aws::kinesis::protobuf::Message none;
+  add_override(none, "clicks");
+  BOOST_CHECK(!make_config(none)->find_stream_override("clicks-eu"));
+}
+
+BOOST_AUTO_TEST_CASE(InvalidOverride) {
+  aws::kinesis::protobuf::Message m;
+  add_override(m, "alerts")->set_collection_max_count(501);
+  BOOST_CHECK_THROW(make_config(m), std::runtime_error);
+
+  aws::kinesis::protobuf::Message empty;
+  add_override(empty, "");
+  BOOST_CHECK_THROW(make_config(empty), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(ForStream) {
+  aws::kinesis::protobuf::Message m;
+  m.mutable_configuration()->set_region("us-west-2");
+  m.mutable_configuration()->set_record_max_buffered_time(200);
+  auto o = add_override(m, "alerts");
+  o->set_aggregation_enabled(false);
+  o->set_record_max_buffered_time(10);
+  auto base = make_config(m);
+
+  BOOST_CHECK(Config::for_stream(base, "clicks") == base);
+
+  auto alerts = Config::for_stream(base, "alerts");
+  BOOST_REQUIRE(alerts != base);
+  BOOST_CHECK(!alerts->aggregation_enabled());
+  BOOST_CHECK_EQUAL(alerts->record_max_buffered_time(), 10);
+  BOOST_CHECK_EQUAL(alerts->region(), "us-west-2");
+  BOOST_CHECK(base->aggregation_enabled());
+  BOOST_CHECK_EQUAL(base->record_max_buffered_time(), 200);
+}
+
+BOOST_AUTO_TEST_CASE(UpdateKeepsOverride) {
+  aws::kinesis::protobuf::Message m;
+  add_override(m, "alerts")->set_record_max_buffered_time(10);
+  auto base = make_config(m);
+
+  aws::kinesis::protobuf::UpdateConfiguration u;
+  u.set_rate_limit(50);
+  base->update_from_protobuf_msg(u);
+
+  // Copies made after an update start from the updated values.
+  auto alerts = Config::for_stream(base, "alerts");
+  BOOST_CHECK_EQUAL(alerts->rate_limit(), 50);
+
+  u.set_rate_limit(80);
+  u.set_record_max_buffered_time(300);
+  base->update_from_protobuf_msg(u);
+  alerts->update_from_protobuf_msg(u);
+  BOOST_CHECK_EQUAL(base->record_max_buffered_time(), 300);
+  BOOST_CHECK_EQUAL(alerts->record_max_buffered_time(), 10);
+  BOOST_CHECK_EQUAL(alerts->rate_limit(), 80);
+
+  // Nothing is applied if any value is invalid.
+  u.set_rate_limit(60);
+  u.set_record_ttl(1);
+  BOOST_CHECK_THROW(base->update_from_protobuf_msg(u), std::runtime_error);
+  BOOST_CHECK_EQUAL(base->rate_limit(), 80);
+}
+
+BOOST_AUTO_TEST_CASE(UpdatePublishesNewSnapshot) {
+  auto config = std::make_shared<Config>();
+  auto before = config->snapshot();
+
+  aws::kinesis::protobuf::UpdateConfiguration u;
+  u.set_collection_max_count(100);
+  u.set_collection_max_size(100000);
+  config->update_from_protobuf_msg(u);
+
+  // A snapshot taken earlier keeps the old values; a new one has all of the
+  // update's values.
+  BOOST_CHECK_EQUAL(before.collection_max_count, 500);
+  BOOST_CHECK_EQUAL(before.collection_max_size, 5242880);
+  auto after = config->snapshot();
+  BOOST_CHECK_EQUAL(after.collection_max_count, 100);
+  BOOST_CHECK_EQUAL(after.collection_max_size, 100000);
+  BOOST_CHECK_EQUAL(config->collection_max_count(), 100);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
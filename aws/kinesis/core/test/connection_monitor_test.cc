@@ -0,0 +1,69 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <aws/core/monitoring/HttpClientMetrics.h>
+#include <aws/kinesis/core/connection_monitor.h>
+
+namespace {
+
+using Monitor = aws::kinesis::core::ConnectionMonitor;
+using Type = Aws::Monitoring::HttpClientMetricsType;
+
+Aws::Monitoring::CoreMetricsCollection metrics(int64_t connect_ms,
+                                               int64_t ssl_ms) {
+  Aws::Monitoring::CoreMetricsCollection m;
+  m.httpClientMetrics[
+      Aws::Monitoring::GetHttpClientMetricNameByType(Type::ConnectLatency)] =
+          connect_ms;
+  m.httpClientMetrics[
+      Aws::Monitoring::GetHttpClientMetricNameByType(Type::SslLatency)] =
+          ssl_ms;
+  return m;
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(ConnectionMonitor)
+
+BOOST_AUTO_TEST_CASE(CountsNewConnections) {
+  Monitor::drain();
+
+  Monitor::record("kinesis", metrics(5, 40));
+  Monitor::record("kinesis", metrics(0, 0));
+  Monitor::record("kinesis", metrics(0, 0));
+
+  auto stats = Monitor::drain();
+  BOOST_CHECK_EQUAL(stats.requests, 3);
+  BOOST_REQUIRE_EQUAL(stats.handshakes.size(), 1);
+  BOOST_CHECK_EQUAL(stats.handshakes[0].count(), 40);
+
+  stats = Monitor::drain();
+  BOOST_CHECK_EQUAL(stats.requests, 0);
+  BOOST_CHECK(stats.handshakes.empty());
+}
+
+BOOST_AUTO_TEST_CASE(IgnoresOtherServices) {
+  Monitor::drain();
+
+  Monitor::record("monitoring", metrics(5, 40));
+
+  auto stats = Monitor::drain();
+  BOOST_CHECK_EQUAL(stats.requests, 0);
+  BOOST_CHECK(stats.handshakes.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <aws/kinesis/core/direct_sender.h>
+#include <aws/kinesis/core/test/test_utils.h>
+
+namespace {
+
+using Requests =
+    std::vector<std::shared_ptr<aws::kinesis::core::PutRecordsRequest>>;
+using Records =
+    std::vector<std::shared_ptr<aws::kinesis::core::KinesisRecord>>;
+
+auto make_kinesis_record(size_t data_size = 10) {
+  auto ur = aws::kinesis::test::make_user_record(
+      "pk",
+      std::string(data_size, 'a'));
+  auto kr = std::make_shared<aws::kinesis::core::KinesisRecord>();
+  kr->add(ur);
+  return kr;
+}
+
+auto make_sender(Requests& sent,
+                 size_t max_in_flight,
+                 Records* expired = nullptr) {
+  auto config = std::make_shared<aws::kinesis::core::Configuration>();
+  config->direct_send(true);
+  config->direct_send_max_in_flight(max_in_flight);
+  config->collection_max_count(3);
+  return std::make_shared<aws::kinesis::core::DirectSender>(
+      [&](auto prr) { sent.push_back(prr); },
+      [=](auto& kr) {
+        BOOST_REQUIRE(expired);
+        expired->push_back(kr);
+      },
+      config);
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(DirectSender)
+
+BOOST_AUTO_TEST_CASE(SendsRightAway) {
+  Requests sent;
+  auto sender = make_sender(sent, 2);
+
+  sender->put(make_kinesis_record());
+  BOOST_REQUIRE_EQUAL(sent.size(), 1);
+  BOOST_CHECK_EQUAL(sent[0]->size(), 1);
+
+  sender->put(make_kinesis_record());
+  BOOST_REQUIRE_EQUAL(sent.size(), 2);
+  BOOST_CHECK_EQUAL(sender->in_flight(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(WaitsForSlot) {
+  Requests sent;
+  auto sender = make_sender(sent, 1);
+
+  sender->put(make_kinesis_record());
+  for (int i = 0; i < 4; i++) {
+    sender->put(make_kinesis_record());
+  }
+  BOOST_CHECK_EQUAL(sent.size(), 1);
+  BOOST_CHECK_EQUAL(sender->waiting(), 4);
+
+  // What's ready goes out together, up to the collection limits.
+  sender->request_completed();
+  BOOST_REQUIRE_EQUAL(sent.size(), 2);
+  BOOST_CHECK_EQUAL(sent[1]->size(), 3);
+  BOOST_CHECK_EQUAL(sender->waiting(), 1);
+
+  sender->request_completed();
+  BOOST_REQUIRE_EQUAL(sent.size(), 3);
+  BOOST_CHECK_EQUAL(sent[2]->size(), 1);
+
+  sender->request_completed();
+  BOOST_CHECK_EQUAL(sent.size(), 3);
+  BOOST_CHECK_EQUAL(sender->in_flight(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(SizeLimit) {
+  Requests sent;
+  auto sender = make_sender(sent, 1);
+
+  sender->put(make_kinesis_record());
+  // Each fills more than half of a request.
+  sender->put(make_kinesis_record(3 * 1024 * 1024));
+  sender->put(make_kinesis_record(3 * 1024 * 1024));
+
+  sender->request_completed();
+  BOOST_REQUIRE_EQUAL(sent.size(), 2);
+  BOOST_CHECK_EQUAL(sent[1]->size(), 1);
+  sender->request_completed();
+  BOOST_REQUIRE_EQUAL(sent.size(), 3);
+  BOOST_CHECK_EQUAL(sent[2]->size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(ExpiredNotSent) {
+  Requests sent;
+  Records expired;
+  auto sender = make_sender(sent, 1, &expired);
+
+  sender->put(make_kinesis_record());
+  auto expiring = make_kinesis_record();
+  expiring->set_expiration_from_now(std::chrono::milliseconds(-1));
+  auto kept = make_kinesis_record();
+  sender->put(expiring);
+  sender->put(kept);
+  // Nothing is checked while every slot is taken.
+  BOOST_CHECK(expired.empty());
+  BOOST_CHECK_EQUAL(sender->waiting(), 2);
+
+  sender->request_completed();
+  BOOST_REQUIRE_EQUAL(expired.size(), 1);
+  BOOST_CHECK(expired[0] == expiring);
+  BOOST_REQUIRE_EQUAL(sent.size(), 2);
+  BOOST_REQUIRE_EQUAL(sent[1]->size(), 1);
+  BOOST_CHECK(sent[1]->items()[0] == kept);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,82 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+#include <aws/kinesis/core/flush_tracker.h>
+
+BOOST_AUTO_TEST_SUITE(FlushTracker)
+
+BOOST_AUTO_TEST_CASE(NothingOutstanding) {
+  aws::kinesis::core::FlushTracker tracker;
+  bool done = false;
+  tracker.flush([&] { done = true; });
+  BOOST_CHECK(done);
+  BOOST_CHECK_EQUAL(tracker.pending(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(WaitsForEarlierRecords) {
+  aws::kinesis::core::FlushTracker tracker;
+  auto a = tracker.accepted();
+  auto b = tracker.accepted();
+
+  std::vector<int> done;
+  tracker.flush([&] { done.push_back(1); });
+  auto c = tracker.accepted();
+  tracker.flush([&] { done.push_back(2); });
+  auto d = tracker.accepted();
+  BOOST_CHECK_EQUAL(tracker.pending(), 2);
+
+  // Records after a flush don't hold it up.
+  tracker.finished(c);
+  tracker.finished(d);
+  tracker.finished(b);
+  BOOST_CHECK(done.empty());
+
+  // Both complete in order once the oldest record finishes.
+  tracker.finished(a);
+  BOOST_REQUIRE_EQUAL(done.size(), 2);
+  BOOST_CHECK_EQUAL(done[0], 1);
+  BOOST_CHECK_EQUAL(done[1], 2);
+  BOOST_CHECK_EQUAL(tracker.pending(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Concurrency) {
+  aws::kinesis::core::FlushTracker tracker;
+  std::atomic<size_t> flushes_done(0);
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; t++) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 20000; i++) {
+        auto epoch = tracker.accepted();
+        tracker.finished(epoch);
+      }
+    });
+  }
+  for (int i = 0; i < 1000; i++) {
+    tracker.flush([&] { flushes_done++; });
+  }
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  BOOST_CHECK_EQUAL(flushes_done, 1000);
+  BOOST_CHECK_EQUAL(tracker.pending(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
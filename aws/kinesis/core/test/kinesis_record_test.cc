@@ -278,6 +278,46 @@ BOOST_AUTO_TEST_CASE(Clearing) {
   }
 }
 
+// A record serialized ahead gives the same bytes, and changing it afterwards
+// discards what was serialized
+BOOST_AUTO_TEST_CASE(SerializeAhead) {
+  int N = 10;
+
+  std::vector<std::shared_ptr<aws::kinesis::core::UserRecord>> user_records;
+  aws::kinesis::core::KinesisRecord r;
+  for (int i = 0; i < N; i++) {
+    auto ur = aws::kinesis::test::make_user_record();
+    user_records.push_back(ur);
+    r.add(ur);
+  }
+
+  auto expected = r.serialize();
+  r.serialize_ahead();
+  BOOST_CHECK(r.serialize() == expected);
+  aws::kinesis::test::verify(user_records, r);
+
+  r.serialize_ahead();
+  r.remove_last();
+  user_records.pop_back();
+  aws::kinesis::test::verify(user_records, r);
+
+  r.serialize_ahead();
+  auto ur = aws::kinesis::test::make_user_record();
+  user_records.push_back(ur);
+  r.add(ur);
+  aws::kinesis::test::verify(user_records, r);
+
+  r.serialize_ahead();
+  r.clear();
+  user_records.clear();
+  for (int i = 0; i < 2; i++) {
+    auto ur = aws::kinesis::test::make_user_record();
+    user_records.push_back(ur);
+    r.add(ur);
+  }
+  aws::kinesis::test::verify(user_records, r);
+}
+
 // Test that deadlines are correctly set
 BOOST_AUTO_TEST_CASE(Deadlines) {
   // The nearest deadline should always be kept
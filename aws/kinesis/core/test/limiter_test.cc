@@ -43,10 +43,13 @@ auto make_kinesis_record(
   return kr;
 }
 
-auto make_limiter(Callback cb, Callback expired_cb = [](auto) {}) {
+auto make_limiter(Callback cb,
+                  Callback expired_cb = [](auto) {},
+                  bool event_driven = false) {
   auto executor = std::make_shared<aws::utils::IoServiceExecutor>(2);
   auto config = std::make_shared<aws::kinesis::core::Configuration>();
   config->rate_limit(100);
+  config->direct_send(event_driven);
   return std::make_shared<aws::kinesis::core::Limiter>(
       executor,
       cb,
@@ -176,4 +179,95 @@ BOOST_AUTO_TEST_CASE(Expiration) {
   BOOST_REQUIRE_EQUAL(expect_expired.size(), expired.size());
 }
 
+// Test that a drain reports when the shard can next make progress
+BOOST_AUTO_TEST_CASE(NextDrain) {
+  aws::kinesis::core::detail::ShardLimiter limiter;
+  auto cb = [](auto&) {};
+  auto expired_cb = [](auto&) {};
+
+  BOOST_CHECK(limiter.drain(cb, expired_cb) == TimePoint::max());
+
+  // Records are sent right away until the tokens run out.
+  auto next = TimePoint::max();
+  for (size_t i = 0; i < 2000 && next == TimePoint::max(); i++) {
+    next = limiter.put(make_kinesis_record(), cb, expired_cb);
+  }
+
+  // Then one more record can be sent every millisecond.
+  BOOST_REQUIRE(next != TimePoint::max());
+  BOOST_CHECK(next <= Clock::now() + std::chrono::milliseconds(1));
+
+  // Unless a record expires before that.
+  auto expires = Clock::now() + std::chrono::microseconds(300);
+  next = limiter.put(make_kinesis_record(Clock::now(), expires),
+                     cb,
+                     expired_cb);
+  BOOST_CHECK(next <= expires);
+}
+
+// Test that an event-driven limiter sends queued records when tokens are
+// available, without polling
+BOOST_AUTO_TEST_CASE(EventDriven) {
+  aws::mutex mutex;
+  std::vector<std::shared_ptr<aws::kinesis::core::KinesisRecord>> sent;
+  auto limiter = make_limiter(
+      [&](auto kr) {
+        aws::lock_guard<aws::mutex> lk(mutex);
+        sent.push_back(kr);
+      },
+      [](auto) {},
+      true);
+
+  auto start = Clock::now();
+  for (size_t i = 0; i < 1500; i++) {
+    limiter->put(make_kinesis_record());
+  }
+
+  auto done = [&] {
+    aws::lock_guard<aws::mutex> lk(mutex);
+    return sent.size() == 1500;
+  };
+  while (!done() && Clock::now() < start + std::chrono::seconds(5)) {
+    aws::utils::sleep_for(std::chrono::milliseconds(10));
+  }
+  BOOST_REQUIRE(done());
+  // The last 500 records take half a second to get tokens for.
+  BOOST_CHECK(Clock::now() - start >= std::chrono::milliseconds(450));
+}
+
+// Test that shedding drops the queued records closest to expiring, and no more
+// than needed
+BOOST_AUTO_TEST_CASE(Shed) {
+  aws::kinesis::core::detail::ShardLimiter limiter;
+  std::vector<std::shared_ptr<aws::kinesis::core::KinesisRecord>> krs, sent;
+  auto cb = [&](auto& kr) { sent.push_back(kr); };
+  auto expired_cb = [](auto&) {};
+
+  // Later records expire sooner. The token bucket lets the first ones through
+  // and the rest stay queued.
+  auto now = Clock::now();
+  for (size_t i = 0; i < 3000; i++) {
+    auto kr = make_kinesis_record(
+        now + std::chrono::hours(1),
+        now + std::chrono::hours(2) - std::chrono::milliseconds(i));
+    krs.push_back(kr);
+    limiter.put(kr, cb, expired_cb);
+  }
+  BOOST_REQUIRE_LT(sent.size(), krs.size() - 10);
+
+  std::vector<std::shared_ptr<aws::kinesis::core::KinesisRecord>> dropped;
+  auto size = krs.front()->accurate_size();
+  BOOST_CHECK_EQUAL(limiter.shed(10 * size - 1, dropped), 10 * size);
+  BOOST_REQUIRE_EQUAL(dropped.size(), 10);
+  for (size_t i = 0; i < dropped.size(); i++) {
+    BOOST_CHECK(dropped[i] == krs[krs.size() - 1 - i]);
+  }
+
+  // Dropped records are gone from the queue.
+  dropped.clear();
+  limiter.shed(size, dropped);
+  BOOST_REQUIRE_EQUAL(dropped.size(), 1);
+  BOOST_CHECK(dropped[0] == krs[krs.size() - 11]);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,160 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <aws/kinesis/core/memory_budget.h>
+#include <aws/kinesis/core/retrier.h>
+#include <aws/kinesis/core/spill_log.h>
+#include <aws/kinesis/core/test/test_utils.h>
+
+namespace {
+
+using Budget = aws::kinesis::core::MemoryBudget;
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(MemoryBudget)
+
+BOOST_AUTO_TEST_CASE(ParsePolicy) {
+  BOOST_CHECK(Budget::parse_policy("fail") == Budget::Policy::Fail);
+  BOOST_CHECK(Budget::parse_policy("drop_oldest") ==
+              Budget::Policy::DropOldest);
+  BOOST_CHECK(Budget::parse_policy("backpressure") ==
+              Budget::Policy::Backpressure);
+  BOOST_CHECK_THROW(Budget::parse_policy("block"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(RecordBytes) {
+  auto ur = aws::kinesis::test::make_user_record("abc", "123456");
+  BOOST_CHECK_EQUAL(Budget::bytes(*ur),
+                    9 + sizeof(aws::kinesis::core::UserRecord));
+}
+
+BOOST_AUTO_TEST_CASE(Unlimited) {
+  Budget budget;
+  BOOST_CHECK(budget.acquire(1ull << 40));
+  BOOST_CHECK_EQUAL(budget.used(), 1ull << 40);
+  BOOST_CHECK_EQUAL(budget.excess(), 0);
+  budget.release(1ull << 40);
+  BOOST_CHECK_EQUAL(budget.used(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(Fail) {
+  Budget budget(100, Budget::Policy::Fail);
+  BOOST_CHECK(budget.acquire(60));
+  BOOST_CHECK(budget.acquire(40));
+  BOOST_CHECK_EQUAL(budget.excess(), 0);
+
+  // Charged even when refused, released when the failed record finishes.
+  BOOST_CHECK(!budget.acquire(10));
+  BOOST_CHECK_EQUAL(budget.used(), 110);
+  BOOST_CHECK_EQUAL(budget.excess(), 10);
+  budget.release(10);
+
+  budget.release(60);
+  BOOST_CHECK(budget.acquire(50));
+  BOOST_CHECK_EQUAL(budget.used(), 90);
+}
+
+BOOST_AUTO_TEST_CASE(Backpressure) {
+  std::vector<std::pair<bool, uint64_t>> calls;
+  Budget budget(
+      1000,
+      Budget::Policy::Backpressure,
+      [&](bool paused, uint64_t used) { calls.emplace_back(paused, used); });
+
+  BOOST_CHECK(budget.acquire(1000));
+  BOOST_CHECK(calls.empty());
+
+  // Never refuses, pauses once when going over.
+  BOOST_CHECK(budget.acquire(200));
+  BOOST_CHECK(budget.acquire(200));
+  BOOST_REQUIRE_EQUAL(calls.size(), 1);
+  BOOST_CHECK(calls[0].first);
+  BOOST_CHECK_EQUAL(calls[0].second, 1200);
+  BOOST_CHECK(budget.paused());
+
+  // Stays paused until back down to 90%.
+  budget.release(400);
+  budget.release(50);
+  BOOST_CHECK_EQUAL(calls.size(), 1);
+  budget.release(50);
+  BOOST_REQUIRE_EQUAL(calls.size(), 2);
+  BOOST_CHECK(!calls[1].first);
+  BOOST_CHECK_EQUAL(calls[1].second, 900);
+  BOOST_CHECK(!budget.paused());
+
+  budget.update_backpressure();
+  BOOST_CHECK_EQUAL(calls.size(), 2);
+}
+
+// A record that expired in the spill log was never admitted, but finishing it
+// releases its bytes like any other. Replay has to charge it first, or usage
+// wraps around and the budget stays exhausted for good.
+BOOST_AUTO_TEST_CASE(ExpiredInSpillLog) {
+  std::vector<bool> calls;
+  Budget budget(
+      1000,
+      Budget::Policy::Backpressure,
+      [&](bool paused, uint64_t) { calls.push_back(paused); });
+
+  auto dir = boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path();
+  {
+    aws::kinesis::core::SpillLog log(dir.string(), 1 << 20, false);
+    aws::kinesis::core::SpillLog::Entry e;
+    e.source_id = 1;
+    e.partition_key = "pk";
+    e.data = std::string(100, 'a');
+    e.deadline = aws::kinesis::core::SpillLog::Clock::now() -
+        std::chrono::seconds(2);
+    e.expiration = e.deadline + std::chrono::seconds(1);
+    BOOST_REQUIRE(log.append(e));
+    BOOST_REQUIRE(log.take(e));
+
+    aws::kinesis::protobuf::Message m;
+    m.set_id(e.source_id);
+    auto pr = m.mutable_put_record();
+    pr->set_stream_name("myStream");
+    pr->set_partition_key(e.partition_key);
+    pr->set_data(e.data);
+    auto ur = std::make_shared<aws::kinesis::core::UserRecord>(m);
+    ur->set_expiration(std::chrono::steady_clock::now() -
+                       std::chrono::seconds(1));
+    BOOST_REQUIRE(ur->expired());
+
+    aws::kinesis::core::Retrier retrier(
+        std::make_shared<aws::kinesis::core::Configuration>(),
+        [&](auto& ur) { budget.release(Budget::bytes(*ur)); },
+        [&](auto&) { BOOST_FAIL("Retry should not be called"); },
+        [&](auto) { return boost::none; },
+        [&](auto, auto, auto) {
+          BOOST_FAIL("Shard map invalidate should not be called");
+        });
+
+    budget.acquire(Budget::bytes(*ur));
+    retrier.fail(ur, "Expired", "Expired in the spill log");
+  }
+  boost::system::error_code ec;
+  boost::filesystem::remove_all(dir, ec);
+
+  BOOST_CHECK_EQUAL(budget.used(), 0);
+  BOOST_CHECK(budget.acquire(1000));
+  BOOST_CHECK(calls.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,132 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <openssl/evp.h>
+
+#include <aws/kinesis/core/put_records_encoder.h>
+#include <aws/kinesis/core/test/test_utils.h>
+#include <aws/utils/base64.h>
+
+namespace {
+
+using KinesisRecordVector =
+    std::vector<std::shared_ptr<aws::kinesis::core::KinesisRecord>>;
+
+std::shared_ptr<aws::kinesis::core::KinesisRecord> make_kinesis_record(
+    size_t n,
+    const std::string& partition_key = "abcd",
+    const std::string& explicit_hash_key = "") {
+  auto kr = std::make_shared<aws::kinesis::core::KinesisRecord>();
+  for (size_t i = 0; i < n; i++) {
+    kr->add(aws::kinesis::test::make_user_record(
+        partition_key,
+        aws::kinesis::test::random_string(100 + i),
+        explicit_hash_key));
+  }
+  return kr;
+}
+
+std::string decode(const std::string& s) {
+  std::string out(s.size(), 0);
+  auto n = EVP_DecodeBlock((unsigned char*) &out[0],
+                           (const unsigned char*) s.data(),
+                           (int) s.size());
+  BOOST_REQUIRE(n >= 0);
+  // EVP_DecodeBlock keeps the bytes the padding stands in for.
+  auto padding = s.size() - s.find_last_not_of('=') - 1;
+  out.resize(n - padding);
+  return out;
+}
+
+// Returns the value of the string member name in the given entry of the
+// encoded records, unescaped only as far as the tests need.
+std::string member(const std::string& body, size_t entry,
+                   const std::string& name) {
+  size_t pos = body.find("\"Records\":[");
+  BOOST_REQUIRE(pos != std::string::npos);
+  for (size_t i = 0; i <= entry; i++) {
+    pos = body.find("{\"Data\":", pos + 1);
+    BOOST_REQUIRE(pos != std::string::npos);
+  }
+  pos = body.find("\"" + name + "\":\"", pos);
+  BOOST_REQUIRE(pos != std::string::npos);
+  pos += name.size() + 4;
+  std::string value;
+  for (; body[pos] != '"'; pos++) {
+    if (body[pos] == '\\') {
+      pos++;
+    }
+    value += body[pos];
+  }
+  return value;
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(PutRecordsEncoder)
+
+BOOST_AUTO_TEST_CASE(Data) {
+  KinesisRecordVector records = {
+    make_kinesis_record(1),
+    make_kinesis_record(10),
+    make_kinesis_record(1, "efgh", "12345")
+  };
+  auto body = aws::kinesis::core::encode_put_records(records, "{}");
+
+  for (size_t i = 0; i < records.size(); i++) {
+    BOOST_CHECK_EQUAL(decode(member(body, i, "Data")),
+                      records[i]->serialize());
+    BOOST_CHECK_EQUAL(member(body, i, "PartitionKey"),
+                      records[i]->partition_key());
+    BOOST_CHECK_EQUAL(member(body, i, "ExplicitHashKey"),
+                      records[i]->explicit_hash_key());
+  }
+  BOOST_CHECK_EQUAL(body.back(), '}');
+}
+
+BOOST_AUTO_TEST_CASE(Escaping) {
+  KinesisRecordVector records = { make_kinesis_record(1, "a\"b\\c\nd") };
+  auto body = aws::kinesis::core::encode_put_records(records, "{}");
+  BOOST_CHECK(body.find("\"PartitionKey\":\"a\\\"b\\\\c\\u000ad\"") !=
+      std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(Payload) {
+  KinesisRecordVector records = { make_kinesis_record(1, "k", "1") };
+  auto data = records.front()->serialize();
+  std::string entry;
+  aws::utils::base64_encode(data.data(), data.size(), entry);
+  entry = "{\"Data\":\"" + entry +
+      "\",\"PartitionKey\":\"k\",\"ExplicitHashKey\":\"1\"}";
+
+  BOOST_CHECK_EQUAL(
+      aws::kinesis::core::encode_put_records(records, "{}"),
+      "{\"Records\":[" + entry + "]}");
+
+  BOOST_CHECK_EQUAL(
+      aws::kinesis::core::encode_put_records(records, "{\"StreamName\":\"s\"}"),
+      "{\"Records\":[" + entry + "],\"StreamName\":\"s\"}");
+
+  BOOST_CHECK_EQUAL(
+      aws::kinesis::core::encode_put_records({}, "{ }"),
+      "{\"Records\":[] }");
+
+  BOOST_CHECK_THROW(aws::kinesis::core::encode_put_records(records, "[]"),
+                    std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
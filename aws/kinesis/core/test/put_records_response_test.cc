@@ -0,0 +1,118 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <aws/kinesis/core/put_records_response.h>
+
+namespace {
+
+using Entry = aws::kinesis::core::PutRecordsResponseEntry;
+
+// Copies out what the callback sees, since the entries don't own their
+// strings.
+struct Parsed {
+  std::string shard_id;
+  uint64_t shard_number;
+  std::string sequence_number;
+  std::string error_code;
+  std::string error_message;
+};
+
+std::vector<Parsed> parse(const std::string& body) {
+  std::vector<Parsed> v;
+  aws::kinesis::core::parse_put_records_response(body, [&](auto& e) {
+    v.push_back({
+      e.shard_id.to_string(),
+      e.shard_number,
+      e.sequence_number.to_string(),
+      e.text(e.error_code),
+      e.text(e.error_message)
+    });
+  });
+  return v;
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(PutRecordsResponse)
+
+BOOST_AUTO_TEST_CASE(Entries) {
+  auto v = parse(R"(
+      {
+        "FailedRecordCount": 1,
+        "Records": [
+          {
+            "SequenceNumber": "49543463076548007577105092703039560359975228518395012686",
+            "ShardId": "shardId-000000000123"
+          },
+          {
+            "ErrorCode": "ProvisionedThroughputExceededException",
+            "ErrorMessage": "Rate exceeded for shard shardId-000000000001"
+          }
+        ],
+        "EncryptionType": "NONE"
+      }
+      )");
+
+  BOOST_REQUIRE_EQUAL(v.size(), 2);
+  BOOST_CHECK_EQUAL(v[0].shard_id, "shardId-000000000123");
+  BOOST_CHECK_EQUAL(v[0].shard_number, 123);
+  BOOST_CHECK_EQUAL(v[0].sequence_number,
+                    "49543463076548007577105092703039560359975228518395012686");
+  BOOST_CHECK(v[0].error_code.empty());
+  BOOST_CHECK(v[1].sequence_number.empty());
+  BOOST_CHECK_EQUAL(v[1].error_code, "ProvisionedThroughputExceededException");
+  BOOST_CHECK_EQUAL(v[1].error_message,
+                    "Rate exceeded for shard shardId-000000000001");
+}
+
+BOOST_AUTO_TEST_CASE(SkipsUnknownMembers) {
+  auto v = parse(
+      R"({"Other":{"a":[1,2,{"b":null}],"c":"]}"},"Records":[)"
+      R"({"Extra":[true,false],"ShardId":"shardId-1","SequenceNumber":"1",)"
+      R"("Nested":{"ShardId":"shardId-2"}}]})");
+  BOOST_REQUIRE_EQUAL(v.size(), 1);
+  BOOST_CHECK_EQUAL(v[0].shard_number, 1);
+  BOOST_CHECK_EQUAL(v[0].sequence_number, "1");
+}
+
+BOOST_AUTO_TEST_CASE(Escapes) {
+  auto v = parse(
+      R"({"Records":[{"ErrorCode":"E","ErrorMessage":)"
+      R"("a\"b\\c\/d\né😀"}]})");
+  BOOST_REQUIRE_EQUAL(v.size(), 1);
+  BOOST_CHECK_EQUAL(v[0].error_message, "a\"b\\c/d\n\xc3\xa9\xf0\x9f\x98\x80");
+}
+
+BOOST_AUTO_TEST_CASE(Empty) {
+  BOOST_CHECK(parse(R"({"Records":[]})").empty());
+  BOOST_CHECK(parse("{}").empty());
+}
+
+BOOST_AUTO_TEST_CASE(Malformed) {
+  for (auto body : { "", "[]", "{", R"({"Records":[{"ShardId":"shardId-1"})",
+                     R"({"Records":[{"ShardId":"shardId-1}]})",
+                     R"({"Records":[]} x)", R"({"Records":[,]})" }) {
+    BOOST_CHECK_THROW(parse(body), std::runtime_error);
+  }
+
+  // A successful entry has to have a usable shard id.
+  BOOST_CHECK_THROW(
+      parse(R"({"Records":[{"ShardId":"shard","SequenceNumber":"1"}]})"),
+      std::out_of_range);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,359 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <condition_variable>
+#include <thread>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <aws/kinesis/core/put_records_transport.h>
+#include <aws/kinesis/core/test/test_utils.h>
+#include <aws/utils/io_service_executor.h>
+
+namespace {
+
+using Transport = aws::kinesis::core::PutRecordsTransport;
+
+struct Response {
+  int status;
+  std::string body;
+  std::string headers;
+  // Close the connection after this response, without saying so.
+  bool drop = false;
+  // Don't answer at all.
+  bool hang = false;
+};
+
+// Stands in for Kinesis on a local port, answering each request with the
+// next canned response and keeping what it was sent.
+class StandIn {
+ public:
+  StandIn(std::vector<Response> responses)
+      : acceptor_(io_context_,
+                  boost::asio::ip::tcp::endpoint(
+                      boost::asio::ip::address_v4::loopback(), 0)),
+        responses_(std::move(responses)),
+        next_(0),
+        accepted_(0) {
+    thread_ = std::thread([this] { this->accept(); });
+  }
+
+  ~StandIn() {
+    {
+      std::lock_guard<std::mutex> lk(mutex_);
+      stopped_ = true;
+    }
+    cv_.notify_all();
+    // Closing the acceptor doesn't wake a thread blocked in accept, but a
+    // connection does.
+    boost::system::error_code ec;
+    boost::asio::ip::tcp::socket wake(io_context_);
+    wake.connect(acceptor_.local_endpoint(), ec);
+    thread_.join();
+    acceptor_.close(ec);
+    {
+      std::lock_guard<std::mutex> lk(mutex_);
+      for (auto& s : sockets_) {
+        s->shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+      }
+    }
+    for (auto& t : handlers_) {
+      t.join();
+    }
+  }
+
+  uint16_t port() {
+    return acceptor_.local_endpoint().port();
+  }
+
+  size_t accepted() {
+    std::lock_guard<std::mutex> lk(mutex_);
+    return accepted_;
+  }
+
+  std::vector<std::string> requests() {
+    std::lock_guard<std::mutex> lk(mutex_);
+    return requests_;
+  }
+
+ private:
+  void accept() {
+    while (true) {
+      auto socket =
+          std::make_shared<boost::asio::ip::tcp::socket>(io_context_);
+      boost::system::error_code ec;
+      acceptor_.accept(*socket, ec);
+      std::lock_guard<std::mutex> lk(mutex_);
+      if (ec || stopped_) {
+        return;
+      }
+      accepted_++;
+      sockets_.push_back(socket);
+      handlers_.emplace_back([this, socket] { this->serve(*socket); });
+    }
+  }
+
+  void serve(boost::asio::ip::tcp::socket& socket) {
+    boost::asio::streambuf buf;
+    while (true) {
+      boost::system::error_code ec;
+      auto n = boost::asio::read_until(socket, buf, "\r\n\r\n", ec);
+      if (ec) {
+        return;
+      }
+      auto begin = boost::asio::buffers_begin(buf.data());
+      std::string request(begin, begin + n);
+      buf.consume(n);
+      auto pos = request.find("Content-Length: ");
+      size_t len = std::stoull(request.substr(pos + 16));
+      if (buf.size() < len) {
+        boost::asio::read(socket, buf,
+                          boost::asio::transfer_exactly(len - buf.size()), ec);
+      }
+      begin = boost::asio::buffers_begin(buf.data());
+      request.append(begin, begin + len);
+      buf.consume(len);
+
+      Response r;
+      {
+        std::unique_lock<std::mutex> lk(mutex_);
+        requests_.push_back(request);
+        r = responses_.at(next_++ % responses_.size());
+        if (r.hang) {
+          cv_.wait(lk, [this] { return stopped_; });
+          return;
+        }
+      }
+      auto out = "HTTP/1.1 " + std::to_string(r.status) + " X\r\n" +
+          r.headers + "Content-Length: " + std::to_string(r.body.size()) +
+          "\r\n\r\n" + r.body;
+      boost::asio::write(socket, boost::asio::buffer(out), ec);
+      if (r.drop) {
+        socket.close(ec);
+        return;
+      }
+    }
+  }
+
+  boost::asio::io_context io_context_;
+  boost::asio::ip::tcp::acceptor acceptor_;
+  std::vector<Response> responses_;
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool stopped_ = false;
+  size_t next_;
+  size_t accepted_;
+  std::vector<std::string> requests_;
+  std::vector<std::shared_ptr<boost::asio::ip::tcp::socket>> sockets_;
+  std::thread thread_;
+  std::vector<std::thread> handlers_;
+};
+
+const std::string kOk = R"({"FailedRecordCount":0,"Records":[)"
+    R"({"SequenceNumber":"1","ShardId":"shardId-000000000000"}]})";
+
+std::shared_ptr<aws::kinesis::core::PutRecordsContext> make_prc() {
+  auto kr = std::make_shared<aws::kinesis::core::KinesisRecord>();
+  kr->add(aws::kinesis::test::make_user_record());
+  return std::make_shared<aws::kinesis::core::PutRecordsContext>(
+      "myStream",
+      "",
+      "",
+      std::vector<std::shared_ptr<aws::kinesis::core::KinesisRecord>>{ kr });
+}
+
+std::shared_ptr<Transport> make_transport(
+    const std::shared_ptr<aws::utils::Executor>& executor,
+    StandIn& stand_in,
+    size_t max_connections = 1,
+    std::string token = "",
+    std::chrono::milliseconds request_timeout = std::chrono::seconds(5)) {
+  return std::make_shared<Transport>(
+      executor,
+      "127.0.0.1",
+      stand_in.port(),
+      nullptr,
+      "us-west-2",
+      [token] { return Aws::Auth::AWSCredentials("akid", "secret", token); },
+      "test",
+      max_connections,
+      std::chrono::seconds(5),
+      request_timeout);
+}
+
+// Sends n requests at once and waits for all of them to complete.
+std::vector<std::shared_ptr<aws::kinesis::core::PutRecordsContext>>
+send(Transport& transport, size_t n) {
+  std::mutex mutex;
+  std::condition_variable cv;
+  size_t done = 0;
+  std::vector<std::shared_ptr<aws::kinesis::core::PutRecordsContext>> v;
+  for (size_t i = 0; i < n; i++) {
+    v.push_back(make_prc());
+    transport.send(v.back(), [&](auto&) {
+      std::lock_guard<std::mutex> lk(mutex);
+      done++;
+      cv.notify_one();
+    });
+  }
+  std::unique_lock<std::mutex> lk(mutex);
+  BOOST_REQUIRE(cv.wait_for(lk, std::chrono::seconds(10),
+                            [&] { return done == n; }));
+  return v;
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(PutRecordsTransport)
+
+BOOST_AUTO_TEST_CASE(KeepAlive) {
+  auto executor = std::make_shared<aws::utils::IoServiceExecutor>(2);
+  StandIn stand_in({ { 200, kOk } });
+  auto transport = make_transport(executor, stand_in, 1, "token");
+
+  for (int i = 0; i < 3; i++) {
+    auto prc = send(*transport, 1).front();
+    BOOST_CHECK(prc->get_outcome().IsSuccess());
+    BOOST_REQUIRE(prc->get_response_body());
+    BOOST_CHECK_EQUAL(*prc->get_response_body(), kOk);
+  }
+  BOOST_CHECK_EQUAL(stand_in.accepted(), 1);
+
+  auto request = stand_in.requests().front();
+  BOOST_CHECK(boost::starts_with(request, "POST / HTTP/1.1\r\n"));
+  for (auto header : {
+         "Host: 127.0.0.1:",
+         "Content-Type: application/x-amz-json-1.1\r\n",
+         "X-Amz-Target: Kinesis_20131202.PutRecords\r\n",
+         "X-Amz-Security-Token: token\r\n",
+         "Authorization: AWS4-HMAC-SHA256 Credential=akid/",
+         "/us-west-2/kinesis/aws4_request, SignedHeaders=content-type;host;"
+             "x-amz-date;x-amz-security-token;x-amz-target, Signature=" }) {
+    BOOST_CHECK_MESSAGE(request.find(header) != std::string::npos, header);
+  }
+  auto body = request.substr(request.find("\r\n\r\n") + 4);
+  BOOST_CHECK(boost::starts_with(body, "{\"Records\":[{\"Data\":\""));
+  BOOST_CHECK(boost::ends_with(body, "],\"StreamName\":\"myStream\"}"));
+}
+
+BOOST_AUTO_TEST_CASE(ConnectionLimit) {
+  auto executor = std::make_shared<aws::utils::IoServiceExecutor>(2);
+  StandIn stand_in({ { 200, kOk } });
+  auto transport = make_transport(executor, stand_in, 2);
+
+  for (auto& prc : send(*transport, 20)) {
+    BOOST_CHECK(prc->get_response_body());
+  }
+  BOOST_CHECK_LE(stand_in.accepted(), 2);
+  BOOST_CHECK_LE(transport->connections(), 2);
+  BOOST_CHECK_EQUAL(stand_in.requests().size(), 20);
+}
+
+BOOST_AUTO_TEST_CASE(ServiceError) {
+  auto executor = std::make_shared<aws::utils::IoServiceExecutor>(1);
+  StandIn stand_in({
+    { 400, R"({"__type":"com.amazon#ResourceNotFoundException",)"
+           R"("message":"Stream \"myStream\" not found."})" },
+    { 500, "oops" }
+  });
+  auto transport = make_transport(executor, stand_in);
+
+  auto prc = send(*transport, 1).front();
+  BOOST_CHECK(!prc->get_response_body());
+  BOOST_REQUIRE(!prc->get_outcome().IsSuccess());
+  BOOST_CHECK_EQUAL(prc->get_outcome().GetError().GetExceptionName(),
+                    "ResourceNotFoundException");
+  BOOST_CHECK_EQUAL(prc->get_outcome().GetError().GetMessage(),
+                    "Stream \"myStream\" not found.");
+
+  prc = send(*transport, 1).front();
+  BOOST_REQUIRE(!prc->get_outcome().IsSuccess());
+  BOOST_CHECK_EQUAL(prc->get_outcome().GetError().GetExceptionName(),
+                    "HttpError");
+
+  // Errors don't cost the connection.
+  BOOST_CHECK_EQUAL(stand_in.accepted(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(ConnectionClose) {
+  auto executor = std::make_shared<aws::utils::IoServiceExecutor>(1);
+  StandIn stand_in({ { 200, kOk, "Connection: close\r\n" } });
+  auto transport = make_transport(executor, stand_in);
+
+  for (int i = 0; i < 2; i++) {
+    BOOST_CHECK(send(*transport, 1).front()->get_response_body());
+  }
+  BOOST_CHECK_EQUAL(stand_in.accepted(), 2);
+}
+
+// A connection the server dropped while it was idle is replaced without the
+// request failing.
+BOOST_AUTO_TEST_CASE(StaleConnection) {
+  auto executor = std::make_shared<aws::utils::IoServiceExecutor>(1);
+  StandIn stand_in({ { 200, kOk, "", true } });
+  auto transport = make_transport(executor, stand_in);
+
+  for (int i = 0; i < 3; i++) {
+    BOOST_CHECK(send(*transport, 1).front()->get_response_body());
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  }
+  BOOST_CHECK_EQUAL(stand_in.accepted(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(Timeout) {
+  auto executor = std::make_shared<aws::utils::IoServiceExecutor>(1);
+  StandIn stand_in({ { 200, kOk, "", false, true } });
+  auto transport = make_transport(executor, stand_in, 1, "",
+                                  std::chrono::milliseconds(100));
+
+  auto prc = send(*transport, 1).front();
+  BOOST_REQUIRE(!prc->get_outcome().IsSuccess());
+  BOOST_CHECK_EQUAL(prc->get_outcome().GetError().GetExceptionName(),
+                    "RequestTimeout");
+  BOOST_CHECK_EQUAL(transport->connections(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(ConnectionRefused) {
+  auto executor = std::make_shared<aws::utils::IoServiceExecutor>(1);
+  uint16_t port;
+  {
+    StandIn stand_in({ { 200, kOk } });
+    port = stand_in.port();
+  }
+  auto transport = std::make_shared<Transport>(
+      executor,
+      "127.0.0.1",
+      port,
+      nullptr,
+      "us-west-2",
+      [] { return Aws::Auth::AWSCredentials("akid", "secret"); },
+      "test",
+      1,
+      std::chrono::seconds(5),
+      std::chrono::seconds(5));
+
+  auto prc = send(*transport, 1).front();
+  BOOST_REQUIRE(!prc->get_outcome().IsSuccess());
+  BOOST_CHECK_EQUAL(prc->get_outcome().GetError().GetExceptionName(),
+                    "NetworkError");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
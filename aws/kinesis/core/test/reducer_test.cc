@@ -93,6 +93,37 @@ BOOST_AUTO_TEST_CASE(CountLimit) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(SetLimits) {
+  std::vector<std::shared_ptr<aws::kinesis::core::KinesisRecord>> flushed;
+  auto reducer = make_reducer(0xFFFFFFFF, 1000, [&](auto kr) {
+    flushed.push_back(kr);
+  });
+
+  std::vector<std::shared_ptr<aws::kinesis::core::UserRecord>> v;
+  for (int i = 0; i < 10; i++) {
+    auto ur = aws::kinesis::test::make_user_record();
+    v.push_back(ur);
+    BOOST_CHECK(!reducer->add(ur));
+  }
+
+  // Lowering the limit below what's buffered flushes right away.
+  reducer->set_limits(0xFFFFFFFF, 5);
+  BOOST_REQUIRE_EQUAL(flushed.size(), 1);
+  BOOST_CHECK_EQUAL(flushed[0]->size(), 5);
+  BOOST_CHECK_EQUAL(reducer->size(), 5);
+
+  auto ur = aws::kinesis::test::make_user_record();
+  auto kr = reducer->add(ur);
+  BOOST_REQUIRE(kr);
+  BOOST_CHECK_EQUAL(kr->size(), 5);
+  BOOST_CHECK_EQUAL(reducer->size(), 1);
+
+  // Raising it again doesn't flush.
+  reducer->set_limits(0xFFFFFFFF, 1000);
+  BOOST_CHECK_EQUAL(flushed.size(), 1);
+  BOOST_CHECK_EQUAL(reducer->size(), 1);
+}
+
 BOOST_AUTO_TEST_CASE(SizeLimit) {
   size_t limit = 10000;
   auto reducer = make_reducer(limit, 0xFFFFFFFF);
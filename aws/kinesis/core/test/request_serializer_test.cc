@@ -0,0 +1,100 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <future>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+#include <aws/kinesis/core/request_serializer.h>
+#include <aws/kinesis/core/test/test_utils.h>
+#include <aws/utils/io_service_executor.h>
+
+namespace {
+
+using Records = std::vector<std::shared_ptr<aws::kinesis::core::KinesisRecord>>;
+
+Records make_records(size_t count, size_t user_records, size_t data_size) {
+  Records records;
+  for (size_t i = 0; i < count; i++) {
+    auto kr = std::make_shared<aws::kinesis::core::KinesisRecord>();
+    for (size_t j = 0; j < user_records; j++) {
+      kr->add(aws::kinesis::test::make_user_record(
+          "pk" + std::to_string(j),
+          std::string(data_size, 'a' + (i % 26))));
+    }
+    records.push_back(kr);
+  }
+  return records;
+}
+
+// Runs serialize and returns the id of the thread done was called on.
+std::thread::id serialize(aws::kinesis::core::RequestSerializer& serializer,
+                          const Records& records) {
+  std::promise<std::thread::id> called;
+  auto result = called.get_future();
+  serializer.serialize(records, [&called] {
+    called.set_value(std::this_thread::get_id());
+  });
+  BOOST_REQUIRE(result.wait_for(std::chrono::seconds(5)) ==
+                std::future_status::ready);
+  return result.get();
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(RequestSerializer)
+
+BOOST_AUTO_TEST_CASE(Parallel) {
+  auto records = make_records(40, 10, 100);
+  std::vector<std::string> expected;
+  for (auto& kr : records) {
+    expected.push_back(kr->serialize());
+  }
+
+  aws::kinesis::core::RequestSerializer serializer(
+      std::make_shared<aws::utils::IoServiceExecutor>(4),
+      1024);
+  BOOST_CHECK(serialize(serializer, records) != std::this_thread::get_id());
+
+  for (size_t i = 0; i < records.size(); i++) {
+    BOOST_CHECK(records[i]->serialize() == expected[i]);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(SmallRequest) {
+  auto records = make_records(2, 10, 10);
+  aws::kinesis::core::RequestSerializer serializer(
+      std::make_shared<aws::utils::IoServiceExecutor>(4));
+  BOOST_CHECK(serialize(serializer, records) == std::this_thread::get_id());
+}
+
+BOOST_AUTO_TEST_CASE(Unaggregated) {
+  auto records = make_records(100, 1, 1000);
+  aws::kinesis::core::RequestSerializer serializer(
+      std::make_shared<aws::utils::IoServiceExecutor>(4),
+      1024);
+  BOOST_CHECK(serialize(serializer, records) == std::this_thread::get_id());
+}
+
+BOOST_AUTO_TEST_CASE(SingleThread) {
+  auto records = make_records(40, 10, 100);
+  aws::kinesis::core::RequestSerializer serializer(
+      std::make_shared<aws::utils::IoServiceExecutor>(1),
+      1024);
+  BOOST_CHECK(serialize(serializer, records) == std::this_thread::get_id());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
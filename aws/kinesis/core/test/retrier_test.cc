@@ -123,7 +123,7 @@ BOOST_AUTO_TEST_CASE(Success) {
       [&](auto) {
         return boost::none;
       },
-      [&](auto, auto) {
+      [&](auto, auto, auto) {
         BOOST_FAIL("Shard map invalidate should not be called");
       });
 
@@ -132,6 +132,98 @@ BOOST_AUTO_TEST_CASE(Success) {
   BOOST_CHECK_EQUAL(count, num_kr * num_ur_per_kr);
 }
 
+// Same as Success, but with the raw body of the response rather than the
+// SDK's result
+BOOST_AUTO_TEST_CASE(ResponseBody) {
+  auto num_ur_per_kr = 10;
+  auto num_kr = 3;
+
+  auto ctx = make_prr_ctx(num_kr, num_ur_per_kr, error_outcome("code", "msg"));
+  ctx->set_response_body(R"(
+      {
+        "FailedRecordCount": 1,
+        "Records":[
+          {
+            "SequenceNumber":"1234",
+            "ShardId":"shardId-000000000000"
+          },
+          {
+            "SequenceNumber":"4567",
+            "ShardId":"shardId-000000000001"
+          },
+          {
+            "ErrorCode":"InternalFailure",
+            "ErrorMessage":"Internal \"service\" failure."
+          }
+        ]
+      }
+      )");
+
+  size_t count = 0;
+  aws::kinesis::core::Retrier retrier(
+      std::make_shared<aws::kinesis::core::Configuration>(),
+      [&](auto& ur) {
+        auto& attempts = ur->attempts();
+        BOOST_CHECK_EQUAL(attempts.size(), 1);
+        BOOST_CHECK((bool) attempts[0]);
+
+        if (count++ / num_ur_per_kr == 0) {
+          BOOST_CHECK_EQUAL(attempts[0].sequence_number(), "1234");
+          BOOST_CHECK_EQUAL(attempts[0].shard_id(), "shardId-000000000000");
+        } else {
+          BOOST_CHECK_EQUAL(attempts[0].sequence_number(), "4567");
+          BOOST_CHECK_EQUAL(attempts[0].shard_id(), "shardId-000000000001");
+        }
+      },
+      [&](auto& ur) {
+        auto& attempts = ur->attempts();
+        BOOST_CHECK_EQUAL(count++ / num_ur_per_kr, 2);
+        BOOST_CHECK_EQUAL(attempts.size(), 1);
+        BOOST_CHECK(!(bool) attempts[0]);
+        BOOST_CHECK_EQUAL(attempts[0].error_code(), "InternalFailure");
+        BOOST_CHECK_EQUAL(attempts[0].error_message(),
+                          "Internal \"service\" failure.");
+      },
+      [&](auto) {
+        return boost::none;
+      },
+      [&](auto, auto, auto) {
+        BOOST_FAIL("Shard map invalidate should not be called");
+      });
+
+  retrier.put(ctx);
+
+  BOOST_CHECK_EQUAL(count, num_kr * num_ur_per_kr);
+}
+
+BOOST_AUTO_TEST_CASE(MalformedResponseBody) {
+  auto ctx = make_prr_ctx(2, 10, error_outcome("code", "msg"));
+  ctx->set_response_body(R"({"Records":[{"SequenceNumber":"1")");
+
+  size_t count = 0;
+  aws::kinesis::core::Retrier retrier(
+      std::make_shared<aws::kinesis::core::Configuration>(),
+      [&](auto& ur) {
+        BOOST_FAIL("Finish should not be called");
+      },
+      [&](auto& ur) {
+        count++;
+        auto& attempts = ur->attempts();
+        BOOST_CHECK_EQUAL(attempts.size(), 1);
+        BOOST_CHECK_EQUAL(attempts[0].error_code(), "Malformed Response");
+      },
+      [&](auto) {
+        return boost::none;
+      },
+      [&](auto, auto, auto) {
+        BOOST_FAIL("Shard map invalidate should not be called");
+      });
+
+  retrier.put(ctx);
+
+  BOOST_CHECK_EQUAL(count, 20);
+}
+
 BOOST_AUTO_TEST_CASE(RequestFailure) {
   auto ctx = make_prr_ctx(1, 10, error_outcome("code", "msg"));
 
@@ -159,7 +251,7 @@ BOOST_AUTO_TEST_CASE(RequestFailure) {
       [&](auto) {
         return boost::none;
       },
-      [&](auto, auto) {
+      [&](auto, auto, auto) {
         BOOST_FAIL("Shard map invalidate should not be called");
       });
 
@@ -256,7 +348,7 @@ BOOST_AUTO_TEST_CASE(Partial) {
       [&](auto) {
         return boost::none;
       },
-      [&](auto, auto) {
+      [&](auto, auto, auto) {
         BOOST_FAIL("Shard map invalidate should not be called");
       });
 
@@ -302,7 +394,7 @@ BOOST_AUTO_TEST_CASE(FailIfThrottled) {
       [&](auto) {
         return boost::none;
       },
-      [&](auto, auto) {
+      [&](auto, auto, auto) {
         BOOST_FAIL("Shard map invalidate should not be called");
       });
 
@@ -345,7 +437,7 @@ BOOST_AUTO_TEST_CASE(WrongShard) {
       [&](auto) {
         return boost::none;
       },
-      [&](auto, auto) {
+      [&](auto, auto, auto) {
         shard_map_invalidated = true;
       });
 
@@ -391,7 +483,7 @@ BOOST_AUTO_TEST_CASE(InvalidateForFirstUserRecordOnly) {
       [&](auto) {
         return boost::none;
       },
-      [&](auto, auto) {
+      [&](auto, auto, auto) {
         num_shard_map_invalidated++;
       });
 
@@ -445,7 +537,7 @@ BOOST_AUTO_TEST_CASE(InvalidateForFirstUserRecordOnly) {
 //       [&](auto) {
 //         return boost::none;
 //       },
-//       [&](auto, auto) {
+//       [&](auto, auto, auto) {
 //         num_shard_map_invalidated++;
 //       });
 
@@ -490,7 +582,7 @@ BOOST_AUTO_TEST_CASE(WrongShardButCorrectHashrange) {
         [&](auto) {
           return std::make_pair(boost::multiprecision::uint128_t(0), boost::multiprecision::uint128_t(10));
         },
-        [&](auto, auto) {
+        [&](auto, auto, auto) {
           shard_map_invalidated = true;
         });
 
@@ -537,7 +629,7 @@ BOOST_AUTO_TEST_CASE(WrongShardAndWrongHashrange) {
         [&](auto) {
           return std::make_pair(boost::multiprecision::uint128_t(3), boost::multiprecision::uint128_t(10));
         },
-        [&](auto, auto) {
+        [&](auto, auto, auto) {
           shard_map_invalidated = true;
         });
 
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <random>
+
+#include <boost/test/unit_test.hpp>
+
+#include <aws/kinesis/core/shard_boundaries.h>
+
+namespace {
+
+using uint128_t = boost::multiprecision::uint128_t;
+using Boundaries = std::vector<std::pair<uint128_t, uint64_t>>;
+
+// Splits the hash key space evenly into num_shards shards, numbered from 0.
+Boundaries even_split(size_t num_shards) {
+  Boundaries b;
+  uint128_t max("340282366920938463463374607431768211455");
+  uint128_t width = max / num_shards;
+  for (size_t i = 0; i < num_shards; i++) {
+    b.emplace_back(i == num_shards - 1 ? max : width * (i + 1) - 1, i);
+  }
+  return b;
+}
+
+boost::optional<uint64_t> reference_find(const Boundaries& b,
+                                         const uint128_t& key) {
+  auto it = std::lower_bound(b.begin(),
+                             b.end(),
+                             key,
+                             [](const auto& pair, auto& k) {
+                               return pair.first < k;
+                             });
+  if (it == b.end()) {
+    return boost::none;
+  }
+  return it->second;
+}
+
+uint128_t random_key(std::mt19937_64& rng) {
+  return (uint128_t(rng()) << 64) | uint128_t(rng());
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(ShardBoundaries)
+
+BOOST_AUTO_TEST_CASE(Empty) {
+  aws::kinesis::core::ShardBoundaries sb;
+  BOOST_CHECK_EQUAL(sb.size(), 0);
+  BOOST_CHECK(!sb.find(uint128_t(0)));
+  auto results = sb.find(std::vector<uint128_t>{0, 1});
+  BOOST_CHECK_EQUAL(results.size(), 2);
+  BOOST_CHECK(!results[0]);
+  BOOST_CHECK(!results[1]);
+}
+
+BOOST_AUTO_TEST_CASE(Edges) {
+  auto b = even_split(3);
+  aws::kinesis::core::ShardBoundaries sb(b);
+
+  for (size_t i = 0; i < b.size(); i++) {
+    BOOST_CHECK_EQUAL(*sb.find(b[i].first), i);
+    if (i < b.size() - 1) {
+      BOOST_CHECK_EQUAL(*sb.find(b[i].first + 1), i + 1);
+    }
+  }
+  BOOST_CHECK_EQUAL(*sb.find(uint128_t(0)), 0);
+}
+
+BOOST_AUTO_TEST_CASE(KeyBeyondLastBoundary) {
+  Boundaries b{{uint128_t(100), 7}};
+  aws::kinesis::core::ShardBoundaries sb(b);
+  BOOST_CHECK_EQUAL(*sb.find(uint128_t(100)), 7);
+  BOOST_CHECK(!sb.find(uint128_t(101)));
+}
+
+BOOST_AUTO_TEST_CASE(MatchesBinarySearch) {
+  std::mt19937_64 rng(42);
+  for (size_t n : {1, 2, 3, 7, 8, 9, 100, 1000, 10000}) {
+    auto b = even_split(n);
+    aws::kinesis::core::ShardBoundaries sb(b);
+    BOOST_CHECK_EQUAL(sb.size(), n);
+    for (int i = 0; i < 1000; i++) {
+      auto key = random_key(rng);
+      BOOST_CHECK_EQUAL(*sb.find(key), *reference_find(b, key));
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(Batch) {
+  std::mt19937_64 rng(1234);
+  auto b = even_split(500);
+  aws::kinesis::core::ShardBoundaries sb(b);
+
+  std::vector<uint128_t> keys;
+  for (int i = 0; i < 5000; i++) {
+    keys.push_back(random_key(rng));
+  }
+  // Boundaries themselves and duplicates
+  keys.push_back(b[10].first);
+  keys.push_back(b[10].first);
+  keys.push_back(b[10].first + 1);
+
+  auto results = sb.find(keys);
+  BOOST_REQUIRE_EQUAL(results.size(), keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    BOOST_CHECK_EQUAL(*results[i], *reference_find(b, keys[i]));
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
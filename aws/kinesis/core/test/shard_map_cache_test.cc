@@ -0,0 +1,137 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <aws/kinesis/core/shard_map_cache.h>
+#include <aws/utils/utils.h>
+
+namespace {
+
+using Shard = aws::kinesis::core::ShardMapCache::Shard;
+using uint128_t = boost::multiprecision::uint128_t;
+
+// Removes the directory the test cache lives in when the test ends.
+class TempDir {
+ public:
+  TempDir()
+      : path_(boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path()) {}
+
+  ~TempDir() {
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(path_, ec);
+  }
+
+  std::string file(const std::string& name) const {
+    return (path_ / name).string();
+  }
+
+ private:
+  boost::filesystem::path path_;
+};
+
+std::vector<Shard> two_shards() {
+  return {
+    {1, uint128_t(0), uint128_t("170141183460469231731687303715884105727")},
+    {2,
+     uint128_t("170141183460469231731687303715884105728"),
+     uint128_t("340282366920938463463374607431768211455")}
+  };
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(ShardMapCache)
+
+BOOST_AUTO_TEST_CASE(RoundTrip) {
+  TempDir dir;
+  aws::kinesis::core::ShardMapCache cache(dir.file("stream.shardmap"),
+                                          std::chrono::minutes(1));
+  cache.store(two_shards());
+
+  auto contents = cache.load();
+  BOOST_REQUIRE(contents);
+  BOOST_REQUIRE_EQUAL(contents->shards.size(), 2);
+  auto expected = two_shards();
+  for (size_t i = 0; i < expected.size(); i++) {
+    BOOST_CHECK_EQUAL(contents->shards[i].shard_id, expected[i].shard_id);
+    BOOST_CHECK_EQUAL(contents->shards[i].starting_hash_key,
+                      expected[i].starting_hash_key);
+    BOOST_CHECK_EQUAL(contents->shards[i].ending_hash_key,
+                      expected[i].ending_hash_key);
+  }
+  BOOST_CHECK(contents->written_at <= std::chrono::system_clock::now());
+}
+
+BOOST_AUTO_TEST_CASE(Missing) {
+  TempDir dir;
+  aws::kinesis::core::ShardMapCache cache(dir.file("stream.shardmap"),
+                                          std::chrono::minutes(1));
+  BOOST_CHECK(!cache.load());
+}
+
+BOOST_AUTO_TEST_CASE(Expired) {
+  TempDir dir;
+  aws::kinesis::core::ShardMapCache cache(dir.file("stream.shardmap"),
+                                          std::chrono::milliseconds(20));
+  cache.store(two_shards());
+  BOOST_CHECK(cache.load());
+
+  aws::utils::sleep_for(std::chrono::milliseconds(50));
+  BOOST_CHECK(!cache.load());
+}
+
+BOOST_AUTO_TEST_CASE(Corrupted) {
+  TempDir dir;
+  aws::kinesis::core::ShardMapCache cache(dir.file("stream.shardmap"),
+                                          std::chrono::minutes(1));
+  cache.store(two_shards());
+
+  {
+    std::fstream f(cache.path(),
+                   std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(-1, std::ios::end);
+    f.put('x');
+  }
+  BOOST_CHECK(!cache.load());
+
+  // Truncated in the middle of a shard.
+  boost::filesystem::resize_file(cache.path(), 48);
+  BOOST_CHECK(!cache.load());
+
+  boost::filesystem::resize_file(cache.path(), 0);
+  BOOST_CHECK(!cache.load());
+}
+
+BOOST_AUTO_TEST_CASE(Overwrite) {
+  TempDir dir;
+  aws::kinesis::core::ShardMapCache cache(dir.file("stream.shardmap"),
+                                          std::chrono::minutes(1));
+  cache.store(two_shards());
+  cache.store({
+    {3, uint128_t(0), uint128_t("340282366920938463463374607431768211455")}
+  });
+
+  auto contents = cache.load();
+  BOOST_REQUIRE(contents);
+  BOOST_REQUIRE_EQUAL(contents->shards.size(), 1);
+  BOOST_CHECK_EQUAL(contents->shards[0].shard_id, 3);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
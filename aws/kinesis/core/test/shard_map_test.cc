@@ -22,6 +22,7 @@
 #include <aws/utils/utils.h>
 #include <aws/core/auth/AWSCredentialsProvider.h>
 #include <aws/core/Aws.h>
+#include <boost/filesystem.hpp>
 
 namespace {
 
@@ -30,6 +31,14 @@ using uint128_t = boost::multiprecision::uint128_t;
 const std::string kStreamName = "myStream";
 const std::string kStreamARN = "arn:aws:kinesis:us-east-2:123456789012:stream/myStream";
 
+std::shared_ptr<aws::kinesis::core::ShardMapCache> temp_cache() {
+  auto path = boost::filesystem::temp_directory_path() /
+      boost::filesystem::unique_path("%%%%-%%%%-%%%%.shardmap");
+  return std::make_shared<aws::kinesis::core::ShardMapCache>(
+      path.string(),
+      std::chrono::minutes(1));
+}
+
 Aws::Client::ClientConfiguration fake_client_cfg() {
   Aws::Client::ClientConfiguration cfg;
   cfg.region = "us-west-1";
@@ -87,7 +96,8 @@ class Wrapper {
   Wrapper(
       std::list<Aws::Kinesis::Model::ListShardsOutcome> outcomes_list_shards,
       std::function<std::string(const std::string&)> stream_id_getter = [](const std::string&) { return ""; },
-      int delay = 1500)
+      int delay = 1500,
+      std::shared_ptr<aws::kinesis::core::ShardMapCache> cache = nullptr)
       : num_req_received_(0),
     mock_kinesis_client_(
                 outcomes_list_shards,
@@ -101,7 +111,8 @@ class Wrapper {
             std::make_shared<aws::metrics::NullMetricsManager>(),
             std::chrono::milliseconds(100),
             std::chrono::milliseconds(1000),
-            std::chrono::milliseconds(100)) {
+            std::chrono::milliseconds(100),
+            cache) {
 
     aws::utils::sleep_for(std::chrono::milliseconds(delay));
   }
@@ -122,8 +133,14 @@ class Wrapper {
     return mock_kinesis_client_.get_last_request();
   }
 
-  void invalidate(std::chrono::steady_clock::time_point tp, boost::optional<uint64_t> shard_id) {
-    shard_map_.invalidate(tp, shard_id);
+  void invalidate(std::chrono::steady_clock::time_point tp,
+                  boost::optional<uint64_t> shard_id,
+                  boost::optional<uint64_t> actual_shard_id = boost::none) {
+    shard_map_.invalidate(tp, shard_id, actual_shard_id);
+  }
+
+  uint64_t epoch() {
+    return shard_map_.epoch();
   }
 
  private:
@@ -735,11 +752,15 @@ BOOST_AUTO_TEST_CASE(Invalidate) {
       3);
 
 
+  BOOST_CHECK_EQUAL(wrapper.epoch(), 1);
+
   // On the other hand, calling invalidate with a timestamp after the last
   // update should actually invalidate it and trigger an update.
   wrapper.invalidate(std::chrono::steady_clock::now(), {});
 
-  BOOST_CHECK(!wrapper.shard_id("0"));
+  // The previous snapshot keeps being served while the update is in progress.
+  BOOST_CHECK_EQUAL(*wrapper.shard_id("0"), 2);
+  BOOST_CHECK_EQUAL(wrapper.epoch(), 1);
 
   // Calling invalidate again during update should not trigger more requests.
   for (int i = 0; i < 5; i++) {
@@ -747,10 +768,12 @@ BOOST_AUTO_TEST_CASE(Invalidate) {
     aws::utils::sleep_for(std::chrono::milliseconds(2));
   }
 
-  BOOST_CHECK(!wrapper.shard_id("0"));
+  BOOST_CHECK_EQUAL(*wrapper.shard_id("0"), 2);
 
   aws::utils::sleep_for(std::chrono::milliseconds(500));
 
+  BOOST_CHECK_EQUAL(wrapper.epoch(), 2);
+
   // A new shard map should've been fetched
   BOOST_CHECK_EQUAL(
       *wrapper.shard_id("170141183460469231731687303715884105728"),
@@ -887,7 +910,7 @@ BOOST_AUTO_TEST_CASE(InvalidateWithShard) {
   //it should result in an update
   wrapper.invalidate(std::chrono::steady_clock::now(), boost::optional<uint64_t>(1));
 
-  BOOST_CHECK(!wrapper.shard_id("0"));
+  BOOST_CHECK_EQUAL(*wrapper.shard_id("0"), 2);
 
   // Calling invalidate again during update should not trigger more requests.
   for (int i = 0; i < 5; i++) {
@@ -895,7 +918,7 @@ BOOST_AUTO_TEST_CASE(InvalidateWithShard) {
     aws::utils::sleep_for(std::chrono::milliseconds(2));
   }
 
-  BOOST_CHECK(!wrapper.shard_id("0"));
+  BOOST_CHECK_EQUAL(*wrapper.shard_id("0"), 2);
 
   aws::utils::sleep_for(std::chrono::milliseconds(500));
 
@@ -1006,6 +1029,320 @@ BOOST_AUTO_TEST_CASE(ClosedParentShardsAreRemovedAfterSomeTime) {
       2);
 }
 
+BOOST_AUTO_TEST_CASE(IncrementalUpdateOnSplit) {
+  std::list<Aws::Kinesis::Model::ListShardsOutcome> outcomes_list_shards;
+  outcomes_list_shards.push_back(
+        success_outcome<Aws::Kinesis::Model::ListShardsResult,Aws::Kinesis::Model::ListShardsOutcome>(R"XXXX({
+      "Shards": [
+        {
+          "HashKeyRange": {
+            "EndingHashKey": "340282366920938463463374607431768211455",
+            "StartingHashKey": "170141183460469231731687303715884105728"
+          },
+          "ShardId": "shardId-000000000001",
+          "SequenceNumberRange": {
+            "StartingSequenceNumber": "49549167410945534708633744510750617797212193316405248018"
+          }
+        },
+        {
+          "HashKeyRange": {
+            "EndingHashKey": "85070591730234615865843651857942052862",
+            "StartingHashKey": "0"
+          },
+          "ShardId": "shardId-000000000002",
+          "ParentShardId": "shardId-000000000000",
+          "SequenceNumberRange": {
+            "StartingSequenceNumber": "49549169978943246555030591128013184047489460388642160674"
+          }
+        },
+        {
+          "HashKeyRange": {
+            "EndingHashKey": "170141183460469231731687303715884105727",
+            "StartingHashKey": "85070591730234615865843651857942052863"
+          },
+          "ShardId": "shardId-000000000003",
+          "ParentShardId": "shardId-000000000000",
+          "SequenceNumberRange": {
+            "StartingSequenceNumber": "49549169978965547300229121751154719765762108750148141106"
+          }
+        }
+      ]
+  })XXXX"));
+
+  // Shard 1 was split into 4 and 5.
+  outcomes_list_shards.push_back(
+        success_outcome<Aws::Kinesis::Model::ListShardsResult,Aws::Kinesis::Model::ListShardsOutcome>(R"XXXX({
+      "Shards": [
+        {
+          "HashKeyRange": {
+            "EndingHashKey": "255211775190703847597530955573826158591",
+            "StartingHashKey": "170141183460469231731687303715884105728"
+          },
+          "ShardId": "shardId-000000000004",
+          "ParentShardId": "shardId-000000000001",
+          "SequenceNumberRange": {
+            "StartingSequenceNumber": "49549169978987848045427652374296255484034757111654121538"
+          }
+        },
+        {
+          "HashKeyRange": {
+            "EndingHashKey": "340282366920938463463374607431768211455",
+            "StartingHashKey": "255211775190703847597530955573826158592"
+          },
+          "ShardId": "shardId-000000000005",
+          "ParentShardId": "shardId-000000000001",
+          "SequenceNumberRange": {
+            "StartingSequenceNumber": "49549169979010148790626182997437791202307405473160101970"
+          }
+        }
+      ]
+  })XXXX"));
+
+  Wrapper wrapper(outcomes_list_shards);
+
+  BOOST_CHECK_EQUAL(wrapper.epoch(), 1);
+
+  // A record predicted for shard 1 ended up in shard 4.
+  wrapper.invalidate(std::chrono::steady_clock::now(),
+                     boost::optional<uint64_t>(1),
+                     boost::optional<uint64_t>(4));
+
+  aws::utils::sleep_for(std::chrono::milliseconds(500));
+
+  // Only the shards after the newest known one should have been listed.
+  auto& filter = wrapper.get_last_request().GetShardFilter();
+  BOOST_CHECK(filter.GetType() == Aws::Kinesis::Model::ShardFilterType::AFTER_SHARD_ID);
+  BOOST_CHECK_EQUAL(filter.GetShardId(), "shardId-000000000003");
+
+  BOOST_CHECK_EQUAL(wrapper.epoch(), 2);
+
+  BOOST_CHECK_EQUAL(
+      *wrapper.shard_id("170141183460469231731687303715884105728"),
+      4);
+  BOOST_CHECK_EQUAL(
+      *wrapper.shard_id("255211775190703847597530955573826158591"),
+      4);
+  BOOST_CHECK_EQUAL(
+      *wrapper.shard_id("255211775190703847597530955573826158592"),
+      5);
+  BOOST_CHECK_EQUAL(
+      *wrapper.shard_id("340282366920938463463374607431768211455"),
+      5);
+  BOOST_CHECK_EQUAL(
+      *wrapper.shard_id("0"),
+      2);
+  BOOST_CHECK_EQUAL(
+      *wrapper.shard_id("170141183460469231731687303715884105727"),
+      3);
+
+  BOOST_CHECK_EQUAL(
+      wrapper.num_req_received(),
+      2);
+}
+
+BOOST_AUTO_TEST_CASE(IncrementalUpdateFallsBackToFullUpdate) {
+  std::list<Aws::Kinesis::Model::ListShardsOutcome> outcomes_list_shards;
+  outcomes_list_shards.push_back(
+        success_outcome<Aws::Kinesis::Model::ListShardsResult,Aws::Kinesis::Model::ListShardsOutcome>(R"XXXX({
+      "Shards": [
+        {
+          "HashKeyRange": {
+            "EndingHashKey": "340282366920938463463374607431768211455",
+            "StartingHashKey": "170141183460469231731687303715884105728"
+          },
+          "ShardId": "shardId-000000000001",
+          "SequenceNumberRange": {
+            "StartingSequenceNumber": "49549167410945534708633744510750617797212193316405248018"
+          }
+        },
+        {
+          "HashKeyRange": {
+            "EndingHashKey": "85070591730234615865843651857942052862",
+            "StartingHashKey": "0"
+          },
+          "ShardId": "shardId-000000000002",
+          "ParentShardId": "shardId-000000000000",
+          "SequenceNumberRange": {
+            "StartingSequenceNumber": "49549169978943246555030591128013184047489460388642160674"
+          }
+        },
+        {
+          "HashKeyRange": {
+            "EndingHashKey": "170141183460469231731687303715884105727",
+            "StartingHashKey": "85070591730234615865843651857942052863"
+          },
+          "ShardId": "shardId-000000000003",
+          "ParentShardId": "shardId-000000000000",
+          "SequenceNumberRange": {
+            "StartingSequenceNumber": "49549169978965547300229121751154719765762108750148141106"
+          }
+        }
+      ]
+  })XXXX"));
+
+  // Only one of the children of shard 1 is returned, which leaves a hole in
+  // the hash key space.
+  outcomes_list_shards.push_back(
+        success_outcome<Aws::Kinesis::Model::ListShardsResult,Aws::Kinesis::Model::ListShardsOutcome>(R"XXXX({
+      "Shards": [
+        {
+          "HashKeyRange": {
+            "EndingHashKey": "255211775190703847597530955573826158591",
+            "StartingHashKey": "170141183460469231731687303715884105728"
+          },
+          "ShardId": "shardId-000000000004",
+          "ParentShardId": "shardId-000000000001",
+          "SequenceNumberRange": {
+            "StartingSequenceNumber": "49549169978987848045427652374296255484034757111654121538"
+          }
+        }
+      ]
+  })XXXX"));
+
+  outcomes_list_shards.push_back(
+        success_outcome<Aws::Kinesis::Model::ListShardsResult,Aws::Kinesis::Model::ListShardsOutcome>(R"XXXX({
+      "Shards": [
+        {
+          "HashKeyRange": {
+            "EndingHashKey": "340282366920938463463374607431768211455",
+            "StartingHashKey": "0"
+          },
+          "ShardId": "shardId-000000000008",
+          "SequenceNumberRange": {
+            "StartingSequenceNumber": "49549169979010148790626182997437791202307405473160101970"
+          }
+        }
+      ]
+  })XXXX"));
+
+  Wrapper wrapper(outcomes_list_shards);
+
+  wrapper.invalidate(std::chrono::steady_clock::now(),
+                     boost::optional<uint64_t>(1),
+                     boost::optional<uint64_t>(4));
+
+  aws::utils::sleep_for(std::chrono::milliseconds(500));
+
+  auto& filter = wrapper.get_last_request().GetShardFilter();
+  BOOST_CHECK(filter.GetType() == Aws::Kinesis::Model::ShardFilterType::AT_LATEST);
+
+  BOOST_CHECK_EQUAL(
+      *wrapper.shard_id("0"),
+      8);
+  BOOST_CHECK_EQUAL(
+      *wrapper.shard_id("340282366920938463463374607431768211455"),
+      8);
+
+  BOOST_CHECK_EQUAL(
+      wrapper.num_req_received(),
+      3);
+}
+
+BOOST_AUTO_TEST_CASE(StartsFromCache) {
+  auto cache = temp_cache();
+  cache->store({
+    {1, uint128_t(0), uint128_t("170141183460469231731687303715884105727")},
+    {2,
+     uint128_t("170141183460469231731687303715884105728"),
+     uint128_t("340282366920938463463374607431768211455")}
+  });
+
+  // Only used if the deferred refresh happens to run during the test.
+  std::list<Aws::Kinesis::Model::ListShardsOutcome> outcomes_list_shards;
+  outcomes_list_shards.push_back(
+        success_outcome<Aws::Kinesis::Model::ListShardsResult,Aws::Kinesis::Model::ListShardsOutcome>(R"XXXX({
+      "Shards": [
+        {
+          "HashKeyRange": {
+            "EndingHashKey": "170141183460469231731687303715884105727",
+            "StartingHashKey": "0"
+          },
+          "ShardId": "shardId-000000000001",
+          "SequenceNumberRange": {
+            "StartingSequenceNumber": "49549167410945534708633744510750617797212193316405248018"
+          }
+        },
+        {
+          "HashKeyRange": {
+            "EndingHashKey": "340282366920938463463374607431768211455",
+            "StartingHashKey": "170141183460469231731687303715884105728"
+          },
+          "ShardId": "shardId-000000000002",
+          "SequenceNumberRange": {
+            "StartingSequenceNumber": "49549169978943246555030591128013184047489460388642160674"
+          }
+        }
+      ]
+  })XXXX"));
+
+  Wrapper wrapper(outcomes_list_shards, [](const std::string&) { return ""; }, 0, cache);
+
+  // The cached shard map is served right away, and the refresh from Kinesis
+  // is deferred.
+  BOOST_CHECK_EQUAL(wrapper.epoch(), 1);
+  BOOST_CHECK_EQUAL(*wrapper.shard_id("0"), 1);
+  BOOST_CHECK_EQUAL(
+      *wrapper.shard_id("170141183460469231731687303715884105727"),
+      1);
+  BOOST_CHECK_EQUAL(
+      *wrapper.shard_id("170141183460469231731687303715884105728"),
+      2);
+  BOOST_CHECK_EQUAL(
+      *wrapper.shard_id("340282366920938463463374607431768211455"),
+      2);
+  BOOST_CHECK_EQUAL(wrapper.num_req_received(), 0);
+
+  boost::filesystem::remove(cache->path());
+}
+
+BOOST_AUTO_TEST_CASE(UpdateIsWrittenToCache) {
+  auto cache = temp_cache();
+
+  std::list<Aws::Kinesis::Model::ListShardsOutcome> outcomes_list_shards;
+  outcomes_list_shards.push_back(
+        success_outcome<Aws::Kinesis::Model::ListShardsResult,Aws::Kinesis::Model::ListShardsOutcome>(R"XXXX({
+      "Shards": [
+        {
+          "HashKeyRange": {
+            "EndingHashKey": "340282366920938463463374607431768211455",
+            "StartingHashKey": "170141183460469231731687303715884105728"
+          },
+          "ShardId": "shardId-000000000001",
+          "SequenceNumberRange": {
+            "StartingSequenceNumber": "49549167410945534708633744510750617797212193316405248018"
+          }
+        },
+        {
+          "HashKeyRange": {
+            "EndingHashKey": "170141183460469231731687303715884105727",
+            "StartingHashKey": "0"
+          },
+          "ShardId": "shardId-000000000002",
+          "SequenceNumberRange": {
+            "StartingSequenceNumber": "49549169978943246555030591128013184047489460388642160674"
+          }
+        }
+      ]
+  })XXXX"));
+
+  // Nothing is cached yet, so the shard map is listed as usual.
+  Wrapper wrapper(outcomes_list_shards, [](const std::string&) { return ""; }, 1500, cache);
+  BOOST_CHECK_EQUAL(wrapper.num_req_received(), 1);
+
+  auto contents = cache->load();
+  BOOST_REQUIRE(contents);
+  BOOST_REQUIRE_EQUAL(contents->shards.size(), 2);
+
+  std::map<uint64_t, uint128_t> ending_hash_keys;
+  for (auto& shard : contents->shards) {
+    ending_hash_keys[shard.shard_id] = shard.ending_hash_key;
+  }
+  BOOST_CHECK_EQUAL(ending_hash_keys[1], uint128_t("340282366920938463463374607431768211455"));
+  BOOST_CHECK_EQUAL(ending_hash_keys[2], uint128_t("170141183460469231731687303715884105727"));
+
+  boost::filesystem::remove(cache->path());
+}
+
 BOOST_AUTO_TEST_CASE(ListShards_WithoutStreamId) {
   std::list<Aws::Kinesis::Model::ListShardsOutcome> outcomes_list_shards;
   outcomes_list_shards.push_back(
@@ -0,0 +1,260 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <aws/kinesis/core/spill_log.h>
+
+namespace {
+
+using Entry = aws::kinesis::core::SpillLog::Entry;
+using Clock = aws::kinesis::core::SpillLog::Clock;
+
+const uint64_t kSegmentSize = 4096;
+
+// Removes the directory the test log lives in when the test ends.
+class TempDir {
+ public:
+  TempDir()
+      : path_(boost::filesystem::temp_directory_path() /
+              boost::filesystem::unique_path()) {}
+
+  ~TempDir() {
+    boost::system::error_code ec;
+    boost::filesystem::remove_all(path_, ec);
+  }
+
+  std::string path() const {
+    return path_.string();
+  }
+
+  size_t segments() const {
+    size_t n = 0;
+    boost::system::error_code ec;
+    boost::filesystem::directory_iterator it(path_, ec), end;
+    for (; !ec && it != end; it.increment(ec)) {
+      n++;
+    }
+    return n;
+  }
+
+ private:
+  boost::filesystem::path path_;
+};
+
+Entry make_entry(uint64_t id, size_t data_size = 100) {
+  Entry e;
+  e.source_id = id;
+  e.partition_key = "pk" + std::to_string(id);
+  if (id % 2) {
+    e.explicit_hash_key = std::to_string(id * 1000);
+  }
+  e.data = std::string(data_size, 'a' + id % 26);
+  auto now = std::chrono::time_point_cast<std::chrono::milliseconds>(
+      Clock::now());
+  e.deadline = now + std::chrono::milliseconds(id);
+  e.expiration = now + std::chrono::seconds(30);
+  return e;
+}
+
+// Bytes the record takes up in a segment.
+size_t frame_size(const Entry& e) {
+  return 8 + 36 + e.partition_key.size() + e.explicit_hash_key.size() +
+      e.data.size();
+}
+
+void check_entry(const Entry& e, uint64_t id, size_t data_size = 100) {
+  auto expected = make_entry(id, data_size);
+  BOOST_CHECK_EQUAL(e.source_id, id);
+  BOOST_CHECK_EQUAL(e.partition_key, expected.partition_key);
+  BOOST_CHECK_EQUAL(e.explicit_hash_key, expected.explicit_hash_key);
+  BOOST_CHECK(e.data == expected.data);
+  BOOST_CHECK(e.expiration > e.deadline);
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(SpillLog)
+
+BOOST_AUTO_TEST_CASE(InOrder) {
+  TempDir dir;
+  aws::kinesis::core::SpillLog log(dir.path(), 1 << 20, false, kSegmentSize);
+  BOOST_CHECK(log.empty());
+
+  // Spans several segments.
+  for (uint64_t i = 0; i < 100; i++) {
+    BOOST_REQUIRE(log.append(make_entry(i)));
+  }
+  BOOST_CHECK_EQUAL(log.size(), 100);
+  BOOST_CHECK_GT(dir.segments(), 2);
+
+  Entry e;
+  for (uint64_t i = 0; i < 100; i++) {
+    BOOST_REQUIRE(log.take(e));
+    check_entry(e, i);
+    BOOST_CHECK(!e.recovered);
+  }
+  BOOST_CHECK(!log.take(e));
+  BOOST_CHECK(log.empty());
+  // Read segments are deleted, except the last which is reused.
+  BOOST_CHECK_EQUAL(dir.segments(), 1);
+
+  BOOST_REQUIRE(log.append(make_entry(7)));
+  BOOST_REQUIRE(log.take(e));
+  check_entry(e, 7);
+}
+
+BOOST_AUTO_TEST_CASE(Interleaved) {
+  TempDir dir;
+  aws::kinesis::core::SpillLog log(dir.path(), 1 << 20, false, kSegmentSize);
+  uint64_t next_append = 0;
+  uint64_t next_take = 0;
+  Entry e;
+  for (int round = 0; round < 50; round++) {
+    for (int i = 0; i < 3; i++) {
+      BOOST_REQUIRE(log.append(make_entry(next_append++)));
+    }
+    for (int i = 0; i < 2; i++) {
+      BOOST_REQUIRE(log.take(e));
+      check_entry(e, next_take++);
+    }
+  }
+  BOOST_CHECK_EQUAL(log.size(), next_append - next_take);
+  while (log.take(e)) {
+    check_entry(e, next_take++);
+  }
+  BOOST_CHECK_EQUAL(next_take, next_append);
+}
+
+BOOST_AUTO_TEST_CASE(Full) {
+  TempDir dir;
+  aws::kinesis::core::SpillLog log(dir.path(),
+                                   2 * kSegmentSize,
+                                   false,
+                                   kSegmentSize);
+  uint64_t n = 0;
+  while (log.append(make_entry(n))) {
+    n++;
+  }
+  BOOST_CHECK_GT(n, 40);
+  BOOST_CHECK_EQUAL(dir.segments(), 2);
+
+  // A record bigger than a segment gets its own, if there's room.
+  Entry e;
+  BOOST_REQUIRE(log.take(e));
+  BOOST_CHECK(!log.append(make_entry(1000, 2 * kSegmentSize)));
+}
+
+BOOST_AUTO_TEST_CASE(LargeRecord) {
+  TempDir dir;
+  aws::kinesis::core::SpillLog log(dir.path(), 1 << 20, false, kSegmentSize);
+  BOOST_REQUIRE(log.append(make_entry(1)));
+  BOOST_REQUIRE(log.append(make_entry(2, 3 * kSegmentSize)));
+  BOOST_REQUIRE(log.append(make_entry(3)));
+
+  Entry e;
+  BOOST_REQUIRE(log.take(e));
+  check_entry(e, 1);
+  BOOST_REQUIRE(log.take(e));
+  check_entry(e, 2, 3 * kSegmentSize);
+  BOOST_REQUIRE(log.take(e));
+  check_entry(e, 3);
+}
+
+BOOST_AUTO_TEST_CASE(DeletedUnlessKept) {
+  TempDir dir;
+  {
+    aws::kinesis::core::SpillLog log(dir.path(), 1 << 20, false, kSegmentSize);
+    BOOST_REQUIRE(log.append(make_entry(1)));
+  }
+  BOOST_CHECK(!boost::filesystem::exists(dir.path()));
+
+  // Leftovers from a kept log are deleted too when not keeping.
+  {
+    aws::kinesis::core::SpillLog log(dir.path(), 1 << 20, true, kSegmentSize);
+    BOOST_REQUIRE(log.append(make_entry(1)));
+  }
+  aws::kinesis::core::SpillLog log(dir.path(), 1 << 20, false, kSegmentSize);
+  BOOST_CHECK(log.empty());
+  Entry e;
+  BOOST_CHECK(!log.take(e));
+}
+
+BOOST_AUTO_TEST_CASE(Recover) {
+  TempDir dir;
+  {
+    aws::kinesis::core::SpillLog log(dir.path(), 1 << 20, true, kSegmentSize);
+    for (uint64_t i = 0; i < 100; i++) {
+      BOOST_REQUIRE(log.append(make_entry(i)));
+    }
+    Entry e;
+    for (uint64_t i = 0; i < 60; i++) {
+      BOOST_REQUIRE(log.take(e));
+    }
+  }
+
+  aws::kinesis::core::SpillLog log(dir.path(), 1 << 20, true, kSegmentSize);
+  BOOST_CHECK_EQUAL(log.size(), 40);
+  // New records go after the recovered ones.
+  BOOST_REQUIRE(log.append(make_entry(100)));
+
+  Entry e;
+  for (uint64_t i = 60; i < 100; i++) {
+    BOOST_REQUIRE(log.take(e));
+    check_entry(e, i);
+    BOOST_CHECK(e.recovered);
+  }
+  BOOST_REQUIRE(log.take(e));
+  check_entry(e, 100);
+  BOOST_CHECK(!e.recovered);
+  BOOST_CHECK(!log.take(e));
+}
+
+BOOST_AUTO_TEST_CASE(RecoverCorrupted) {
+  TempDir dir;
+  {
+    aws::kinesis::core::SpillLog log(dir.path(), 1 << 20, true, kSegmentSize);
+    for (uint64_t i = 0; i < 10; i++) {
+      BOOST_REQUIRE(log.append(make_entry(i)));
+    }
+  }
+
+  // Flip a byte in the data of the fourth record.
+  size_t offset = 32;
+  for (uint64_t i = 0; i < 4; i++) {
+    offset += frame_size(make_entry(i));
+  }
+  boost::filesystem::directory_iterator it(dir.path());
+  {
+    std::fstream f(it->path().string(),
+                   std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(offset - 1);
+    f.put('!');
+  }
+
+  aws::kinesis::core::SpillLog log(dir.path(), 1 << 20, true, kSegmentSize);
+  BOOST_CHECK_EQUAL(log.size(), 3);
+  Entry e;
+  for (uint64_t i = 0; i < 3; i++) {
+    BOOST_REQUIRE(log.take(e));
+    check_entry(e, i);
+  }
+  BOOST_CHECK(!log.take(e));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
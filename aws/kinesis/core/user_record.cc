@@ -23,7 +23,9 @@ namespace core {
 
 UserRecord::UserRecord(aws::kinesis::protobuf::Message& m)
     : hash_key_(0),
-      finished_(false) {
+      finished_(false),
+      recovered_(false),
+      flush_epoch_(0) {
   if (!m.has_put_record()) {
     throw std::runtime_error("Message is not a PutRecord");
   }
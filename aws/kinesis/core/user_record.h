@@ -70,6 +70,25 @@ class UserRecord : public aws::utils::TimeSensitive {
     return finished_;
   }
 
+  // Read back from a spill log left by an earlier run of the daemon. Its
+  // source id belongs to that run's wrapper, so its result is not returned.
+  bool recovered() const noexcept {
+    return recovered_;
+  }
+
+  void set_recovered() noexcept {
+    recovered_ = true;
+  }
+
+  // The flush epoch the record was accepted in; see FlushTracker.
+  uint64_t flush_epoch() const noexcept {
+    return flush_epoch_;
+  }
+
+  void flush_epoch(uint64_t epoch) noexcept {
+    flush_epoch_ = epoch;
+  }
+
   boost::optional<uint64_t> predicted_shard() const noexcept {
     return predicted_shard_;
   }
@@ -110,6 +129,8 @@ class UserRecord : public aws::utils::TimeSensitive {
   boost::optional<uint64_t> predicted_shard_;
   bool has_explicit_hash_key_;
   bool finished_;
+  bool recovered_;
+  uint64_t flush_epoch_;
 };
 
 } //namespace core
@@ -32,9 +32,12 @@
 
 #include <aws/auth/mutable_static_creds_provider.h>
 
+#include <aws/kinesis/core/connection_monitor.h>
 #include <aws/kinesis/core/kinesis_producer.h>
+#include <aws/utils/cpu_affinity.h>
 #include <aws/utils/io_service_executor.h>
 #include <aws/utils/logging.h>
+#include <aws/utils/multi_reactor_executor.h>
 #include <aws/utils/signal_handler.h>
 
 #include <aws/core/Aws.h>
@@ -294,14 +297,35 @@ get_creds_providers() {
   return std::make_pair(kinesis_creds_provider, cw_creds_provider);
 }
 
-std::shared_ptr<aws::utils::Executor> get_executor() {
+std::shared_ptr<aws::utils::Executor>
+get_executor(const aws::kinesis::core::Configuration& config) {
   int cores = aws::thread::hardware_concurrency();
-  int workers = std::min(8, std::max(1, cores - 2));
-  return std::make_shared<aws::utils::IoServiceExecutor>(workers);
+  size_t workers = config.executor_threads();
+  if (workers == 0) {
+    workers = std::min(8, std::max(1, cores - 2));
+  }
+  LOG(info) << "Using " << workers << " executor threads";
+
+  aws::utils::Executor::ThreadInit init;
+  aws::utils::ThreadPlacement placement(
+      aws::utils::parse_cpu_list(config.executor_thread_cpus()),
+      config.numa_bind_memory());
+  if (!placement.empty()) {
+    LOG(info) << "Pinning executor threads to CPUs "
+              << config.executor_thread_cpus();
+    init = [placement](size_t i) { placement.apply(i); };
+  }
+
+  if (config.executor_multi_reactor()) {
+    return std::make_shared<aws::utils::MultiReactorExecutor>(workers, init);
+  }
+  return std::make_shared<aws::utils::IoServiceExecutor>(workers, init);
 }
 
 std::shared_ptr<aws::kinesis::core::IpcManager>
-get_ipc_manager(std::string in_file, std::string out_file) {
+get_ipc_manager(std::string in_file,
+                std::string out_file,
+                const aws::kinesis::core::Configuration& config) {
   check_pipe(in_file);
   check_pipe(out_file);
 
@@ -309,7 +333,11 @@ get_ipc_manager(std::string in_file, std::string out_file) {
       std::make_shared<aws::kinesis::core::detail::IpcChannel>(
           in_file,
           out_file);
-  return std::make_shared<aws::kinesis::core::IpcManager>(ipc_channel);
+  return std::make_shared<aws::kinesis::core::IpcManager>(
+      ipc_channel,
+      aws::utils::ThreadPlacement(
+          aws::utils::parse_cpu_list(config.ipc_thread_cpus()),
+          config.numa_bind_memory()));
 }
 
 void set_core_limit(bool enable) {
@@ -384,6 +412,7 @@ int main(int argc, char* const* argv) {
   aws::utils::setup_logging(options.boost_log_level);
   aws::utils::setup_aws_logging(options.aws_log_level);
   Aws::SDKOptions sdk_options;
+  aws::kinesis::core::ConnectionMonitor::install(sdk_options);
   Aws::InitAPI(sdk_options);
   {
     if (options.enable_stack_trace) {
@@ -398,10 +427,11 @@ int main(int argc, char* const* argv) {
       }
       aws::utils::set_log_level(config->log_level());
 
-      auto executor = get_executor();
+      auto executor = get_executor(*config);
       auto region = get_region(*config);
       auto creds_providers = get_creds_providers();
-      auto ipc_manager = get_ipc_manager(options.output_pipe, options.input_pipe);
+      auto ipc_manager =
+          get_ipc_manager(options.output_pipe, options.input_pipe, *config);
       auto ca_path = get_ca_path();
       auto ca_file = get_ca_file();
       LOG(info) << "Starting up main producer";
@@ -29,6 +29,8 @@ bool filter(const std::vector<std::pair<std::string, std::string>>& dimensions,
 
           LEVEL( UserRecordsReceived, Detailed )
           LEVEL( UserRecordsPending, Detailed )
+          LEVEL( BufferedBytes, Detailed )
+          LEVEL( UserRecordsSpilled, Detailed )
           LEVEL( UserRecordsPut, Summary )
           LEVEL( UserRecordsDataPut, Detailed )
 
@@ -43,6 +45,21 @@ bool filter(const std::vector<std::pair<std::string, std::string>>& dimensions,
           LEVEL( BufferingTime, Summary )
           LEVEL( RequestTime, Detailed )
 
+          LEVEL( ConnectionsEstablished, Detailed )
+          LEVEL( ConnectionHandshakeTime, Detailed )
+
+          LEVEL( ExecutorQueueDepth, Detailed )
+          LEVEL( ExecutorTaskWaitTimeP50, Detailed )
+          LEVEL( ExecutorTaskWaitTimeP99, Detailed )
+          LEVEL( ExecutorTaskWaitTimeMax, Detailed )
+          LEVEL( ExecutorTaskRunTimeP50, Detailed )
+          LEVEL( ExecutorTaskRunTimeP99, Detailed )
+          LEVEL( ExecutorTaskRunTimeMax, Detailed )
+          LEVEL( ExecutorTimerLatenessP50, Detailed )
+          LEVEL( ExecutorTimerLatenessP99, Detailed )
+          LEVEL( ExecutorTimerLatenessMax, Detailed )
+          LEVEL( CrossNodeBatches, Detailed )
+
           LEVEL( UserRecordsPerKinesisRecord, Detailed )
           LEVEL( KinesisRecordsPerPutRecordsRequest, Detailed )
           LEVEL( UserRecordsPerPutRecordsRequest, Detailed );
@@ -89,6 +106,8 @@ std::string unit(const std::string& name) {
 
           UNIT( UserRecordsReceived, Count )
           UNIT( UserRecordsPending, Count )
+          UNIT( BufferedBytes, Bytes )
+          UNIT( UserRecordsSpilled, Count )
           UNIT( UserRecordsPut, Count )
           UNIT( UserRecordsDataPut, Bytes )
 
@@ -103,6 +122,21 @@ std::string unit(const std::string& name) {
           UNIT( BufferingTime, Milliseconds )
           UNIT( RequestTime, Milliseconds )
 
+          UNIT( ConnectionsEstablished, Count )
+          UNIT( ConnectionHandshakeTime, Milliseconds )
+
+          UNIT( ExecutorQueueDepth, Count )
+          UNIT( ExecutorTaskWaitTimeP50, Milliseconds )
+          UNIT( ExecutorTaskWaitTimeP99, Milliseconds )
+          UNIT( ExecutorTaskWaitTimeMax, Milliseconds )
+          UNIT( ExecutorTaskRunTimeP50, Milliseconds )
+          UNIT( ExecutorTaskRunTimeP99, Milliseconds )
+          UNIT( ExecutorTaskRunTimeMax, Milliseconds )
+          UNIT( ExecutorTimerLatenessP50, Milliseconds )
+          UNIT( ExecutorTimerLatenessP99, Milliseconds )
+          UNIT( ExecutorTimerLatenessMax, Milliseconds )
+          UNIT( CrossNodeBatches, Count )
+
           UNIT( UserRecordsPerKinesisRecord, Count )
           UNIT( KinesisRecordsPerPutRecordsRequest, Count )
           UNIT( UserRecordsPerPutRecordsRequest, Count );
@@ -47,6 +47,8 @@ struct Names {
 
   DEF_NAME(UserRecordsReceived);
   DEF_NAME(UserRecordsPending);
+  DEF_NAME(BufferedBytes);
+  DEF_NAME(UserRecordsSpilled);
   DEF_NAME(UserRecordsPut);
   DEF_NAME(UserRecordsDataPut);
 
@@ -61,6 +63,21 @@ struct Names {
   DEF_NAME(BufferingTime);
   DEF_NAME(RequestTime);
 
+  DEF_NAME(ConnectionsEstablished);
+  DEF_NAME(ConnectionHandshakeTime);
+
+  DEF_NAME(ExecutorQueueDepth);
+  DEF_NAME(ExecutorTaskWaitTimeP50);
+  DEF_NAME(ExecutorTaskWaitTimeP99);
+  DEF_NAME(ExecutorTaskWaitTimeMax);
+  DEF_NAME(ExecutorTaskRunTimeP50);
+  DEF_NAME(ExecutorTaskRunTimeP99);
+  DEF_NAME(ExecutorTaskRunTimeMax);
+  DEF_NAME(ExecutorTimerLatenessP50);
+  DEF_NAME(ExecutorTimerLatenessP99);
+  DEF_NAME(ExecutorTimerLatenessMax);
+  DEF_NAME(CrossNodeBatches);
+
   DEF_NAME(UserRecordsPerKinesisRecord);
   DEF_NAME(KinesisRecordsPerPutRecordsRequest);
   DEF_NAME(UserRecordsPerPutRecordsRequest);
@@ -78,6 +95,7 @@ struct DimensionNames {
   DEF_NAME(StreamName);
   DEF_NAME(ShardId);
   DEF_NAME(ErrorCode);
+  DEF_NAME(TaskPriority);
 };
 #undef DEF_NAME
 
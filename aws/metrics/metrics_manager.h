@@ -92,6 +92,13 @@ class MetricsFinderBuilder {
     return *this;
   }
 
+  MetricsFinderBuilder& set_task_priority(std::string priority) {
+    assert(state_ == HAS_NAME);
+    state_ = HAS_TASK_PRIORITY;
+    mf_.push_dimension(constants::DimensionNames::TaskPriority, priority);
+    return *this;
+  }
+
   std::shared_ptr<Metric> find();
 
  private:
@@ -99,6 +106,7 @@ class MetricsFinderBuilder {
     EMPTY,
     HAS_NAME,
     HAS_ERR_CODE,
+    HAS_TASK_PRIORITY,
     HAS_STREAM,
     HAS_SHARD
   };
@@ -165,7 +173,8 @@ class MetricsManager {
               next_run_ += upload_frequency_;
               scheduled_upload_->reschedule(next_run_);
             },
-            next_run_);
+            next_run_,
+            aws::utils::Priority::Low);
   }
 
   virtual detail::MetricsFinderBuilder finder() {
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <aws/utils/base64.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace aws {
+namespace utils {
+
+namespace {
+
+const char kAlphabet[] =
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// The two characters for each 12 bit value, so that every 3 bytes of input
+// take two lookups and two 2 byte copies.
+struct PairTable {
+  PairTable() {
+    for (size_t i = 0; i < 4096; i++) {
+      pairs[2 * i] = kAlphabet[i >> 6];
+      pairs[2 * i + 1] = kAlphabet[i & 0x3F];
+    }
+  }
+
+  char pairs[2 * 4096];
+};
+
+const char* pairs() {
+  static const PairTable table;
+  return table.pairs;
+}
+
+} //namespace
+
+void base64_encode(const char* data, size_t len, std::string& out) {
+  auto start = out.size();
+  out.resize(start + base64_encoded_size(len));
+  auto dst = &out[start];
+  auto src = reinterpret_cast<const unsigned char*>(data);
+  auto table = pairs();
+
+  size_t i = 0;
+  for (; i + 3 <= len; i += 3) {
+    uint32_t v = (uint32_t) src[i] << 16 | (uint32_t) src[i + 1] << 8 |
+        src[i + 2];
+    std::memcpy(dst, table + 2 * (v >> 12), 2);
+    std::memcpy(dst + 2, table + 2 * (v & 0xFFF), 2);
+    dst += 4;
+  }
+
+  if (i < len) {
+    uint32_t v = (uint32_t) src[i] << 16;
+    if (i + 1 < len) {
+      v |= (uint32_t) src[i + 1] << 8;
+    }
+    dst[0] = kAlphabet[v >> 18];
+    dst[1] = kAlphabet[(v >> 12) & 0x3F];
+    dst[2] = i + 1 < len ? kAlphabet[(v >> 6) & 0x3F] : '=';
+    dst[3] = '=';
+  }
+}
+
+} //namespace utils
+} //namespace aws
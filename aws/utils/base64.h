@@ -0,0 +1,36 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_UTILS_BASE64_H_
+#define AWS_UTILS_BASE64_H_
+
+#include <cstddef>
+#include <string>
+
+namespace aws {
+namespace utils {
+
+inline size_t base64_encoded_size(size_t len) {
+  return (len + 2) / 3 * 4;
+}
+
+// Appends the standard (RFC 4648, padded) base64 encoding of the len bytes at
+// data to out.
+void base64_encode(const char* data, size_t len, std::string& out);
+
+} //namespace utils
+} //namespace aws
+
+#endif //AWS_UTILS_BASE64_H_
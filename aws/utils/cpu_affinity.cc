@@ -0,0 +1,191 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <aws/utils/cpu_affinity.h>
+
+#include <cerrno>
+#include <fstream>
+#include <stdexcept>
+
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/predef.h>
+
+#include <aws/utils/logging.h>
+
+#if BOOST_OS_LINUX
+#include <pthread.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace aws {
+namespace utils {
+
+namespace {
+
+// Same as MPOL_PREFERRED in <numaif.h>, which is part of libnuma rather than
+// the kernel headers.
+constexpr const int kMpolPreferred = 1;
+
+// Limits on CPU and node ids; a node mask is a single unsigned long.
+constexpr const size_t kMaxCpus = 1024;
+constexpr const int kMaxNumaNodes = 63;
+
+size_t parse_cpu(const std::string& s, const std::string& list) {
+  size_t pos = 0;
+  unsigned long cpu = 0;
+  try {
+    cpu = std::stoul(s, &pos);
+  } catch (const std::exception&) {
+    pos = 0;
+  }
+  if (s.empty() || pos != s.size() || cpu >= kMaxCpus) {
+    throw std::runtime_error("Invalid CPU \"" + s + "\" in CPU list \"" +
+                             list + "\"");
+  }
+  return cpu;
+}
+
+// cpu_to_node()[cpu] is the node of cpu, or -1.
+const std::vector<int>& cpu_to_node() {
+  static const std::vector<int> map = [] {
+    std::vector<int> m;
+#if BOOST_OS_LINUX
+    for (int node = 0; node < kMaxNumaNodes; node++) {
+      std::ifstream f("/sys/devices/system/node/node" + std::to_string(node) +
+                      "/cpulist");
+      if (!f) {
+        continue;
+      }
+      std::string list;
+      std::getline(f, list);
+      try {
+        for (auto cpu : parse_cpu_list(list)) {
+          if (cpu >= m.size()) {
+            m.resize(cpu + 1, -1);
+          }
+          m[cpu] = node;
+        }
+      } catch (const std::exception& e) {
+        LOG(warning) << e.what();
+      }
+    }
+#endif
+    return m;
+  }();
+  return map;
+}
+
+} //namespace
+
+std::vector<size_t> parse_cpu_list(const std::string& list) {
+  std::vector<size_t> cpus;
+  auto trimmed = boost::trim_copy(list);
+  if (trimmed.empty()) {
+    return cpus;
+  }
+
+  std::vector<std::string> ranges;
+  boost::split(ranges, trimmed, [](char c) { return c == ','; });
+  for (auto& r : ranges) {
+    boost::trim(r);
+    auto dash = r.find('-');
+    if (dash == std::string::npos) {
+      cpus.push_back(parse_cpu(r, list));
+      continue;
+    }
+    auto first = parse_cpu(r.substr(0, dash), list);
+    auto last = parse_cpu(r.substr(dash + 1), list);
+    if (last < first) {
+      throw std::runtime_error("Invalid range \"" + r + "\" in CPU list \"" +
+                               list + "\"");
+    }
+    for (auto cpu = first; cpu <= last; cpu++) {
+      cpus.push_back(cpu);
+    }
+  }
+  return cpus;
+}
+
+int numa_node_of_cpu(size_t cpu) {
+  auto& m = cpu_to_node();
+  return cpu < m.size() ? m[cpu] : -1;
+}
+
+int current_numa_node() {
+#if BOOST_OS_LINUX
+  auto cpu = sched_getcpu();
+  if (cpu >= 0) {
+    return numa_node_of_cpu(cpu);
+  }
+#endif
+  return -1;
+}
+
+void ThreadPlacement::apply() const {
+  if (!empty()) {
+    place(cpus_);
+  }
+}
+
+void ThreadPlacement::apply(size_t index) const {
+  if (!empty()) {
+    place({cpus_[index % cpus_.size()]});
+  }
+}
+
+void ThreadPlacement::place(const std::vector<size_t>& cpus) const {
+#if BOOST_OS_LINUX
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  for (auto cpu : cpus) {
+    CPU_SET(cpu, &set);
+  }
+  auto ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+  if (ret != 0) {
+    LOG(warning) << "Could not set CPU affinity, error " << ret;
+    return;
+  }
+
+  if (!bind_memory_) {
+    return;
+  }
+
+  // Only bind memory if the CPUs are all on one node; for a set spanning
+  // nodes the default policy of allocating locally is the best we can do.
+  auto node = numa_node_of_cpu(cpus.front());
+  for (auto cpu : cpus) {
+    if (numa_node_of_cpu(cpu) != node) {
+      node = -1;
+    }
+  }
+  if (node < 0) {
+    return;
+  }
+  unsigned long mask = 1ul << node;
+  if (syscall(SYS_set_mempolicy, kMpolPreferred, &mask, kMaxNumaNodes + 1) !=
+      0) {
+    LOG(warning) << "Could not prefer memory from NUMA node " << node
+                 << ", errno " << errno;
+  }
+#else
+  LOG(warning) << "CPU affinity is not supported on this platform";
+#endif
+}
+
+} //namespace utils
+} //namespace aws
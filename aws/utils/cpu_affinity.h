@@ -0,0 +1,72 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_UTILS_CPU_AFFINITY_H_
+#define AWS_UTILS_CPU_AFFINITY_H_
+
+#include <string>
+#include <vector>
+
+namespace aws {
+namespace utils {
+
+// Parses a list of CPUs in the format of taskset and /sys, e.g. "0-3,8,10-11".
+// Throws std::runtime_error if the list is malformed. An empty string gives an
+// empty set.
+std::vector<size_t> parse_cpu_list(const std::string& list);
+
+// NUMA node a CPU belongs to, or -1 if unknown (e.g. not Linux).
+int numa_node_of_cpu(size_t cpu);
+
+// NUMA node of the CPU the calling thread is running on, or -1 if unknown.
+int current_numa_node();
+
+// Where a group of threads runs: a set of CPUs, and optionally memory from the
+// NUMA node of those CPUs. All of it is best effort; failures are logged and
+// the thread keeps running wherever the OS puts it.
+class ThreadPlacement {
+ public:
+  ThreadPlacement() = default;
+
+  ThreadPlacement(std::vector<size_t> cpus, bool bind_memory)
+      : cpus_(std::move(cpus)),
+        bind_memory_(bind_memory) {}
+
+  bool empty() const noexcept {
+    return cpus_.empty();
+  }
+
+  const std::vector<size_t>& cpus() const noexcept {
+    return cpus_;
+  }
+
+  // Restricts the calling thread to all of the CPUs.
+  void apply() const;
+
+  // Pins the calling thread to a single CPU, the index-th of the set (wrapping
+  // around), so a pool of threads is spread over the set one per CPU.
+  void apply(size_t index) const;
+
+ private:
+  void place(const std::vector<size_t>& cpus) const;
+
+  std::vector<size_t> cpus_;
+  bool bind_memory_ = false;
+};
+
+} //namespace utils
+} //namespace aws
+
+#endif //AWS_UTILS_CPU_AFFINITY_H_
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <aws/utils/elastic_thread_executor.h>
+
+namespace aws {
+namespace utils {
+
+ElasticThreadExecutor::ElasticThreadExecutor(
+    size_t max_threads,
+    std::chrono::milliseconds idle_timeout)
+    : max_threads_(max_threads),
+      idle_timeout_(idle_timeout),
+      state_(std::make_shared<State>()) {}
+
+ElasticThreadExecutor::~ElasticThreadExecutor() {
+  aws::unique_lock<aws::mutex> lk(state_->mutex);
+  state_->shutdown = true;
+  state_->work_available.notify_all();
+  state_->thread_exited.wait(lk, [this] { return state_->threads == 0; });
+}
+
+size_t ElasticThreadExecutor::num_threads() const {
+  aws::lock_guard<aws::mutex> lk(state_->mutex);
+  return state_->threads;
+}
+
+size_t ElasticThreadExecutor::num_idle_threads() const {
+  aws::lock_guard<aws::mutex> lk(state_->mutex);
+  return state_->idle;
+}
+
+bool ElasticThreadExecutor::SubmitToThread(std::function<void()>&& task) {
+  aws::lock_guard<aws::mutex> lk(state_->mutex);
+  if (state_->shutdown) {
+    return false;
+  }
+  state_->tasks.push_back(std::move(task));
+  // Idle threads each take one task; only start a thread if the new task
+  // would otherwise have to wait.
+  if (state_->tasks.size() > state_->idle &&
+      (max_threads_ == 0 || state_->threads < max_threads_)) {
+    state_->threads++;
+    aws::thread(run, state_, idle_timeout_).detach();
+  } else {
+    state_->work_available.notify_one();
+  }
+  return true;
+}
+
+void ElasticThreadExecutor::run(std::shared_ptr<State> state,
+                                std::chrono::milliseconds idle_timeout) {
+  aws::unique_lock<aws::mutex> lk(state->mutex);
+  while (true) {
+    if (!state->tasks.empty()) {
+      auto task = std::move(state->tasks.front());
+      state->tasks.pop_front();
+      lk.unlock();
+      task();
+      lk.lock();
+      continue;
+    }
+
+    if (state->shutdown) {
+      break;
+    }
+
+    state->idle++;
+    bool woken = state->work_available.wait_for(lk, idle_timeout, [&] {
+      return !state->tasks.empty() || state->shutdown;
+    });
+    state->idle--;
+    if (!woken) {
+      break;
+    }
+  }
+
+  state->threads--;
+  state->thread_exited.notify_all();
+}
+
+} //namespace utils
+} //namespace aws
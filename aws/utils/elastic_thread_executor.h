@@ -0,0 +1,83 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_UTILS_ELASTIC_THREAD_EXECUTOR_H_
+#define AWS_UTILS_ELASTIC_THREAD_EXECUTOR_H_
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+
+#include <boost/noncopyable.hpp>
+
+#include <aws/core/utils/threading/Executor.h>
+#include <aws/mutex.h>
+
+namespace aws {
+namespace utils {
+
+// Executor for the SDK clients that grows with the number of requests in
+// flight and shrinks again when they are done.
+//
+// The SDK runs every async request, including the blocking HTTP call, on its
+// executor. The SDK's DefaultExecutor creates a thread per request, and
+// PooledThreadExecutor queues requests behind a fixed set of threads. This one
+// reuses idle threads, creates a new one only when all are busy (up to
+// max_threads, 0 meaning no limit), and lets threads that have been idle for
+// idle_timeout exit.
+class ElasticThreadExecutor : boost::noncopyable,
+                              public Aws::Utils::Threading::Executor {
+ public:
+  ElasticThreadExecutor(size_t max_threads,
+                        std::chrono::milliseconds idle_timeout =
+                            std::chrono::seconds(60));
+
+  // Runs the tasks that are already queued, then waits for all threads to
+  // exit.
+  ~ElasticThreadExecutor();
+
+  size_t num_threads() const;
+
+  size_t num_idle_threads() const;
+
+ protected:
+  bool SubmitToThread(std::function<void()>&& task) override;
+
+ private:
+  // Shared with the threads, which may still be unwinding when the executor
+  // is destroyed.
+  struct State {
+    mutable aws::mutex mutex;
+    aws::condition_variable work_available;
+    aws::condition_variable thread_exited;
+    std::deque<std::function<void()>> tasks;
+    size_t threads = 0;
+    size_t idle = 0;
+    bool shutdown = false;
+  };
+
+  static void run(std::shared_ptr<State> state,
+                  std::chrono::milliseconds idle_timeout);
+
+  const size_t max_threads_;
+  const std::chrono::milliseconds idle_timeout_;
+  std::shared_ptr<State> state_;
+};
+
+} //namespace utils
+} //namespace aws
+
+#endif //AWS_UTILS_ELASTIC_THREAD_EXECUTOR_H_
@@ -18,6 +18,16 @@
 
 #include <chrono>
 #include <functional>
+#include <memory>
+
+#include <aws/utils/latency_histogram.h>
+#include <aws/utils/task.h>
+
+namespace boost {
+namespace asio {
+class io_context;
+} //namespace asio
+} //namespace boost
 
 namespace aws {
 namespace utils {
@@ -53,18 +63,70 @@ class ScheduledCallback {
   }
 };
 
+// Work waiting for a thread is run in order of priority, and in submission
+// order within a priority.
+enum class Priority {
+  // Deadline driven work that directly adds to record latency, such as
+  // flushing buffered records and delivering results.
+  High = 0,
+  // Ingestion and everything else.
+  Normal = 1,
+  // Housekeeping and metrics.
+  Low = 2
+};
+
+static constexpr const size_t kNumPriorities = 3;
+
 class Executor {
  public:
-  using Func = std::function<void () noexcept>;
-
-  virtual void submit(Func f) = 0;
+  using Func = Task;
+
+  // Run by each worker thread when it starts, with the thread's index; e.g. to
+  // set its CPU affinity.
+  using ThreadInit = std::function<void (size_t index)>;
+
+  // Tasks of one priority that are queued, and how long the ones that already
+  // started had to wait, summed since the executor was created.
+  //
+  // The histograms are cumulative as well: time from submit to start, time
+  // spent running, and for scheduled callbacks, how long after their
+  // expiration they started.
+  struct QueueStats {
+    size_t depth = 0;
+    uint64_t started = 0;
+    std::chrono::microseconds total_wait{0};
+    LatencyHistogram::Counts wait{};
+    LatencyHistogram::Counts run{};
+    LatencyHistogram::Counts timer_lateness{};
+  };
+
+  virtual void submit(Func f, Priority priority = Priority::Normal) = 0;
 
   virtual std::shared_ptr<ScheduledCallback>
-  schedule(Func f, TimePoint at) = 0;
+  schedule(Func f, TimePoint at, Priority priority = Priority::Normal) = 0;
 
   virtual std::shared_ptr<ScheduledCallback>
-  schedule(Func f, std::chrono::milliseconds from_now) {
-    return schedule(std::move(f), Clock::now() + from_now);
+  schedule(Func f,
+           std::chrono::milliseconds from_now,
+           Priority priority = Priority::Normal) {
+    return schedule(std::move(f), Clock::now() + from_now, priority);
+  }
+
+  // Returns an executor that runs everything submitted to it on the same
+  // thread, picked by key, or nullptr if this executor can't do that.
+  virtual std::shared_ptr<Executor> affine(size_t key) {
+    return nullptr;
+  }
+
+  virtual QueueStats queue_stats(Priority priority) const {
+    return {};
+  }
+
+  // Returns an io_context run by this executor's threads, for I/O objects
+  // whose handlers should run there, or nullptr if there isn't one. Each call
+  // may return a different io_context, to spread I/O over the threads.
+  virtual boost::asio::io_context* io_reactor() {
+    return nullptr;
   }
 
   virtual size_t num_threads() const noexcept = 0;
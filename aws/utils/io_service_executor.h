@@ -16,6 +16,10 @@
 #ifndef AWS_UTILS_IO_SERVICE_EXECUTOR_H_
 #define AWS_UTILS_IO_SERVICE_EXECUTOR_H_
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+
 #include <boost/asio/io_context.hpp>
 #include <boost/asio/post.hpp>
 #include <boost/asio/steady_timer.hpp>
@@ -24,24 +28,56 @@
 #include <aws/mutex.h>
 #include <aws/utils/executor.h>
 #include <aws/utils/concurrent_linked_queue.h>
+#include <aws/utils/priority_task_queue.h>
 #include <aws/utils/spin_lock.h>
 
 namespace aws {
 namespace utils {
 
-class SteadyTimerScheduledCallback : boost::noncopyable,
-                                     public ScheduledCallback {
+// Callbacks made with create() are handed to the dispatch function, along with
+// the time the timer expired at, instead of running on the timer's thread, so
+// they can be queued with a priority like any other task.
+//
+// Each reschedule or cancel starts a new generation; a wait or a dispatched
+// task from an earlier generation does nothing when it runs.
+class SteadyTimerScheduledCallback
+    : boost::noncopyable,
+      public ScheduledCallback,
+      public std::enable_shared_from_this<SteadyTimerScheduledCallback> {
  public:
+  using Dispatch = std::function<void (Executor::Func, TimePoint)>;
+
   SteadyTimerScheduledCallback(Executor::Func f,
                                boost::asio::io_context& io_ctx,
                                TimePoint at)
-      : completed_(false),
-        f_(std::move(f)),
-        timer_(io_ctx) {
+      : SteadyTimerScheduledCallback(std::move(f), io_ctx, Dispatch()) {
     reschedule(at);
   }
 
+  SteadyTimerScheduledCallback(Executor::Func f,
+                               boost::asio::io_context& io_ctx,
+                               Dispatch dispatch)
+      : completed_(true),
+        generation_(0),
+        f_(std::move(f)),
+        timer_(io_ctx),
+        dispatch_(std::move(dispatch)) {}
+
+  // The timer is only armed once the callback is owned by a shared_ptr, which
+  // the dispatched task holds on to.
+  static std::shared_ptr<SteadyTimerScheduledCallback> create(
+      Executor::Func f,
+      boost::asio::io_context& io_ctx,
+      TimePoint at,
+      Dispatch dispatch) {
+    auto cb = std::make_shared<SteadyTimerScheduledCallback>(
+        std::move(f), io_ctx, std::move(dispatch));
+    cb->reschedule(at);
+    return cb;
+  }
+
   void cancel() override {
+    generation_++;
     timer_.cancel();
     completed_ = true;
   }
@@ -51,13 +87,23 @@ class SteadyTimerScheduledCallback : boost::noncopyable,
   }
 
   void reschedule(TimePoint at) override {
+    auto generation = ++generation_;
     completed_ = false;
     timer_.expires_at(at);
-    timer_.async_wait([this](auto& ec) {
-      if (ec != boost::asio::error::operation_aborted) {
-        f_();
+    timer_.async_wait([this, generation](auto& ec) {
+      if (ec == boost::asio::error::operation_aborted) {
+        if (generation == generation_) {
+          completed_ = true;
+        }
+      } else if (dispatch_) {
+        // The dispatched task may outlive every other reference.
+        dispatch_([self = this->shared_from_this(), generation] {
+                    self->fire(generation);
+                  },
+                  timer_.expiry());
+      } else {
+        fire(generation);
       }
-      completed_ = true;
     });
   }
 
@@ -66,23 +112,44 @@ class SteadyTimerScheduledCallback : boost::noncopyable,
   }
 
  private:
-  bool completed_;
+  // completed_ is set before running f_, so that a reschedule from inside f_
+  // isn't undone.
+  void fire(uint64_t generation) {
+    if (generation != generation_) {
+      return;
+    }
+    completed_ = true;
+    f_();
+  }
+
+  std::atomic<bool> completed_;
+  std::atomic<uint64_t> generation_;
   Executor::Func f_;
   boost::asio::steady_timer timer_;
+  Dispatch dispatch_;
 };
 
+// Tasks are queued by priority. Posts to the io_context only carry a drain
+// token that runs the highest priority tasks queued, a batch at a time; there
+// is at most one token per thread, so most submits don't post at all.
 class IoServiceExecutor : boost::noncopyable,
                           public Executor {
  public:
-  IoServiceExecutor(size_t num_threads)
+  IoServiceExecutor(size_t num_threads, ThreadInit init = ThreadInit())
       : io_context_(std::make_shared<boost::asio::io_context>()),
-        work_guard_(boost::asio::make_work_guard(*io_context_)),
-        clean_up_cb_(
-            [this] { this->clean_up(); },
-            *io_context_,
-            Clock::now() + std::chrono::seconds(1)) {
+        work_guard_(boost::asio::make_work_guard(*io_context_)) {
+    clean_up_cb_ = SteadyTimerScheduledCallback::create(
+        [this] { this->clean_up(); },
+        *io_context_,
+        Clock::now() + std::chrono::seconds(1),
+        dispatch(Priority::Low));
     for (size_t i = 0; i < num_threads; i++) {
-      threads_.emplace_back([this] { io_context_->run(); });
+      threads_.emplace_back([this, i, init] {
+        if (init) {
+          init(i);
+        }
+        io_context_->run();
+      });
     }
   }
 
@@ -95,21 +162,46 @@ class IoServiceExecutor : boost::noncopyable,
     clean_up();
   }
 
-  void submit(Func f) override {
-    boost::asio::post(*io_context_, std::move(f));
+  void submit(Func f, Priority priority = Priority::Normal) override {
+    bool post;
+    stats_.queued(priority);
+    {
+      aws::lock_guard<aws::utils::SpinLock> lk(queue_mutex_);
+      queue_.push(std::move(f), priority);
+      post = drains_posted_ < std::max<size_t>(threads_.size(), 1);
+      if (post) {
+        drains_posted_++;
+      }
+    }
+    if (post) {
+      post_drain();
+    }
   };
 
-  std::shared_ptr<ScheduledCallback> schedule(Func f,
-                                              TimePoint at) override {
+  std::shared_ptr<ScheduledCallback> schedule(
+      Func f,
+      TimePoint at,
+      Priority priority = Priority::Normal) override {
     auto cb =
-      std::make_shared<SteadyTimerScheduledCallback>(
+      SteadyTimerScheduledCallback::create(
           std::move(f),
           *io_context_,
-          at);
+          at,
+          dispatch(priority));
     callbacks_clq_.put(cb);
     return cb;
   };
 
+  using Executor::schedule;
+
+  QueueStats queue_stats(Priority priority) const override {
+    return stats_.get(priority);
+  }
+
+  boost::asio::io_context* io_reactor() override {
+    return io_context_.get();
+  }
+
   const std::shared_ptr<boost::asio::io_context>& io_context() {
     return io_context_;
   }
@@ -129,6 +221,38 @@ class IoServiceExecutor : boost::noncopyable,
  private:
   using CbPtr = std::shared_ptr<SteadyTimerScheduledCallback>;
 
+  // Tasks run per turn before yielding to timers and I/O.
+  static constexpr const size_t kDrainBatchSize = 64;
+
+  SteadyTimerScheduledCallback::Dispatch dispatch(Priority priority) {
+    return [this, priority](Func g, TimePoint expiration) {
+      this->submit([this, priority, expiration, g = std::move(g)]() mutable {
+        stats_.timer_fired(priority, expiration);
+        g();
+      }, priority);
+    };
+  }
+
+  void post_drain() {
+    boost::asio::post(*io_context_, [this] { this->drain(); });
+  }
+
+  // Yields to timers and I/O after a batch, by posting itself again.
+  void drain() {
+    for (size_t i = 0; i < kDrainBatchSize; i++) {
+      PriorityTaskQueue::Entry e;
+      {
+        aws::lock_guard<aws::utils::SpinLock> lk(queue_mutex_);
+        if (!queue_.pop_front(e)) {
+          drains_posted_--;
+          return;
+        }
+      }
+      stats_.run(e);
+    }
+    post_drain();
+  }
+
   void clean_up() {
     if (!clean_up_mutex_.try_lock()) {
       return;
@@ -151,16 +275,20 @@ class IoServiceExecutor : boost::noncopyable,
 
     clean_up_mutex_.unlock();
 
-    clean_up_cb_.reschedule(Clock::now() + std::chrono::seconds(1));
+    clean_up_cb_->reschedule(Clock::now() + std::chrono::seconds(1));
   }
 
   std::shared_ptr<boost::asio::io_context> io_context_;
   boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_guard_;
   std::vector<aws::thread> threads_;
+  aws::utils::SpinLock queue_mutex_;
+  PriorityTaskQueue queue_;
+  size_t drains_posted_ = 0;
+  QueueStatsCounters stats_;
   std::list<CbPtr> callbacks_;
   aws::utils::SpinLock clean_up_mutex_;
   aws::utils::ConcurrentLinkedQueue<CbPtr> callbacks_clq_;
-  SteadyTimerScheduledCallback clean_up_cb_;
+  CbPtr clean_up_cb_;
 };
 
 } //namespace utils
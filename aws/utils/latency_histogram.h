@@ -0,0 +1,76 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_UTILS_LATENCY_HISTOGRAM_H_
+#define AWS_UTILS_LATENCY_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include <boost/noncopyable.hpp>
+
+namespace aws {
+namespace utils {
+
+// Lock-free histogram of durations with power of two buckets: bucket 0 holds
+// durations under 1us, bucket i durations in [2^(i-1), 2^i) us, and the last
+// bucket everything from about 18 minutes up.
+class LatencyHistogram : boost::noncopyable {
+ public:
+  static constexpr const size_t kNumBuckets = 32;
+
+  using Counts = std::array<uint64_t, kNumBuckets>;
+
+  void record(std::chrono::nanoseconds d) noexcept {
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    buckets_[bucket(us)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  Counts counts() const noexcept {
+    Counts c;
+    for (size_t i = 0; i < kNumBuckets; i++) {
+      c[i] = buckets_[i].load(std::memory_order_relaxed);
+    }
+    return c;
+  }
+
+  static size_t bucket(int64_t us) noexcept {
+    size_t i = 0;
+    while (us > 0 && i < kNumBuckets - 1) {
+      us >>= 1;
+      i++;
+    }
+    return i;
+  }
+
+  // Midpoint of a bucket, used when the counts are turned back into values.
+  static std::chrono::microseconds representative(size_t bucket) noexcept {
+    if (bucket == 0) {
+      return std::chrono::microseconds(0);
+    }
+    int64_t lower = int64_t(1) << (bucket - 1);
+    return std::chrono::microseconds(lower + lower / 2);
+  }
+
+ private:
+  std::array<std::atomic<uint64_t>, kNumBuckets> buckets_{};
+};
+
+} //namespace utils
+} //namespace aws
+
+#endif //AWS_UTILS_LATENCY_HISTOGRAM_H_
@@ -0,0 +1,420 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_UTILS_MULTI_REACTOR_EXECUTOR_H_
+#define AWS_UTILS_MULTI_REACTOR_EXECUTOR_H_
+
+#include <atomic>
+#include <memory>
+
+#include <aws/utils/io_service_executor.h>
+
+namespace aws {
+namespace utils {
+
+// Runs one io_context per thread instead of sharing a single io_context
+// between all threads, so submitting work and arming timers doesn't contend on
+// one lock.
+//
+// Tasks passed to submit() are spread round-robin over per-thread run queues.
+// Whenever tasks are waiting behind one that is running, an idle thread is
+// woken to steal them, so a single slow task can't hold up everything queued
+// behind it.
+//
+// Executors returned by affine() run their tasks and timers on one thread,
+// which keeps work that belongs together (e.g. one stream's pipeline) on the
+// same core. They are ordered by priority together with the thread's shared
+// queue. Only once more than kStealThreshold of them are waiting may other
+// threads steal them, so that one busy stream isn't held to a single thread.
+class MultiReactorExecutor
+    : boost::noncopyable,
+      public Executor,
+      public std::enable_shared_from_this<MultiReactorExecutor> {
+ public:
+  MultiReactorExecutor(size_t num_threads, ThreadInit init = ThreadInit())
+      : next_(0) {
+    for (size_t i = 0; i < std::max<size_t>(num_threads, 1); i++) {
+      reactors_.emplace_back(new Reactor(i));
+    }
+    clean_up_cb_ = SteadyTimerScheduledCallback::create(
+        [this] { this->clean_up(); },
+        reactors_.front()->io_context,
+        Clock::now() + std::chrono::seconds(1),
+        [this](Func g, TimePoint expiration) {
+          this->submit(timed(std::move(g), Priority::Low, expiration),
+                       Priority::Low);
+        });
+    for (auto& r : reactors_) {
+      auto reactor = r.get();
+      r->thread = aws::thread([reactor, init] {
+        if (init) {
+          init(reactor->index);
+        }
+        reactor->io_context.run();
+      });
+    }
+  }
+
+  ~MultiReactorExecutor() {
+    for (auto& r : reactors_) {
+      r->work_guard.reset();
+      r->io_context.stop();
+    }
+    for (auto& r : reactors_) {
+      if (r->thread.joinable()) {
+        r->thread.join();
+      }
+    }
+    // Queued tasks and timer callbacks can hold timers of any reactor, so
+    // they all go before the first io_context is destroyed.
+    for (auto& r : reactors_) {
+      r->queue.clear();
+      r->pinned.clear();
+    }
+    clean_up_cb_.reset();
+    CbPtr p;
+    while (callbacks_clq_.try_take(p)) {}
+    p.reset();
+    callbacks_.clear();
+  }
+
+  void submit(Func f, Priority priority = Priority::Normal) override {
+    auto& r = next_reactor();
+    bool idle;
+    bool busy;
+    stats_.queued(priority);
+    {
+      std::lock_guard<SpinLock> lk(r.mutex);
+      r.queue.push(std::move(f), priority);
+      idle = !r.drain_posted;
+      busy = r.busy;
+      r.drain_posted = true;
+    }
+    if (idle) {
+      post_drain(r);
+    } else if (busy) {
+      wake_idle_thread(r);
+    }
+  }
+
+  std::shared_ptr<ScheduledCallback> schedule(
+      Func f,
+      TimePoint at,
+      Priority priority = Priority::Normal) override {
+    return schedule_on(next_reactor(), std::move(f), at,
+                       [this, priority](Func g, TimePoint expiration) {
+                         this->submit(timed(std::move(g), priority, expiration),
+                                      priority);
+                       });
+  }
+
+  using Executor::schedule;
+
+  std::shared_ptr<Executor> affine(size_t key) override;
+
+  // Covers the affine executors too.
+  QueueStats queue_stats(Priority priority) const override {
+    return stats_.get(priority);
+  }
+
+  boost::asio::io_context* io_reactor() override {
+    return &next_reactor().io_context;
+  }
+
+  size_t num_threads() const noexcept override {
+    return reactors_.size();
+  }
+
+  void join() override {
+    for (auto& r : reactors_) {
+      r->thread.join();
+    }
+  }
+
+ private:
+  class Affine;
+
+  using CbPtr = std::shared_ptr<SteadyTimerScheduledCallback>;
+
+  // Affine backlog above which an idle neighbouring thread is asked to help.
+  static constexpr const size_t kStealThreshold = 32;
+
+  // Tasks run per turn before yielding to timers and affine work.
+  static constexpr const size_t kDrainBatchSize = 64;
+
+  struct Reactor {
+    Reactor(size_t index)
+        : index(index),
+          io_context(1),
+          work_guard(boost::asio::make_work_guard(io_context)),
+          drain_posted(false),
+          busy(false) {}
+
+    const size_t index;
+    boost::asio::io_context io_context;
+    boost::asio::executor_work_guard<boost::asio::io_context::executor_type>
+        work_guard;
+    aws::thread thread;
+
+    SpinLock mutex;
+    // Tasks any thread may run.
+    PriorityTaskQueue queue;
+    // Tasks from affine executors, only run by this thread.
+    PriorityTaskQueue pinned;
+    bool drain_posted;
+    // Set while the thread runs a task. Set with the mutex held when the task
+    // is taken from this thread's queues, so a submit either sees it or its
+    // task is seen by the owner as backlog.
+    std::atomic<bool> busy;
+  };
+
+  Reactor& next_reactor() {
+    return *reactors_[next_++ % reactors_.size()];
+  }
+
+  void wake_if_idle(Reactor& r) {
+    bool idle;
+    {
+      std::lock_guard<SpinLock> lk(r.mutex);
+      idle = !r.drain_posted;
+      r.drain_posted = true;
+    }
+    if (idle) {
+      post_drain(r);
+    }
+  }
+
+  // Wakes the first idle thread after r's, if any, to steal from r.
+  void wake_idle_thread(Reactor& r) {
+    const auto n = reactors_.size();
+    for (size_t i = 1; i < n; i++) {
+      auto& other = *reactors_[(r.index + i) % n];
+      bool idle;
+      {
+        std::lock_guard<SpinLock> lk(other.mutex);
+        idle = !other.drain_posted;
+        other.drain_posted = true;
+      }
+      if (idle) {
+        post_drain(other);
+        return;
+      }
+    }
+  }
+
+  void post_drain(Reactor& r) {
+    boost::asio::post(r.io_context, [this, &r] { this->drain(r); });
+  }
+
+  void drain(Reactor& r) {
+    for (size_t i = 0; i < kDrainBatchSize; i++) {
+      PriorityTaskQueue::Entry e;
+      bool backlog = false;
+      if (!take(r, e, backlog) && !steal(r, e)) {
+        std::lock_guard<SpinLock> lk(r.mutex);
+        if (r.queue.empty() && r.pinned.empty()) {
+          r.drain_posted = false;
+          return;
+        }
+        continue;
+      }
+      if (backlog) {
+        wake_idle_thread(r);
+      }
+      stats_.run(e);
+      r.busy = false;
+    }
+    post_drain(r);
+  }
+
+  // Takes the highest priority task from either of the thread's own queues,
+  // and marks the thread busy. backlog is set if tasks others may steal are
+  // left waiting behind it.
+  bool take(Reactor& r, PriorityTaskQueue::Entry& e, bool& backlog) {
+    std::lock_guard<SpinLock> lk(r.mutex);
+    for (size_t p = 0; p < kNumPriorities; p++) {
+      auto priority = static_cast<Priority>(p);
+      if (r.pinned.pop_front(priority, e) || r.queue.pop_front(priority, e)) {
+        r.busy = true;
+        backlog = !r.queue.empty() || r.pinned.size() > kStealThreshold;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Wraps an expired timer's callback to record how late it started.
+  Func timed(Func g, Priority priority, TimePoint expiration) {
+    return [this, priority, expiration, g = std::move(g)]() mutable {
+      stats_.timer_fired(priority, expiration);
+      g();
+    };
+  }
+
+  void submit_pinned(Reactor& r, Func f, Priority priority) {
+    size_t depth;
+    bool idle;
+    stats_.queued(priority);
+    {
+      std::lock_guard<SpinLock> lk(r.mutex);
+      r.pinned.push(std::move(f), priority);
+      depth = r.pinned.size();
+      idle = !r.drain_posted;
+      r.drain_posted = true;
+    }
+    if (idle) {
+      post_drain(r);
+    }
+    if (depth > kStealThreshold) {
+      wake_if_idle(*reactors_[(r.index + 1) % reactors_.size()]);
+    }
+  }
+
+  // Takes from the back of another thread's queue, skipping queues whose
+  // owner is busy with them right now. Affine work is only taken from a
+  // backlog of more than kStealThreshold. The thief is marked busy too, so
+  // that tasks queued to it meanwhile can be stolen in turn.
+  bool steal(Reactor& thief, PriorityTaskQueue::Entry& e) {
+    const auto n = reactors_.size();
+    const auto start = thief.index;
+    for (size_t i = 1; i < n; i++) {
+      auto& victim = *reactors_[(start + i) % n];
+      if (!victim.mutex.try_lock()) {
+        continue;
+      }
+      std::lock_guard<SpinLock> lk(victim.mutex, std::adopt_lock);
+      if (victim.queue.pop_back(e) ||
+          (victim.pinned.size() > kStealThreshold &&
+           victim.pinned.pop_back(e))) {
+        thief.busy = true;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  std::shared_ptr<ScheduledCallback> schedule_on(
+      Reactor& r,
+      Func f,
+      TimePoint at,
+      SteadyTimerScheduledCallback::Dispatch dispatch) {
+    auto cb =
+        SteadyTimerScheduledCallback::create(
+            std::move(f),
+            r.io_context,
+            at,
+            std::move(dispatch));
+    callbacks_clq_.put(cb);
+    return cb;
+  }
+
+  void clean_up() {
+    if (!clean_up_mutex_.try_lock()) {
+      return;
+    }
+
+    CbPtr p;
+    while (callbacks_clq_.try_take(p)) {
+      if (!p->completed()) {
+        callbacks_.push_back(std::move(p));
+      }
+    }
+
+    for (auto it = callbacks_.begin(); it != callbacks_.end();) {
+      if ((*it)->completed()) {
+        it = callbacks_.erase(it);
+      } else {
+        it++;
+      }
+    }
+
+    clean_up_mutex_.unlock();
+
+    if (clean_up_cb_) {
+      clean_up_cb_->reschedule(Clock::now() + std::chrono::seconds(1));
+    }
+  }
+
+  std::vector<std::unique_ptr<Reactor>> reactors_;
+  std::atomic<size_t> next_;
+  QueueStatsCounters stats_;
+  std::list<CbPtr> callbacks_;
+  aws::utils::SpinLock clean_up_mutex_;
+  aws::utils::ConcurrentLinkedQueue<CbPtr> callbacks_clq_;
+  CbPtr clean_up_cb_;
+};
+
+// Runs everything on a single reactor of a MultiReactorExecutor.
+class MultiReactorExecutor::Affine : boost::noncopyable,
+                                     public Executor {
+ public:
+  Affine(std::shared_ptr<MultiReactorExecutor> parent, Reactor& reactor)
+      : parent_(std::move(parent)),
+        reactor_(reactor) {}
+
+  void submit(Func f, Priority priority = Priority::Normal) override {
+    parent_->submit_pinned(reactor_, std::move(f), priority);
+  }
+
+  std::shared_ptr<ScheduledCallback> schedule(
+      Func f,
+      TimePoint at,
+      Priority priority = Priority::Normal) override {
+    auto parent = parent_.get();
+    auto& reactor = reactor_;
+    return parent_->schedule_on(reactor_, std::move(f), at,
+                                [parent, &reactor, priority](
+                                    Func g, TimePoint expiration) {
+                                  parent->submit_pinned(
+                                      reactor,
+                                      parent->timed(std::move(g),
+                                                    priority,
+                                                    expiration),
+                                      priority);
+                                });
+  }
+
+  using Executor::schedule;
+
+  QueueStats queue_stats(Priority priority) const override {
+    return parent_->queue_stats(priority);
+  }
+
+  boost::asio::io_context* io_reactor() override {
+    return &reactor_.io_context;
+  }
+
+  size_t num_threads() const noexcept override {
+    return 1;
+  }
+
+  void join() override {
+    parent_->join();
+  }
+
+ private:
+  std::shared_ptr<MultiReactorExecutor> parent_;
+  Reactor& reactor_;
+};
+
+inline std::shared_ptr<Executor> MultiReactorExecutor::affine(size_t key) {
+  return std::make_shared<Affine>(shared_from_this(),
+                                  *reactors_[key % reactors_.size()]);
+}
+
+} //namespace utils
+} //namespace aws
+
+#endif //AWS_UTILS_MULTI_REACTOR_EXECUTOR_H_
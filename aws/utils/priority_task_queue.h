@@ -0,0 +1,172 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_UTILS_PRIORITY_TASK_QUEUE_H_
+#define AWS_UTILS_PRIORITY_TASK_QUEUE_H_
+
+#include <array>
+#include <atomic>
+#include <deque>
+
+#include <boost/noncopyable.hpp>
+
+#include <aws/utils/executor.h>
+
+namespace aws {
+namespace utils {
+
+// One FIFO of tasks per priority. Not synchronized; callers lock around it.
+class PriorityTaskQueue : boost::noncopyable {
+ public:
+  struct Entry {
+    Executor::Func f;
+    Priority priority;
+    TimePoint queued_at;
+  };
+
+  void push(Executor::Func f, Priority p) {
+    lanes_[static_cast<size_t>(p)].push_back({std::move(f), p, Clock::now()});
+    size_++;
+  }
+
+  // Takes the oldest task of the highest priority.
+  bool pop_front(Entry& e) {
+    for (size_t p = 0; p < kNumPriorities; p++) {
+      if (pop_front(static_cast<Priority>(p), e)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Takes the oldest task of the given priority.
+  bool pop_front(Priority p, Entry& e) {
+    auto& lane = lanes_[static_cast<size_t>(p)];
+    if (lane.empty()) {
+      return false;
+    }
+    e = std::move(lane.front());
+    lane.pop_front();
+    size_--;
+    return true;
+  }
+
+  // Takes the newest task of the highest priority; for stealing.
+  bool pop_back(Entry& e) {
+    for (auto& lane : lanes_) {
+      if (!lane.empty()) {
+        e = std::move(lane.back());
+        lane.pop_back();
+        size_--;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Destroys every task. The queue is already empty by then, in case a
+  // task's destructor pushes another.
+  void clear() {
+    decltype(lanes_) lanes;
+    std::swap(lanes, lanes_);
+    size_ = 0;
+  }
+
+  size_t size() const noexcept {
+    return size_;
+  }
+
+  bool empty() const noexcept {
+    return size_ == 0;
+  }
+
+ private:
+  std::array<std::deque<Entry>, kNumPriorities> lanes_;
+  size_t size_ = 0;
+};
+
+// Executor::QueueStats, kept up to date from several threads.
+class QueueStatsCounters : boost::noncopyable {
+ public:
+  // Call before the task is pushed; otherwise a drain on another thread can
+  // start it first and take the depth below zero.
+  void queued(Priority p) {
+    at(p).depth++;
+  }
+
+  // Returns the start time, to be passed to finished().
+  TimePoint started(Priority p, TimePoint queued_at) {
+    auto& c = at(p);
+    auto now = Clock::now();
+    c.depth--;
+    c.started++;
+    c.total_wait_us += std::chrono::duration_cast<std::chrono::microseconds>(
+        now - queued_at).count();
+    c.wait.record(now - queued_at);
+    return now;
+  }
+
+  void finished(Priority p, TimePoint started_at) {
+    at(p).run.record(Clock::now() - started_at);
+  }
+
+  void timer_fired(Priority p, TimePoint expiration) {
+    at(p).timer_lateness.record(Clock::now() - expiration);
+  }
+
+  // Runs a task, recording how long it waited and how long it ran.
+  void run(PriorityTaskQueue::Entry& e) {
+    auto start = started(e.priority, e.queued_at);
+    e.f();
+    finished(e.priority, start);
+  }
+
+  Executor::QueueStats get(Priority p) const {
+    auto& c = at(p);
+    Executor::QueueStats stats;
+    stats.depth = c.depth;
+    stats.started = c.started;
+    stats.total_wait = std::chrono::microseconds(c.total_wait_us);
+    stats.wait = c.wait.counts();
+    stats.run = c.run.counts();
+    stats.timer_lateness = c.timer_lateness.counts();
+    return stats;
+  }
+
+ private:
+  struct Counters {
+    std::atomic<int64_t> depth{0};
+    std::atomic<uint64_t> started{0};
+    std::atomic<int64_t> total_wait_us{0};
+    LatencyHistogram wait;
+    LatencyHistogram run;
+    LatencyHistogram timer_lateness;
+  };
+
+  Counters& at(Priority p) {
+    return counters_[static_cast<size_t>(p)];
+  }
+
+  const Counters& at(Priority p) const {
+    return counters_[static_cast<size_t>(p)];
+  }
+
+  std::array<Counters, kNumPriorities> counters_;
+};
+
+} //namespace utils
+} //namespace aws
+
+#endif //AWS_UTILS_PRIORITY_TASK_QUEUE_H_
@@ -92,43 +92,54 @@ std::ostream &aws::utils::operator<<(std::ostream &os, const flush_statistics_ag
             << fs.output_type_ << ": " << fs.output_records_ << " }";
 }
 
-processing_statistics_logger::processing_statistics_logger(std::string &stream, const std::uint64_t max_buffer_time) :
+namespace {
+  const std::chrono::milliseconds kReportInterval(15000);
+}
+
+processing_statistics_logger::processing_statistics_logger(std::string &stream,
+                                                           const std::uint64_t max_buffer_time,
+                                                           std::shared_ptr<Executor> executor) :
         stream_(stream),
         stage1_(stream, "UserRecords", "KinesisRecords"),
         stage2_(stream, "KinesisRecords", "PutRecords"),
         total_time_(0),
         total_requests_(0),
         max_buffer_time_(max_buffer_time),
-        is_running_(true),
-        reporting_thread_(std::bind(&processing_statistics_logger::reporting_loop, this)) {}
-
-void processing_statistics_logger::reporting_loop() {
-  while(is_running_.load()) {
-    {
-      using namespace std::chrono_literals;
-      std::this_thread::sleep_for(15s);
-    }
-    LOG(info) << "Stage 1 Triggers: " << stage1_;
-    stage1_.reset();
-
-    LOG(info) << "Stage 2 Triggers: " << stage2_;
-    stage2_.reset();
-
-    std::uint64_t total_time = total_time_;
-    std::uint64_t requests = total_requests_;
-
-    total_time_ = 0;
-    total_requests_ = 0;
-
-    double average_req_time = total_time / static_cast<double>(requests);
-    double max_buffer_warn_limit = max_buffer_time_ * 5.0;
-    if (average_req_time > max_buffer_warn_limit) {
-      LOG(warning) << "PutRecords processing time is taking longer than " << max_buffer_warn_limit << " ms to complete.  "
-                   << "You may need to adjust your configuration to reduce the processing time.";
-    }
-    LOG(info) << "(" << stream_ << ") Average Processing Time: " << std::setprecision(8) << average_req_time << " ms";
+        executor_(std::move(executor)) {
+  // report() reschedules through scheduled_report_, so the member has to be
+  // set before the callback can first fire.
+  scheduled_report_ = executor_->schedule([this] { this->report(); },
+                                          TimePoint::max(),
+                                          Priority::Low);
+  scheduled_report_->reschedule(kReportInterval);
+}
+
+processing_statistics_logger::~processing_statistics_logger() {
+  scheduled_report_->cancel();
+}
 
+void processing_statistics_logger::report() {
+  LOG(info) << "Stage 1 Triggers: " << stage1_;
+  stage1_.reset();
+
+  LOG(info) << "Stage 2 Triggers: " << stage2_;
+  stage2_.reset();
+
+  std::uint64_t total_time = total_time_;
+  std::uint64_t requests = total_requests_;
+
+  total_time_ = 0;
+  total_requests_ = 0;
+
+  double average_req_time = total_time / static_cast<double>(requests);
+  double max_buffer_warn_limit = max_buffer_time_ * 5.0;
+  if (average_req_time > max_buffer_warn_limit) {
+    LOG(warning) << "PutRecords processing time is taking longer than " << max_buffer_warn_limit << " ms to complete.  "
+                 << "You may need to adjust your configuration to reduce the processing time.";
   }
+  LOG(info) << "(" << stream_ << ") Average Processing Time: " << std::setprecision(8) << average_req_time << " ms";
+
+  scheduled_report_->reschedule(kReportInterval);
 }
 
 void processing_statistics_logger::request_complete(std::shared_ptr<aws::kinesis::core::PutRecordsContext> context) {
@@ -19,9 +19,10 @@
 #include <string>
 #include <ostream>
 #include <atomic>
-#include <thread>
+#include <memory>
 
 #include <aws/kinesis/core/put_records_context.h>
+#include <aws/utils/executor.h>
 
 namespace aws {
   namespace utils {
@@ -113,7 +114,8 @@ namespace aws {
      * \brief Provides logging of flush statistics and request latency.
      *
      * This provides logging of for flush_statistics_aggregator, and for request latency.  This tracks how long it
-     * takes from a PutRecordsRequest to be enqueued for processing, until it has been completed.
+     * takes from a PutRecordsRequest to be enqueued for processing, until it has been completed.  Reports are
+     * written periodically from a callback scheduled on the given executor.
      */
     class processing_statistics_logger {
     public:
@@ -121,7 +123,15 @@ namespace aws {
       flush_statistics_aggregator &stage1() { return stage1_; }
       flush_statistics_aggregator &stage2() { return stage2_; }
 
-      processing_statistics_logger(std::string& stream, const std::uint64_t max_buffer_time);
+      processing_statistics_logger(std::string& stream,
+                                   const std::uint64_t max_buffer_time,
+                                   std::shared_ptr<Executor> executor);
+
+      ~processing_statistics_logger();
+
+      processing_statistics_logger(const processing_statistics_logger &) = delete;
+
+      processing_statistics_logger &operator=(const processing_statistics_logger &) = delete;
 
       void request_complete(std::shared_ptr<aws::kinesis::core::PutRecordsContext> context);
 
@@ -136,10 +146,10 @@ namespace aws {
       std::atomic<std::uint64_t> total_time_;
       std::atomic<std::uint64_t> total_requests_;
 
-      std::thread reporting_thread_;
-      std::atomic<bool> is_running_;
+      std::shared_ptr<Executor> executor_;
+      std::shared_ptr<ScheduledCallback> scheduled_report_;
 
-      void reporting_loop();
+      void report();
     };
   }
 }
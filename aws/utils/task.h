@@ -0,0 +1,185 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef AWS_UTILS_TASK_H_
+#define AWS_UTILS_TASK_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace aws {
+namespace utils {
+
+// A move-only replacement for std::function<void ()> for work handed to
+// executors.
+//
+// Callables of up to kInlineSize bytes are stored inside the Task itself
+// instead of on the heap. That covers the usual capture lists (this, a couple
+// of shared_ptrs, a vector) so submitting work does not allocate. Since the
+// Task can't be copied, neither can be the captures, e.g. a batch of messages
+// can be moved into the lambda and moved along with the Task.
+class Task {
+ public:
+  static constexpr const size_t kInlineSize = 64;
+
+  Task() noexcept = default;
+
+  Task(std::nullptr_t) noexcept {}
+
+  template <typename F,
+            typename = std::enable_if_t<
+                !std::is_same<std::decay_t<F>, Task>::value>>
+  Task(F&& f) {
+    using Fn = std::decay_t<F>;
+    construct<Fn>(std::forward<F>(f),
+                  std::integral_constant<bool, fits_inline<Fn>()>());
+  }
+
+  Task(Task&& other) noexcept {
+    take(other);
+  }
+
+  Task& operator=(Task&& other) noexcept {
+    if (this != &other) {
+      reset();
+      take(other);
+    }
+    return *this;
+  }
+
+  Task& operator=(std::nullptr_t) noexcept {
+    reset();
+    return *this;
+  }
+
+  Task(const Task&) = delete;
+  Task& operator=(const Task&) = delete;
+
+  ~Task() {
+    reset();
+  }
+
+  void operator()() {
+    vtable_->invoke(&storage_);
+  }
+
+  explicit operator bool() const noexcept {
+    return vtable_ != nullptr;
+  }
+
+  // Whether a callable of type F is stored without a heap allocation.
+  template <typename F>
+  static constexpr bool fits_inline() noexcept {
+    return sizeof(F) <= kInlineSize &&
+        alignof(F) <= alignof(Storage) &&
+        std::is_nothrow_move_constructible<F>::value;
+  }
+
+ private:
+  using Storage =
+      std::aligned_storage_t<kInlineSize, alignof(std::max_align_t)>;
+
+  struct VTable {
+    void (*invoke)(void* storage);
+    void (*move)(void* to, void* from) noexcept;
+    void (*destroy)(void* storage) noexcept;
+  };
+
+  template <typename F>
+  struct InlineOps {
+    static F& get(void* storage) {
+      return *static_cast<F*>(storage);
+    }
+
+    static void invoke(void* storage) {
+      get(storage)();
+    }
+
+    static void move(void* to, void* from) noexcept {
+      new (to) F(std::move(get(from)));
+      get(from).~F();
+    }
+
+    static void destroy(void* storage) noexcept {
+      get(storage).~F();
+    }
+
+    static constexpr const VTable vtable = {&invoke, &move, &destroy};
+  };
+
+  template <typename F>
+  struct HeapOps {
+    static F*& get(void* storage) {
+      return *static_cast<F**>(storage);
+    }
+
+    static void invoke(void* storage) {
+      (*get(storage))();
+    }
+
+    static void move(void* to, void* from) noexcept {
+      new (to) F*(get(from));
+    }
+
+    static void destroy(void* storage) noexcept {
+      delete get(storage);
+    }
+
+    static constexpr const VTable vtable = {&invoke, &move, &destroy};
+  };
+
+  template <typename Fn, typename F>
+  void construct(F&& f, std::true_type /*inline*/) {
+    new (&storage_) Fn(std::forward<F>(f));
+    vtable_ = &InlineOps<Fn>::vtable;
+  }
+
+  template <typename Fn, typename F>
+  void construct(F&& f, std::false_type /*inline*/) {
+    new (&storage_) Fn*(new Fn(std::forward<F>(f)));
+    vtable_ = &HeapOps<Fn>::vtable;
+  }
+
+  void take(Task& other) noexcept {
+    if (other.vtable_) {
+      other.vtable_->move(&storage_, &other.storage_);
+      vtable_ = other.vtable_;
+      other.vtable_ = nullptr;
+    }
+  }
+
+  void reset() noexcept {
+    if (vtable_) {
+      vtable_->destroy(&storage_);
+      vtable_ = nullptr;
+    }
+  }
+
+  Storage storage_;
+  const VTable* vtable_ = nullptr;
+};
+
+template <typename F>
+constexpr const Task::VTable Task::InlineOps<F>::vtable;
+
+template <typename F>
+constexpr const Task::VTable Task::HeapOps<F>::vtable;
+
+} //namespace utils
+} //namespace aws
+
+#endif //AWS_UTILS_TASK_H_
@@ -0,0 +1,71 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <random>
+
+#include <boost/test/unit_test.hpp>
+
+#include <openssl/evp.h>
+
+#include <aws/utils/base64.h>
+
+namespace {
+
+std::string encode(const std::string& s) {
+  std::string out;
+  aws::utils::base64_encode(s.data(), s.size(), out);
+  return out;
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(Base64)
+
+// Test vectors from RFC 4648
+BOOST_AUTO_TEST_CASE(Rfc4648) {
+  BOOST_CHECK_EQUAL(encode(""), "");
+  BOOST_CHECK_EQUAL(encode("f"), "Zg==");
+  BOOST_CHECK_EQUAL(encode("fo"), "Zm8=");
+  BOOST_CHECK_EQUAL(encode("foo"), "Zm9v");
+  BOOST_CHECK_EQUAL(encode("foob"), "Zm9vYg==");
+  BOOST_CHECK_EQUAL(encode("fooba"), "Zm9vYmE=");
+  BOOST_CHECK_EQUAL(encode("foobar"), "Zm9vYmFy");
+}
+
+BOOST_AUTO_TEST_CASE(Appends) {
+  std::string out = "x";
+  aws::utils::base64_encode("foo", 3, out);
+  BOOST_CHECK_EQUAL(out, "xZm9v");
+}
+
+BOOST_AUTO_TEST_CASE(MatchesOpenSsl) {
+  std::mt19937 rng(1234);
+  for (size_t len = 0; len < 1000; len++) {
+    std::string data(len, 0);
+    for (auto& c : data) {
+      c = (char) rng();
+    }
+
+    std::string expected(aws::utils::base64_encoded_size(len) + 1, 0);
+    auto n = EVP_EncodeBlock((unsigned char*) &expected[0],
+                             (const unsigned char*) data.data(),
+                             (int) len);
+    expected.resize(n);
+
+    BOOST_CHECK_EQUAL(encode(data), expected);
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <aws/utils/cpu_affinity.h>
+#include <aws/utils/io_service_executor.h>
+#include <aws/utils/utils.h>
+
+BOOST_AUTO_TEST_SUITE(CpuAffinity)
+
+BOOST_AUTO_TEST_CASE(ParseCpuList) {
+  auto check = [](const std::string& list, std::vector<size_t> expected) {
+    auto cpus = aws::utils::parse_cpu_list(list);
+    BOOST_CHECK_EQUAL_COLLECTIONS(cpus.begin(), cpus.end(),
+                                  expected.begin(), expected.end());
+  };
+  check("", {});
+  check("  ", {});
+  check("3", {3});
+  check("0-3,8", {0, 1, 2, 3, 8});
+  check(" 1 , 4-5 ", {1, 4, 5});
+}
+
+BOOST_AUTO_TEST_CASE(InvalidCpuList) {
+  for (auto list : {"a", "1,", "-1", "3-1", "1-", "1-2-3", "0x1", "99999"}) {
+    BOOST_CHECK_THROW(aws::utils::parse_cpu_list(list), std::runtime_error);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(ExecutorThreadInit) {
+  std::atomic<size_t> started(0);
+  std::atomic<size_t> indexes(0);
+  {
+    aws::utils::IoServiceExecutor executor(4, [&](size_t i) {
+      indexes |= 1 << i;
+      started++;
+    });
+    while (started < 4) {
+      aws::utils::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  BOOST_CHECK_EQUAL(indexes, 0xf);
+}
+
+BOOST_AUTO_TEST_CASE(Pin) {
+  int node = -2;
+  aws::thread t([&] {
+    aws::utils::ThreadPlacement({0}, true).apply();
+    node = aws::utils::current_numa_node();
+  });
+  t.join();
+  BOOST_CHECK_EQUAL(node, aws::utils::numa_node_of_cpu(0));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+
+#include <boost/test/unit_test.hpp>
+
+#include <aws/utils/elastic_thread_executor.h>
+#include <aws/utils/utils.h>
+
+namespace {
+
+bool wait_for(const std::function<bool ()>& done,
+              std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    aws::utils::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(ElasticThreadExecutor)
+
+BOOST_AUTO_TEST_CASE(ReusesIdleThreads) {
+  aws::utils::ElasticThreadExecutor executor(16);
+  std::atomic<size_t> count(0);
+  for (size_t i = 0; i < 100; i++) {
+    executor.Submit([&] { count++; });
+    BOOST_REQUIRE(wait_for([&] {
+      return count == i + 1 && executor.num_idle_threads() == 1;
+    }));
+  }
+  BOOST_CHECK_EQUAL(executor.num_threads(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(GrowsUpToMax) {
+  aws::utils::ElasticThreadExecutor executor(4);
+  std::atomic<bool> release(false);
+  std::atomic<size_t> count(0);
+  for (size_t i = 0; i < 10; i++) {
+    executor.Submit([&] {
+      while (!release) {
+        aws::utils::sleep_for(std::chrono::milliseconds(1));
+      }
+      count++;
+    });
+  }
+  BOOST_CHECK_EQUAL(executor.num_threads(), 4);
+
+  release = true;
+  BOOST_CHECK(wait_for([&] { return count == 10; }));
+  BOOST_CHECK_EQUAL(executor.num_threads(), 4);
+}
+
+BOOST_AUTO_TEST_CASE(ShrinksWhenIdle) {
+  aws::utils::ElasticThreadExecutor executor(0, std::chrono::milliseconds(20));
+  std::atomic<bool> release(false);
+  for (size_t i = 0; i < 8; i++) {
+    executor.Submit([&] {
+      while (!release) {
+        aws::utils::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+  }
+  BOOST_CHECK_EQUAL(executor.num_threads(), 8);
+
+  release = true;
+  BOOST_CHECK(wait_for([&] { return executor.num_threads() == 0; }));
+}
+
+BOOST_AUTO_TEST_CASE(DestructorRunsQueuedTasks) {
+  std::atomic<size_t> count(0);
+  {
+    aws::utils::ElasticThreadExecutor executor(1);
+    for (size_t i = 0; i < 100; i++) {
+      executor.Submit([&] { count++; });
+    }
+  }
+  BOOST_CHECK_EQUAL(count, 100);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
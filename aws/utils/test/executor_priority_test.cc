@@ -0,0 +1,221 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <aws/mutex.h>
+#include <aws/utils/io_service_executor.h>
+#include <aws/utils/multi_reactor_executor.h>
+#include <aws/utils/utils.h>
+
+namespace {
+
+using Priority = aws::utils::Priority;
+
+bool wait_for(const std::function<bool ()>& done,
+              std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    aws::utils::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+// Blocks the executor's only thread, queues tasks of each priority in
+// reverse order, then checks that they ran highest priority first.
+void check_order(aws::utils::Executor& executor) {
+  std::atomic<bool> blocked(false);
+  std::atomic<bool> release(false);
+  executor.submit([&] {
+    blocked = true;
+    while (!release) {
+      aws::utils::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  BOOST_REQUIRE(wait_for([&] { return blocked.load(); }));
+
+  aws::mutex mutex;
+  std::vector<int> order;
+  for (int i = 0; i < 3; i++) {
+    for (auto p : {Priority::Low, Priority::Normal, Priority::High}) {
+      executor.submit([&, p, i] {
+        aws::lock_guard<aws::mutex> lk(mutex);
+        order.push_back(static_cast<int>(p) * 10 + i);
+      }, p);
+    }
+  }
+  BOOST_CHECK_EQUAL(executor.queue_stats(Priority::High).depth, 3);
+  BOOST_CHECK_EQUAL(executor.queue_stats(Priority::Low).depth, 3);
+
+  aws::utils::sleep_for(std::chrono::milliseconds(20));
+  release = true;
+  BOOST_REQUIRE(wait_for([&] {
+    aws::lock_guard<aws::mutex> lk(mutex);
+    return order.size() == 9;
+  }));
+
+  std::vector<int> expected{0, 1, 2, 10, 11, 12, 20, 21, 22};
+  BOOST_CHECK_EQUAL_COLLECTIONS(order.begin(), order.end(),
+                                expected.begin(), expected.end());
+
+  for (auto p : {Priority::High, Priority::Normal, Priority::Low}) {
+    auto stats = executor.queue_stats(p);
+    BOOST_CHECK_EQUAL(stats.depth, 0);
+    BOOST_CHECK_GE(stats.started, 3);
+    BOOST_CHECK(stats.total_wait >= std::chrono::milliseconds(3 * 20));
+  }
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(ExecutorPriority)
+
+BOOST_AUTO_TEST_CASE(IoServiceExecutorOrder) {
+  aws::utils::IoServiceExecutor executor(1);
+  check_order(executor);
+}
+
+BOOST_AUTO_TEST_CASE(MultiReactorExecutorOrder) {
+  auto executor = std::make_shared<aws::utils::MultiReactorExecutor>(1);
+  check_order(*executor);
+}
+
+BOOST_AUTO_TEST_CASE(AffineOrder) {
+  auto executor = std::make_shared<aws::utils::MultiReactorExecutor>(2);
+  check_order(*executor->affine(3));
+}
+
+BOOST_AUTO_TEST_CASE(ScheduledWithPriority) {
+  aws::utils::IoServiceExecutor executor(1);
+  std::atomic<bool> ran(false);
+  auto cb = executor.schedule([&] { ran = true; },
+                              std::chrono::milliseconds(10),
+                              Priority::High);
+  BOOST_CHECK(wait_for([&] { return ran.load(); }));
+  BOOST_CHECK(wait_for([&] { return cb->completed(); }));
+  BOOST_CHECK_GE(executor.queue_stats(Priority::High).started, 1);
+}
+
+// A fire that was already dispatched when the callback was cancelled and
+// rescheduled must not run.
+BOOST_AUTO_TEST_CASE(StaleFireIgnored) {
+  boost::asio::io_context io_context;
+  std::vector<aws::utils::Executor::Func> dispatched;
+  int ran = 0;
+  auto cb = aws::utils::SteadyTimerScheduledCallback::create(
+      [&] { ran++; },
+      io_context,
+      std::chrono::steady_clock::now(),
+      [&](auto f, auto) { dispatched.push_back(std::move(f)); });
+  io_context.run_one();
+  BOOST_REQUIRE_EQUAL(dispatched.size(), 1);
+
+  cb->cancel();
+  cb->reschedule(std::chrono::steady_clock::now() + std::chrono::hours(1));
+  dispatched[0]();
+  BOOST_CHECK_EQUAL(ran, 0);
+  BOOST_CHECK(!cb->completed());
+
+  // The wait cancelled by the reschedule doesn't mark it completed either.
+  io_context.poll();
+  BOOST_CHECK(!cb->completed());
+  cb->cancel();
+}
+
+// Rescheduling from inside the callback leaves the timer armed.
+BOOST_AUTO_TEST_CASE(RescheduleFromCallback) {
+  aws::utils::IoServiceExecutor executor(1);
+  std::atomic<int> ran(0);
+  std::shared_ptr<aws::utils::ScheduledCallback> cb;
+  aws::mutex mutex;
+  aws::unique_lock<aws::mutex> lk(mutex);
+  cb = executor.schedule([&] {
+    aws::lock_guard<aws::mutex> inner(mutex);
+    if (++ran == 1) {
+      cb->reschedule(std::chrono::milliseconds(20));
+    }
+  }, std::chrono::milliseconds(1));
+  lk.unlock();
+
+  BOOST_REQUIRE(wait_for([&] { return ran == 1; }));
+  aws::utils::sleep_for(std::chrono::milliseconds(5));
+  BOOST_CHECK(ran == 2 || !cb->completed());
+  BOOST_CHECK(wait_for([&] { return ran == 2; }));
+  BOOST_CHECK(wait_for([&] { return cb->completed(); }));
+}
+
+BOOST_AUTO_TEST_CASE(RunTimeAndLateness) {
+  aws::utils::IoServiceExecutor executor(1);
+  std::atomic<bool> release(false);
+  std::atomic<bool> ran(false);
+  executor.submit([&] {
+    aws::utils::sleep_for(std::chrono::milliseconds(5));
+    while (!release) {
+      aws::utils::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  // Expires while the only thread is busy, so starts late.
+  auto cb = executor.schedule([&] { ran = true; },
+                              std::chrono::milliseconds(1),
+                              Priority::High);
+  aws::utils::sleep_for(std::chrono::milliseconds(30));
+  release = true;
+
+  auto sum = [](const aws::utils::LatencyHistogram::Counts& c, size_t from) {
+    uint64_t n = 0;
+    for (size_t i = from; i < c.size(); i++) {
+      n += c[i];
+    }
+    return n;
+  };
+  BOOST_REQUIRE(wait_for([&] {
+    return sum(executor.queue_stats(Priority::High).run, 0) == 1;
+  }));
+  // At least 16ms.
+  auto min_bucket = aws::utils::LatencyHistogram::bucket(16000);
+  BOOST_CHECK_EQUAL(
+      sum(executor.queue_stats(Priority::Normal).run, min_bucket), 1);
+  BOOST_CHECK_EQUAL(
+      sum(executor.queue_stats(Priority::High).timer_lateness, min_bucket), 1);
+  BOOST_CHECK_EQUAL(
+      sum(executor.queue_stats(Priority::Low).timer_lateness, 0), 0);
+}
+
+BOOST_AUTO_TEST_CASE(HistogramBuckets) {
+  using aws::utils::LatencyHistogram;
+  BOOST_CHECK_EQUAL(LatencyHistogram::bucket(0), 0);
+  BOOST_CHECK_EQUAL(LatencyHistogram::bucket(1), 1);
+  BOOST_CHECK_EQUAL(LatencyHistogram::bucket(3), 2);
+  BOOST_CHECK_EQUAL(LatencyHistogram::bucket(4), 3);
+  BOOST_CHECK_EQUAL(LatencyHistogram::bucket(INT64_MAX),
+                    LatencyHistogram::kNumBuckets - 1);
+  BOOST_CHECK_EQUAL(LatencyHistogram::representative(3).count(), 6);
+
+  LatencyHistogram h;
+  h.record(std::chrono::microseconds(5));
+  h.record(std::chrono::microseconds(7));
+  h.record(std::chrono::milliseconds(-1));
+  auto counts = h.counts();
+  BOOST_CHECK_EQUAL(counts[3], 2);
+  BOOST_CHECK_EQUAL(counts[0], 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <atomic>
+#include <set>
+
+#include <boost/test/unit_test.hpp>
+
+#include <aws/mutex.h>
+#include <aws/utils/multi_reactor_executor.h>
+#include <aws/utils/utils.h>
+
+namespace {
+
+bool wait_for(const std::function<bool ()>& done,
+              std::chrono::milliseconds timeout = std::chrono::seconds(5)) {
+  auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (!done()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    aws::utils::sleep_for(std::chrono::milliseconds(1));
+  }
+  return true;
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(MultiReactorExecutor)
+
+BOOST_AUTO_TEST_CASE(RunsAllTasks) {
+  auto executor = std::make_shared<aws::utils::MultiReactorExecutor>(4);
+  const size_t N = 10000;
+  std::atomic<size_t> count(0);
+  for (size_t i = 0; i < N; i++) {
+    executor->submit([&] { count++; });
+  }
+  BOOST_CHECK(wait_for([&] { return count == N; }));
+}
+
+BOOST_AUTO_TEST_CASE(Schedule) {
+  std::shared_ptr<aws::utils::Executor> executor =
+      std::make_shared<aws::utils::MultiReactorExecutor>(2);
+  std::atomic<bool> ran(false);
+  auto start = std::chrono::steady_clock::now();
+  auto cb = executor->schedule([&] { ran = true; },
+                               std::chrono::milliseconds(50));
+  BOOST_CHECK(wait_for([&] { return ran.load(); }));
+  BOOST_CHECK(std::chrono::steady_clock::now() - start >=
+              std::chrono::milliseconds(50));
+}
+
+BOOST_AUTO_TEST_CASE(AffineStaysOnOneThread) {
+  auto executor = std::make_shared<aws::utils::MultiReactorExecutor>(4);
+  auto affine = executor->affine(7);
+  BOOST_REQUIRE(affine);
+
+  aws::mutex mutex;
+  std::set<aws::thread::id> threads;
+  std::atomic<size_t> count(0);
+  auto record = [&] {
+    aws::lock_guard<aws::mutex> lk(mutex);
+    threads.insert(aws::this_thread::get_id());
+    count++;
+  };
+  // In batches small enough not to be stolen.
+  const size_t N = 1024;
+  const size_t kBatch = 16;
+  for (size_t i = 0; i < N; i += kBatch) {
+    for (size_t j = 0; j < kBatch; j++) {
+      affine->submit(record);
+    }
+    BOOST_REQUIRE(wait_for([&] { return count == i + kBatch; }));
+  }
+  auto cb = affine->schedule(record, std::chrono::milliseconds(10));
+
+  BOOST_REQUIRE(wait_for([&] { return count == N + 1; }));
+  BOOST_CHECK_EQUAL(threads.size(), 1);
+}
+
+// A backlog of affine work behind a busy thread is taken by the others.
+BOOST_AUTO_TEST_CASE(AffineOverflowStolen) {
+  auto executor = std::make_shared<aws::utils::MultiReactorExecutor>(2);
+  auto affine = executor->affine(0);
+
+  std::atomic<bool> release(false);
+  affine->submit([&] {
+    while (!release) {
+      aws::utils::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+
+  const size_t N = 100;
+  std::atomic<size_t> count(0);
+  for (size_t i = 0; i < N; i++) {
+    affine->submit([&] { count++; });
+  }
+  // Everything but the threshold's worth left for the blocked thread.
+  BOOST_CHECK(wait_for([&] { return count >= N - 32; }));
+  BOOST_CHECK(count < N);
+
+  release = true;
+  BOOST_CHECK(wait_for([&] { return count == N; }));
+}
+
+BOOST_AUTO_TEST_CASE(StealsFromBlockedThread) {
+  auto executor = std::make_shared<aws::utils::MultiReactorExecutor>(2);
+
+  // Block one thread through its affine executor; tasks that get queued
+  // behind it must still run on the other thread.
+  std::atomic<bool> release(false);
+  executor->affine(0)->submit([&] {
+    while (!release) {
+      aws::utils::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+
+  const size_t N = 1000;
+  std::atomic<size_t> count(0);
+  for (size_t i = 0; i < N; i++) {
+    executor->submit([&] { count++; });
+  }
+  BOOST_CHECK(wait_for([&] { return count == N; }));
+
+  release = true;
+}
+
+// A single task queued behind a long-running one is taken by an idle thread,
+// well short of any backlog threshold.
+BOOST_AUTO_TEST_CASE(TaskBehindBlockedTaskRunsPromptly) {
+  auto executor = std::make_shared<aws::utils::MultiReactorExecutor>(2);
+
+  // Submits alternate between the two threads, so the first and third tasks
+  // land on the same one.
+  std::atomic<bool> release(false);
+  std::atomic<bool> blocked(false);
+  executor->submit([&] {
+    blocked = true;
+    while (!release) {
+      aws::utils::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+  BOOST_REQUIRE(wait_for([&] { return blocked.load(); }));
+
+  std::atomic<size_t> count(0);
+  executor->submit([&] { count++; });
+  executor->submit([&] { count++; }, aws::utils::Priority::High);
+  BOOST_CHECK(wait_for([&] { return count == 2; },
+                       std::chrono::milliseconds(500)));
+  BOOST_CHECK(!release);
+
+  release = true;
+}
+
+BOOST_AUTO_TEST_SUITE_END()
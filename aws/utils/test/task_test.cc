@@ -0,0 +1,175 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <aws/utils/io_service_executor.h>
+#include <aws/utils/logging.h>
+#include <aws/utils/multi_reactor_executor.h>
+#include <aws/utils/task.h>
+#include <aws/utils/utils.h>
+
+namespace {
+
+// Counts live instances, to check that captures are destroyed exactly once.
+struct Tracked {
+  Tracked(std::shared_ptr<int> live) : live_(std::move(live)) {
+    (*live_)++;
+  }
+
+  Tracked(Tracked&& other) noexcept : live_(other.live_) {
+    (*live_)++;
+  }
+
+  Tracked(const Tracked&) = delete;
+
+  ~Tracked() {
+    (*live_)--;
+  }
+
+  std::shared_ptr<int> live_;
+};
+
+// The kind of closure the pipelines submit: this, a shared_ptr and a vector.
+struct Capture {
+  void* self;
+  std::shared_ptr<int> ctx;
+  std::vector<std::string> batch;
+};
+
+template <typename Submit>
+double submit_rate(size_t n, Submit&& submit) {
+  auto ctx = std::make_shared<int>(0);
+  std::vector<std::string> batch(4);
+  std::atomic<size_t> done(0);
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < n; i++) {
+    Capture c{nullptr, ctx, batch};
+    submit([c = std::move(c), &done]() mutable { done++; });
+  }
+  while (done < n) {
+    aws::utils::sleep_for(std::chrono::microseconds(100));
+  }
+  return n / aws::utils::seconds_since(start);
+}
+
+} //namespace
+
+BOOST_AUTO_TEST_SUITE(Task)
+
+BOOST_AUTO_TEST_CASE(Invoke) {
+  int calls = 0;
+  aws::utils::Task t([&] { calls++; });
+  BOOST_REQUIRE(t);
+  t();
+  t();
+  BOOST_CHECK_EQUAL(calls, 2);
+
+  aws::utils::Task empty;
+  BOOST_CHECK(!empty);
+  empty = nullptr;
+  BOOST_CHECK(!empty);
+}
+
+BOOST_AUTO_TEST_CASE(InlineAndHeap) {
+  auto small = [p = std::shared_ptr<int>(), v = std::vector<int>()] {};
+  BOOST_CHECK(aws::utils::Task::fits_inline<decltype(small)>());
+
+  std::array<char, aws::utils::Task::kInlineSize + 1> big_array{};
+  auto big = [big_array] {};
+  BOOST_CHECK(!aws::utils::Task::fits_inline<decltype(big)>());
+
+  int calls = 0;
+  aws::utils::Task t([&calls, big_array] { calls += big_array.size(); });
+  aws::utils::Task moved(std::move(t));
+  BOOST_CHECK(!t);
+  moved();
+  BOOST_CHECK_EQUAL(calls, big_array.size());
+}
+
+BOOST_AUTO_TEST_CASE(MoveOnlyCaptures) {
+  auto live = std::make_shared<int>(0);
+  {
+    auto p = std::make_unique<int>(42);
+    Tracked tracked(live);
+    int seen = 0;
+    aws::utils::Task t([p = std::move(p), tracked = std::move(tracked), &seen] {
+      seen = *p;
+    });
+    BOOST_CHECK_EQUAL(*live, 2);
+
+    aws::utils::Task u;
+    u = std::move(t);
+    u();
+    BOOST_CHECK_EQUAL(seen, 42);
+    BOOST_CHECK_EQUAL(*live, 2);
+
+    u = nullptr;
+    BOOST_CHECK_EQUAL(*live, 1);
+  }
+  BOOST_CHECK_EQUAL(*live, 0);
+}
+
+BOOST_AUTO_TEST_CASE(SubmitThroughput) {
+  const size_t N = 1000000;
+
+  {
+    auto executor = std::make_shared<aws::utils::IoServiceExecutor>(4);
+    auto rate = submit_rate(N, [&](auto&& f) {
+      executor->submit(std::forward<decltype(f)>(f));
+    });
+    LOG(info) << "IoServiceExecutor submit rate (Task): "
+              << rate / 1000 << " K per second";
+  }
+
+  // The same work wrapped in the std::function the executors used to take,
+  // posted to a plain io_context.
+  {
+    boost::asio::io_context io_context;
+    auto work = boost::asio::make_work_guard(io_context);
+    std::vector<aws::thread> threads;
+    for (size_t i = 0; i < 4; i++) {
+      threads.emplace_back([&] { io_context.run(); });
+    }
+    auto rate = submit_rate(N, [&](auto&& f) {
+      std::function<void ()> fn(std::forward<decltype(f)>(f));
+      boost::asio::post(io_context, std::move(fn));
+    });
+    LOG(info) << "io_context post rate (std::function): "
+              << rate / 1000 << " K per second";
+    work.reset();
+    for (auto& t : threads) {
+      t.join();
+    }
+  }
+
+  {
+    auto executor = std::make_shared<aws::utils::MultiReactorExecutor>(4);
+    auto rate = submit_rate(N, [&](auto&& f) {
+      executor->submit(std::forward<decltype(f)>(f));
+    });
+    LOG(info) << "MultiReactorExecutor submit rate (Task): "
+              << rate / 1000 << " K per second";
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -83,4 +83,51 @@ BOOST_AUTO_TEST_CASE(Multiple) {
   BOOST_CHECK(b.try_take({200, 500}));
 }
 
+BOOST_AUTO_TEST_CASE(SetRates) {
+  auto start =
+      std::chrono::steady_clock::time_point(
+          std::chrono::duration_cast<std::chrono::milliseconds>(
+              (std::chrono::steady_clock::now() + std::chrono::milliseconds(5))
+                  .time_since_epoch()));
+  aws::utils::sleep_until(start);
+
+  aws::utils::TokenBucket b;
+  b.add_token_stream(200, 1000);
+
+  BOOST_CHECK_THROW(b.set_rates({0, 0}), std::runtime_error);
+  BOOST_CHECK(b.try_take({200}));
+
+  // Tokens accrued at the old rate are kept.
+  aws::utils::sleep_until(start + std::chrono::milliseconds(100));
+  b.set_rates({0});
+
+  aws::utils::sleep_until(start + std::chrono::milliseconds(200));
+
+  BOOST_CHECK(!b.try_take({110}));
+  BOOST_CHECK(b.try_take({90}));
+
+  // The new rate only counts from when it was set.
+  b.set_rates({500});
+  aws::utils::sleep_until(start + std::chrono::milliseconds(300));
+
+  BOOST_CHECK(!b.try_take({80}));
+  BOOST_CHECK(b.try_take({40}));
+}
+
+BOOST_AUTO_TEST_CASE(SecondsUntil) {
+  aws::utils::TokenBucket b;
+  b.add_token_stream(200, 1000);
+  b.add_token_stream(500, 100);
+
+  BOOST_CHECK_EQUAL(b.seconds_until({200, 500}), 0);
+  BOOST_CHECK(b.try_take({200, 500}));
+
+  // The slowest stream decides.
+  BOOST_CHECK_CLOSE(b.seconds_until({100, 10}), 0.1, 5);
+  BOOST_CHECK_CLOSE(b.seconds_until({10, 50}), 0.5, 5);
+
+  // More than a stream can hold never becomes available.
+  BOOST_CHECK(std::isinf(b.seconds_until({201, 0})));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
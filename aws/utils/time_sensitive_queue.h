@@ -31,6 +31,11 @@ class TimeSensitiveQueue {
     consume<Deadline>(f);
   }
 
+  void consume_by_expiration(
+      const std::function<bool (const std::shared_ptr<T>&)>& f) {
+    consume<Expiration>(f);
+  }
+
   void consume_expired(
       const std::function<void (const std::shared_ptr<T>&)>& f) {
     consume<Expiration>([&](const auto& p) {
@@ -51,6 +56,12 @@ class TimeSensitiveQueue {
     return container_.size();
   }
 
+  // The item expiring first, null if the queue is empty.
+  std::shared_ptr<T> next_to_expire() const {
+    auto& idx = container_.template get<Expiration>();
+    return idx.empty() ? nullptr : *idx.begin();
+  }
+
  private:
   // Index tags
   struct Deadline {};
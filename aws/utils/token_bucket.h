@@ -17,6 +17,7 @@
 #define AWS_UTILS_TOKEN_BUCKET_H_
 
 #include <chrono>
+#include <limits>
 
 #include <aws/utils/utils.h>
 
@@ -46,6 +47,25 @@ class TokenStream {
     return tokens_;
   }
 
+  // Tokens accrued so far are kept; the new rate applies from now on.
+  void set_rate(double rate) noexcept {
+    tokens();
+    last_ = Clock::now();
+    rate_ = rate;
+  }
+
+  // Seconds until n tokens are available; infinite if they never will be.
+  double seconds_until(double n) noexcept {
+    auto deficit = n - tokens();
+    if (deficit <= 0) {
+      return 0;
+    }
+    if (n > max_ || rate_ <= 0) {
+      return std::numeric_limits<double>::infinity();
+    }
+    return deficit / rate_;
+  }
+
   void take(double n) noexcept {
     if (n > tokens()) {
       throw std::runtime_error("Not enough tokens");
@@ -86,6 +106,40 @@ class TokenBucket {
     return true;
   }
 
+  // Seconds until try_take would succeed with num_tokens.
+  double seconds_until(const std::initializer_list<double>& num_tokens) {
+    if (num_tokens.size() != streams_.size()) {
+      throw std::runtime_error("Size of num_tokens list must be the same as "
+                               "the number of token streams in the bucket");
+    }
+
+    double seconds = 0;
+    auto stream_it = streams_.begin();
+    auto nt_it = num_tokens.begin();
+    while (stream_it != streams_.end()) {
+      seconds = std::max(seconds, stream_it->seconds_until(*nt_it));
+      stream_it++;
+      nt_it++;
+    }
+    return seconds;
+  }
+
+  // Changes the growth rate of each stream, in the order they were added.
+  void set_rates(const std::initializer_list<double>& rates) {
+    if (rates.size() != streams_.size()) {
+      throw std::runtime_error("Size of rates list must be the same as the "
+                               "number of token streams in the bucket");
+    }
+
+    auto stream_it = streams_.begin();
+    auto rate_it = rates.begin();
+    while (stream_it != streams_.end()) {
+      stream_it->set_rate(*rate_it);
+      stream_it++;
+      rate_it++;
+    }
+  }
+
   bool can_take(const std::initializer_list<double>& num_tokens) {
     if (num_tokens.size() != streams_.size()) {
       throw std::runtime_error("Size of num_tokens list must be the same as "
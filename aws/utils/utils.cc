@@ -70,12 +70,13 @@ uint64_t random_int(uint64_t min_inclusive, uint64_t max_exlusive) {
 }
 
 std::string hex(const unsigned char* hash, size_t len) {
-  std::stringstream ss;
-  ss << std::hex << std::setfill('0');
+  static const char kDigits[] = "0123456789abcdef";
+  std::string s(2 * len, 0);
   for (size_t i = 0; i < len; ++i) {
-    ss << std::hex << std::setw(2) << (unsigned int) hash[i];
+    s[2 * i] = kDigits[hash[i] >> 4];
+    s[2 * i + 1] = kDigits[hash[i] & 0xF];
   }
-  return ss.str();
+  return s;
 }
 
 std::string md5(const std::string& data) {
@@ -70,7 +70,10 @@ public class Daemon {
         public void onError(Throwable t);
     }
     
-    private BlockingQueue<Message> outgoingMessages = new LinkedBlockingQueue<>();
+    /**
+     * Paused while the child is over its memory budget and has asked us to stop sending records.
+     */
+    private OutgoingMessageQueue outgoingMessages = new OutgoingMessageQueue();
     private BlockingQueue<Message> incomingMessages = new LinkedBlockingQueue<>();
 
     private ExecutorService executor = Executors
@@ -174,7 +177,10 @@ public class Daemon {
         }
         
         try {
-            outgoingMessages.put(m);
+            if (!outgoingMessages.put(m)) {
+                throw new DaemonException(
+                        "The child process has been shutdown and can no longer accept messages.");
+            }
         } catch (InterruptedException e) {
             fatalError("Unexpected error", e);
         }
@@ -218,7 +224,10 @@ public class Daemon {
      */
     private void sendMessage()  {
         try {
-            Message m = outgoingMessages.take();
+            Message m = outgoingMessages.next();
+            if (m == null) {
+                return;
+            }
             int size = m.getSerializedSize();
             lenBuf.rewind();
             lenBuf.putInt(size);
@@ -230,7 +239,7 @@ public class Daemon {
             fatalError("Error writing message to daemon", e);
         }
     }
-    
+
     /**
      * Read a message from the child process off the wire. If there are no bytes
      * available on the socket, or there if there are not enough bytes to form a
@@ -251,12 +260,28 @@ public class Daemon {
             
             // Deserialize message and add it to the queue
             Message m = Message.parseFrom(ByteString.copyFrom(rcvBuf));
+            if (m.hasBackpressure()) {
+                onBackpressure(m.getBackpressure());
+                return;
+            }
             incomingMessages.put(m);
         } catch (IOException | InterruptedException e) {
             fatalError("Error reading message from daemon", e);
         }
     }
     
+    /**
+     * Handled on the reading thread rather than passed to the message handler, so that a pause takes effect before
+     * any message received after it.
+     */
+    private void onBackpressure(Messages.Backpressure bp) {
+        if (bp.getPaused() != outgoingMessages.isPaused()) {
+            log.info("{} sending records to the child process, {} of {} bytes of its memory budget in use",
+                    bp.getPaused() ? "Pausing" : "Resuming", bp.getBufferedBytes(), bp.getBudgetBytes());
+        }
+        outgoingMessages.setPaused(bp.getPaused());
+    }
+    
     /**
      * Invokes the message handler, giving it a message received from the child
      * process.
@@ -513,6 +538,7 @@ public class Daemon {
     
     private synchronized void fatalError(String message, Throwable t, boolean retryable) {
         if (!shutdown.getAndSet(true)) {
+            outgoingMessages.close();
             if (process != null) {
                 if (stdErrReader != null) {
                     stdErrReader.prepareForShutdown();
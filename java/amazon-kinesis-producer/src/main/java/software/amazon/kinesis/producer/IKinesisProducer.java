@@ -26,6 +26,10 @@ public interface IKinesisProducer {
         throw new UnsupportedOperationException("This method is not supported in this IKinesisProducer type");
     }
 
+    default void updateConfiguration(KinesisProducerConfiguration newConfig) {
+        throw new UnsupportedOperationException("This method is not supported in this IKinesisProducer type");
+    }
+
     List<Metric> getMetrics(String metricName, int windowSeconds) throws InterruptedException, ExecutionException;
 
     List<Metric> getMetrics(String metricName) throws InterruptedException, ExecutionException;
@@ -40,5 +44,9 @@ public interface IKinesisProducer {
 
     void flush();
 
+    default ListenableFuture<Void> flushBarrier(String stream) {
+        throw new UnsupportedOperationException("This method is not supported in this IKinesisProducer type");
+    }
+
     void flushSync();
 }
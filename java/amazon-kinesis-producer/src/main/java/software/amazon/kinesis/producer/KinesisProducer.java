@@ -24,6 +24,7 @@ import software.amazon.kinesis.producer.protobuf.Messages.MetricsRequest;
 import software.amazon.kinesis.producer.protobuf.Messages.MetricsResponse;
 import software.amazon.kinesis.producer.protobuf.Messages.PutRecord;
 import software.amazon.kinesis.producer.protobuf.Messages.StreamMetadata;
+import software.amazon.kinesis.producer.protobuf.Messages.UpdateConfiguration;
 import com.amazonaws.services.schemaregistry.common.Schema;
 import com.amazonaws.services.schemaregistry.serializers.GlueSchemaRegistrySerializer;
 import com.google.common.collect.ImmutableMap;
@@ -64,6 +65,7 @@ import java.util.concurrent.ScheduledExecutorService;
 import java.util.concurrent.ScheduledThreadPoolExecutor;
 import java.util.concurrent.ThreadPoolExecutor;
 import java.util.concurrent.TimeUnit;
+import java.util.concurrent.TimeoutException;
 import java.util.concurrent.atomic.AtomicInteger;
 import java.util.concurrent.atomic.AtomicLong;
 /**
@@ -103,6 +105,7 @@ public class KinesisProducer implements IKinesisProducer {
     private final AtomicLong totalFutureTimeouts = new AtomicLong(0);
     private final GlueSchemaRegistrySerializerInstance glueSchemaRegistrySerializerInstance = new GlueSchemaRegistrySerializerInstance();
     private final Map<Long, SettableFutureTracker> futures = new ConcurrentHashMap<>();
+    private final Map<Long, SettableFuture<Void>> flushFutures = new ConcurrentHashMap<>();
     private final PriorityBlockingQueue<SettableFutureTracker> oldestFutureTrackerHeap = new PriorityBlockingQueue<>
             (10, new SettableFutureTrackerComparator());
     private final ScheduledThreadPoolExecutor futureTimeoutExecutor = new ScheduledThreadPoolExecutor(1,
@@ -190,6 +193,8 @@ public class KinesisProducer implements IKinesisProducer {
                         onPutRecordResult(m);
                     } else if (m.hasMetricsResponse()) {
                         onMetricsResponse(m);
+                    } else if (m.hasFlushComplete()) {
+                        onFlushComplete(m);
                     } else {
                         // clear the future here as well since the native core has exhausted its retries.
                         SettableFutureTracker futureTracker = getFuture(m);
@@ -224,6 +229,10 @@ public class KinesisProducer implements IKinesisProducer {
                 });
             }
             futures.clear();
+            for (final SettableFuture<Void> f : flushFutures.values()) {
+                f.setException(t);
+            }
+            flushFutures.clear();
             if (config.getEnableOldestFutureTracker()) {
                 oldestFutureTrackerHeap.clear();
             }
@@ -277,6 +286,13 @@ public class KinesisProducer implements IKinesisProducer {
             f.set(userMetrics);
         }
         
+        private void onFlushComplete(Message msg) {
+            SettableFuture<Void> f = flushFutures.remove(msg.getFlushComplete().getFlushId());
+            if (f != null) {
+                f.set(null);
+            }
+        }
+
         private SettableFutureTracker getFuture(Message msg) {
             long id = msg.getSourceId();
             SettableFutureTracker futureTracker = getFutureTracker(id);
@@ -836,6 +852,46 @@ public class KinesisProducer implements IKinesisProducer {
         addMessageToChild(m);
     }
 
+    /**
+     * Applies new buffering and rate limiting settings to the running child
+     * process, without restarting it.
+     * 
+     * <p>
+     * The following settings are taken from the given configuration:
+     * AggregationMaxCount, AggregationMaxSize, CollectionMaxCount,
+     * CollectionMaxSize, RateLimit, RecordMaxBufferedTime, RecordTtl and
+     * ShardMaxInFlight. All other settings are ignored. Records already
+     * buffered keep the deadline and TTL they were given when they were added.
+     * 
+     * <p>
+     * This method returns immediately without blocking. The child process
+     * validates the settings and rejects the whole update, logging an error,
+     * if any of them is invalid.
+     * 
+     * @param newConfig configuration holding the new settings
+     * @throws DaemonException
+     *             if the child process is dead
+     */
+    @Override
+    public void updateConfiguration(KinesisProducerConfiguration newConfig) {
+        Validate.notNull(newConfig, "Configuration should not be null");
+        UpdateConfiguration update = UpdateConfiguration.newBuilder()
+                .setAggregationMaxCount(newConfig.getAggregationMaxCount())
+                .setAggregationMaxSize(newConfig.getAggregationMaxSize())
+                .setCollectionMaxCount(newConfig.getCollectionMaxCount())
+                .setCollectionMaxSize(newConfig.getCollectionMaxSize())
+                .setRateLimit(newConfig.getRateLimit())
+                .setRecordMaxBufferedTime(newConfig.getRecordMaxBufferedTime())
+                .setRecordTtl(newConfig.getRecordTtl())
+                .setShardMaxInFlight(newConfig.getShardMaxInFlight())
+                .build();
+        Message m = Message.newBuilder()
+                .setId(messageNumber.getAndIncrement())
+                .setUpdateConfiguration(update)
+                .build();
+        addMessageToChild(m);
+    }
+
     /**
      * Get metrics from the KPL.
      * 
@@ -1036,6 +1092,8 @@ public class KinesisProducer implements IKinesisProducer {
      * call flush multiple times to clear all buffers.</li>
      * <li>Poll {@link #getOutstandingRecordsCount()} until it returns 0.</li>
      * <li>Call {@link #flushSync()}, which blocks until completion.</li>
+     * <li>Call {@link #flushBarrier(String)} and wait for the future it
+     * returns.</li>
      * </ul>
      * 
      * Once all records are confirmed with one of the above, call destroy to
@@ -1101,6 +1159,45 @@ public class KinesisProducer implements IKinesisProducer {
     public void flush() {
         flush(null);
     }
+
+    /**
+     * Instruct the child process to perform a flush, like {@link #flush(String)}, and get a future that completes
+     * once every record added before this call has completed (either succeeding or failing).
+     *
+     * <p>
+     * The child process replies as soon as the last of those records is done, so this takes about as long as sending
+     * them. Records added shortly after this call may be waited for as well, but later ones are not.
+     *
+     * <p>
+     * The future fails if the child process dies first.
+     *
+     * @param stream
+     *            Stream to flush, or null for all streams
+     * @return A future that completes once the records are done
+     * @throws DaemonException
+     *             if the child process is dead
+     */
+    @Override
+    public ListenableFuture<Void> flushBarrier(String stream) {
+        long id = messageNumber.getAndIncrement();
+        SettableFuture<Void> f = SettableFuture.create();
+        flushFutures.put(id, f);
+        Flush.Builder fb = Flush.newBuilder().setFlushId(id);
+        if (stream != null) {
+            fb.setStreamName(stream);
+        }
+        Message m = Message.newBuilder()
+                .setId(id)
+                .setFlush(fb.build())
+                .build();
+        try {
+            addMessageToChild(m);
+        } catch (RuntimeException e) {
+            flushFutures.remove(id);
+            throw e;
+        }
+        return f;
+    }
     
     /**
      * Instructs the child process to flush all records and waits until all
@@ -1125,10 +1222,13 @@ public class KinesisProducer implements IKinesisProducer {
     @Override
     public void flushSync() {
         while (getOutstandingRecordsCount() > 0) {
-            flush();
+            ListenableFuture<Void> f = flushBarrier(null);
             try {
-                Thread.sleep(500);
-            } catch (InterruptedException e) { }
+                f.get(500, TimeUnit.MILLISECONDS);
+            } catch (InterruptedException | ExecutionException | TimeoutException e) {
+                // Records added meanwhile or a restarted child process are
+                // covered by checking the count again.
+            }
         }
     }
 
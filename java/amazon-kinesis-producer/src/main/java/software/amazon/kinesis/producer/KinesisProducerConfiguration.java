@@ -28,6 +28,7 @@ import java.io.FileInputStream;
 import java.io.InputStream;
 import java.lang.reflect.Method;
 import java.util.ArrayList;
+import java.util.Collections;
 import java.util.Enumeration;
 import java.util.List;
 import java.util.Properties;
@@ -40,6 +41,7 @@ import java.util.regex.Pattern;
 public class KinesisProducerConfiguration {
     private static final Logger log = LoggerFactory.getLogger(KinesisProducerConfiguration.class);
     private List<AdditionalDimension> additionalDims = new ArrayList<>();
+    private List<StreamOverride> streamOverrides = new ArrayList<>();
     private AwsCredentialsProvider credentialsProvider = DefaultCredentialsProvider.create();
     private AwsCredentialsProvider metricsCredentialsProvider = null;
     private AwsCredentialsProvider glueSchemaRegistryCredentialsProvider = DefaultCredentialsProvider.create();
@@ -85,6 +87,35 @@ public class KinesisProducerConfiguration {
         additionalDims.add(AdditionalDimension.newBuilder().setKey(key).setValue(value).setGranularity(granularity).build());
     }
 
+    /**
+     * Use different buffering and rate limiting settings for some streams.
+     *
+     * <p>
+     * For example, a high volume stream can aggregate more and buffer longer, while a low volume stream that needs
+     * low latency sends records right away, without running a second producer. Streams no override matches use the
+     * settings of this configuration.
+     *
+     * <p>
+     * Overrides are applied when the native process first sees a stream. Settings changed later with
+     * {@link KinesisProducer#updateConfiguration(KinesisProducerConfiguration)} apply to streams with an override
+     * too, except for the settings the override sets.
+     *
+     * @param streamOverride
+     *            Settings for the streams it matches
+     * @see StreamOverride
+     */
+    public KinesisProducerConfiguration addStreamOverride(StreamOverride streamOverride) {
+        streamOverrides.add(streamOverride);
+        return this;
+    }
+
+    /**
+     * @see #addStreamOverride(StreamOverride)
+     */
+    public List<StreamOverride> getStreamOverrides() {
+        return streamOverrides;
+    }
+
     /**
      * {@link AwsCredentialsProvider} that supplies credentials used to put records to Kinesis. These credentials will
      * also be used to upload metrics to CloudWatch, unless {@link #setMetricsCredentialsProvider} is used to provide
@@ -324,6 +355,9 @@ public class KinesisProducerConfiguration {
     }
 
     protected Configuration.Builder additionalConfigsToProtobuf(Configuration.Builder builder) {
+        for (StreamOverride o : streamOverrides) {
+            builder.addStreamOverrides(o.toProtobufMessage());
+        }
         return builder.addAllAdditionalMetricDims(additionalDims);
     }
 
@@ -339,7 +373,14 @@ public class KinesisProducerConfiguration {
          * Tells the native process to use a thread pool. The size of the pool can be controlled by
          * {@link KinesisProducerConfiguration#setThreadPoolSize(int)}.
          */
-        POOLED(Configuration.ThreadConfig.POOLED);
+        POOLED(Configuration.ThreadConfig.POOLED),
+        /**
+         * Tells the native process to use a thread pool that grows with the number of requests in flight and shrinks
+         * again when threads go idle. The maximum size of the pool can be controlled by
+         * {@link KinesisProducerConfiguration#setThreadPoolSize(int)}. Responses are handled on the thread that made
+         * the request, saving a hand-off per request.
+         */
+        ELASTIC(Configuration.ThreadConfig.ELASTIC);
 
         final Configuration.ThreadConfig threadConfig;
 
@@ -385,6 +426,30 @@ public class KinesisProducerConfiguration {
     private long stsPort = 443L;
     private ThreadingModel threadingModel = ThreadingModel.PER_REQUEST;
     private int threadPoolSize = 0;
+    private String shardMapCacheDir = "";
+    private long shardMapCacheTtl = 3600000L;
+    private List<String> prewarmStreams = new ArrayList<>();
+    private boolean prewarmConnections = false;
+    private long prewarmTimeout = 10000L;
+    private int executorThreads = 0;
+    private boolean executorMultiReactor = false;
+    private String ipcThreadCpus = "";
+    private String executorThreadCpus = "";
+    private String sdkThreadCpus = "";
+    private boolean numaBindMemory = false;
+    private long memoryBudget = 0L;
+    private String memoryBudgetPolicy = "fail";
+    private String spillDir = "";
+    private long spillHighWaterMark = 134217728L;
+    private long spillMaxBytes = 1073741824L;
+    private boolean spillKeepOnRestart = false;
+    private boolean directSend = false;
+    private long directSendMaxInFlight = 8L;
+    private boolean adaptiveLinger = false;
+    private boolean directRequestEncoding = false;
+    private boolean nativeTransport = false;
+    private boolean parallelSerialization = false;
+    private long shardMaxInFlight = 0L;
     private String caCertPath = "";
     private String caCertFile = "";
     private String glueSchemaRegistryPropertiesFilePath = "";
@@ -713,6 +778,11 @@ public class KinesisProducerConfiguration {
      * Minimum number of connections to keep open to the backend.
      * 
      * <p>
+     * When the producer is idle, it sends lightweight requests every 30 seconds
+     * to keep this many connections established, so that the next burst of
+     * records does not have to wait for new TLS handshakes.
+     * 
+     * <p>
      * There should be no need to increase this in general.
      * 
      * <p><b>Default</b>: 1
@@ -938,7 +1008,7 @@ public class KinesisProducerConfiguration {
 
     /**
      * This configures the maximum number of threads the thread pool in the native process will use. This is only used
-     * when {@link #getThreadingModel()} is set to {@link ThreadingModel#POOLED}.
+     * when {@link #getThreadingModel()} is set to {@link ThreadingModel#POOLED} or {@link ThreadingModel#ELASTIC}.
      *
      * <dl>
      * <dt>Default</dt>
@@ -954,6 +1024,294 @@ public class KinesisProducerConfiguration {
         return threadPoolSize;
     }
 
+    /**
+     * Directory in which the native process keeps a copy of each stream's shard map, so that after a restart it can
+     * start aggregating before it has listed the shards of the stream.
+     *
+     * <p>
+     * An empty value disables the cache.
+     *
+     * <p><b>Default</b>: ""
+     */
+    public String getShardMapCacheDir() {
+        return shardMapCacheDir;
+    }
+
+    /**
+     * Maximum age in milliseconds of a cached shard map for it to be used at startup. A cached shard map is refreshed
+     * from Kinesis in the background once the native process has started.
+     *
+     * <p><b>Default</b>: 3600000
+     * <p><b>Minimum</b>: 1000
+     * <p><b>Maximum (inclusive)</b>: 604800000
+     */
+    public long getShardMapCacheTtl() {
+        return shardMapCacheTtl;
+    }
+
+    /**
+     * Streams to set up when the native process starts, before it accepts any records. Their pipelines are created and
+     * their shard maps fetched up front, so the first records put to them are aggregated right away.
+     *
+     * <p><b>Default</b>: empty
+     */
+    public List<String> getPrewarmStreams() {
+        return Collections.unmodifiableList(prewarmStreams);
+    }
+
+    /**
+     * When pre-warming streams, also open {@link #getMinConnections()} connections to Kinesis before accepting
+     * records.
+     *
+     * <p><b>Default</b>: false
+     */
+    public boolean isPrewarmConnections() {
+        return prewarmConnections;
+    }
+
+    /**
+     * Maximum time in milliseconds to spend pre-warming streams at startup. The native process starts accepting
+     * records after this even if pre-warming has not finished.
+     *
+     * <p><b>Default</b>: 10000
+     * <p><b>Minimum</b>: 100
+     * <p><b>Maximum (inclusive)</b>: 300000
+     */
+    public long getPrewarmTimeout() {
+        return prewarmTimeout;
+    }
+
+    /**
+     * Number of threads running the native process's internal work: aggregation, timers and handling of responses. 0
+     * picks a number based on the number of cores, up to 8.
+     *
+     * <p><b>Default</b>: 0
+     * <p><b>Minimum</b>: 0
+     * <p><b>Maximum (inclusive)</b>: 1024
+     */
+    public int getExecutorThreads() {
+        return executorThreads;
+    }
+
+    /**
+     * Give each executor thread its own event loop and run queue instead of sharing one between all threads. Work
+     * belonging to a stream stays on one thread, and idle threads take over work queued on busy ones. Reduces
+     * contention on hosts with many cores.
+     *
+     * <p><b>Default</b>: false
+     */
+    public boolean isExecutorMultiReactor() {
+        return executorMultiReactor;
+    }
+
+    /**
+     * CPUs to run the IPC threads on: the threads reading and writing the pipes to the wrapper, and the thread
+     * handing received records to the executor. A list in the format of taskset, e.g. "0-3,8". Empty lets the OS
+     * place them. Only supported on Linux.
+     *
+     * <p><b>Default</b>: ""
+     * <p><b>Expected pattern</b>: ^(\\d+(-\\d+)?(,\\d+(-\\d+)?)*)?$
+     */
+    public String getIpcThreadCpus() {
+        return ipcThreadCpus;
+    }
+
+    /**
+     * CPUs to run the executor threads on, in the same format as ipcThreadCpus. Each thread is pinned to one CPU of
+     * the list, going round the list if there are more threads than CPUs.
+     *
+     * <p><b>Default</b>: ""
+     * <p><b>Expected pattern</b>: ^(\\d+(-\\d+)?(,\\d+(-\\d+)?)*)?$
+     */
+    public String getExecutorThreadCpus() {
+        return executorThreadCpus;
+    }
+
+    /**
+     * CPUs to run the threads of the AWS SDK clients on, in the same format as ipcThreadCpus.
+     *
+     * <p><b>Default</b>: ""
+     * <p><b>Expected pattern</b>: ^(\\d+(-\\d+)?(,\\d+(-\\d+)?)*)?$
+     */
+    public String getSdkThreadCpus() {
+        return sdkThreadCpus;
+    }
+
+    /**
+     * Have threads pinned with ipcThreadCpus, executorThreadCpus and sdkThreadCpus allocate memory from the NUMA
+     * node of their CPUs. Combined with executorMultiReactor, each stream's pipeline allocates from the node of the
+     * thread it runs on.
+     *
+     * <p><b>Default</b>: false
+     */
+    public boolean isNumaBindMemory() {
+        return numaBindMemory;
+    }
+
+    /**
+     * Maximum bytes of records held by the native process across all streams, from the time they are put until their
+     * results are returned. What happens when it is exceeded is set by memoryBudgetPolicy. 0 means no limit.
+     *
+     * <p><b>Default</b>: 0
+     * <p><b>Minimum</b>: 0
+     * <p><b>Maximum (inclusive)</b>: 9223372036854775807
+     */
+    public long getMemoryBudget() {
+        return memoryBudget;
+    }
+
+    /**
+     * What to do when memoryBudget is exceeded.
+     *
+     * <p>
+     * "fail" fails each record put while over the budget with the error code MemoryBudgetExceeded.
+     *
+     * <p>
+     * "drop_oldest" fails records of the same stream that are waiting to be sent, those closest to expiring first,
+     * to make room. New records are failed only if not enough can be dropped.
+     *
+     * <p>
+     * "backpressure" accepts all records, but holds back sending new records to the native process while over the
+     * budget, until usage has come down to 90% of it. Records added in the meantime wait in the outgoing queue; once
+     * 100,000 messages are waiting there, addUserRecord and flush block until sending resumes.
+     *
+     * <p><b>Default</b>: fail
+     * <p><b>Expected pattern</b>: fail|drop_oldest|backpressure
+     */
+    public String getMemoryBudgetPolicy() {
+        return memoryBudgetPolicy;
+    }
+
+    /**
+     * Directory in which to keep a spill log per stream. While the native process holds more than spillHighWaterMark
+     * bytes of records, records put are written to the log instead of being kept in memory, and they are read back in
+     * order as memory frees up. Lets the producer ride out a stream being throttled or unreachable for minutes without
+     * holding everything in memory. Each producer needs a directory of its own. Empty disables spilling.
+     *
+     * <p><b>Default</b>: ""
+     */
+    public String getSpillDir() {
+        return spillDir;
+    }
+
+    /**
+     * Bytes of records held in memory, across all streams, above which new records are spilled to disk. Only used if
+     * spillDir is set; should be below memoryBudget if that is set. Spilled records are read back once usage is under
+     * 90% of this.
+     *
+     * <p><b>Default</b>: 134217728
+     * <p><b>Minimum</b>: 0
+     * <p><b>Maximum (inclusive)</b>: 9223372036854775807
+     */
+    public long getSpillHighWaterMark() {
+        return spillHighWaterMark;
+    }
+
+    /**
+     * Maximum disk space (bytes) taken by the spill log of each stream. Once it is full, records are kept in memory
+     * again.
+     *
+     * <p><b>Default</b>: 1073741824
+     * <p><b>Minimum</b>: 8388608
+     * <p><b>Maximum (inclusive)</b>: 9223372036854775807
+     */
+    public long getSpillMaxBytes() {
+        return spillMaxBytes;
+    }
+
+    /**
+     * Keep spill logs when the native process shuts down or crashes, and send the records left in them when it starts
+     * again with the same spillDir. Their results are not returned, since the process that put them is gone, so
+     * records can be sent twice if the application also retried them.
+     *
+     * <p><b>Default</b>: false
+     */
+    public boolean isSpillKeepOnRestart() {
+        return spillKeepOnRestart;
+    }
+
+    /**
+     * Send records as soon as they clear the rate limiter and a request slot is free, instead of aggregating and
+     * collecting them. Each request holds the records that are ready when it is sent, and nothing waits for more to
+     * arrive, so recordMaxBufferedTime and the aggregation settings have no effect. Meant for low volume streams where
+     * latency matters more than throughput, usually set through a {@link StreamOverride}.
+     *
+     * <p><b>Default</b>: false
+     */
+    public boolean isDirectSend() {
+        return directSend;
+    }
+
+    /**
+     * Maximum number of PutRecords requests in flight at once for a stream in directSend mode. Records that are ready
+     * while all are in flight are sent together when one completes.
+     *
+     * <p><b>Default</b>: 8
+     * <p><b>Minimum</b>: 1
+     * <p><b>Maximum (inclusive)</b>: 1024
+     */
+    public long getDirectSendMaxInFlight() {
+        return directSendMaxInFlight;
+    }
+
+    /**
+     * Let each shard's aggregator choose how long records wait, from the rate records have been arriving at, rather
+     * than always waiting recordMaxBufferedTime. Records that are unlikely to be joined by another before
+     * recordMaxBufferedTime are sent right away; otherwise they wait until the aggregated record is expected to fill,
+     * with some allowance, and never longer than recordMaxBufferedTime. Only used with aggregation.
+     *
+     * <p><b>Default</b>: false
+     */
+    public boolean isAdaptiveLinger() {
+        return adaptiveLinger;
+    }
+
+    /**
+     * Write the body of PutRecords requests straight from the records, instead of building the SDK's request model
+     * and having the SDK serialize it. This saves copying every record twice on the way to the wire. Requests are then
+     * sent with blocking calls on the SDK's threads, as the SDK's async calls would have done.
+     *
+     * <p><b>Default</b>: false
+     */
+    public boolean isDirectRequestEncoding() {
+        return directRequestEncoding;
+    }
+
+    /**
+     * Send PutRecords requests over the KPL's own HTTP connections instead of through the SDK's HTTP client. Requests
+     * are signed and sent by the KPL's worker threads, over up to {@link #getMaxConnections()} keep-alive connections
+     * to the Kinesis endpoint. Ignored when a proxy is configured.
+     *
+     * <p><b>Default</b>: false
+     */
+    public boolean isNativeTransport() {
+        return nativeTransport;
+    }
+
+    /**
+     * Serialize the aggregated records of large PutRecords requests in parallel on the KPL's worker threads before the
+     * request is assembled, instead of one after the other on the thread that flushed the request. Requests with
+     * little aggregated data are not split up.
+     *
+     * <p><b>Default</b>: false
+     */
+    public boolean isParallelSerialization() {
+        return parallelSerialization;
+    }
+
+    /**
+     * Maximum number of PutRecords requests in flight at once that contain records for the same shard. Records for a
+     * shard whose requests are all in flight are held back and sent when one of them completes, which keeps bursts
+     * from hitting one shard with several requests at a time. 0 means no limit.
+     *
+     * <p><b>Default</b>: 0
+     * <p><b>Minimum</b>: 0
+     * <p><b>Maximum (inclusive)</b>: 1024
+     */
+    public long getShardMaxInFlight() {
+        return shardMaxInFlight;
+    }
+
     /**
      * Value in millis when the user submitted records will be timed out at the Java layer.
      *
@@ -1412,6 +1770,11 @@ public class KinesisProducerConfiguration {
      * Minimum number of connections to keep open to the backend.
      * 
      * <p>
+     * When the producer is idle, it sends lightweight requests every 30 seconds
+     * to keep this many connections established, so that the next burst of
+     * records does not have to wait for new TLS handshakes.
+     * 
+     * <p>
      * There should be no need to increase this in general.
      * 
      * <p><b>Default</b>: 1
@@ -1724,6 +2087,369 @@ public class KinesisProducerConfiguration {
         return this;
     }
 
+    /**
+     * Directory in which the native process keeps a copy of each stream's shard map, so that after a restart it can
+     * start aggregating before it has listed the shards of the stream.
+     *
+     * <p>
+     * An empty value disables the cache.
+     *
+     * <p><b>Default</b>: ""
+     */
+    public KinesisProducerConfiguration setShardMapCacheDir(String val) {
+        shardMapCacheDir = val;
+        return this;
+    }
+
+    /**
+     * Maximum age in milliseconds of a cached shard map for it to be used at startup. A cached shard map is refreshed
+     * from Kinesis in the background once the native process has started.
+     *
+     * <p><b>Default</b>: 3600000
+     * <p><b>Minimum</b>: 1000
+     * <p><b>Maximum (inclusive)</b>: 604800000
+     */
+    public KinesisProducerConfiguration setShardMapCacheTtl(long val) {
+        if (val < 1000L || val > 604800000L) {
+            throw new IllegalArgumentException("shardMapCacheTtl must be between 1000 and 604800000, got " + val);
+        }
+        shardMapCacheTtl = val;
+        return this;
+    }
+
+    /**
+     * Streams to set up when the native process starts, before it accepts any records. Their pipelines are created and
+     * their shard maps fetched up front, so the first records put to them are aggregated right away.
+     *
+     * <p><b>Default</b>: empty
+     */
+    public KinesisProducerConfiguration setPrewarmStreams(List<String> val) {
+        prewarmStreams = new ArrayList<>(val);
+        return this;
+    }
+
+    /**
+     * Sets the streams to pre-warm from a comma separated list of stream names.
+     *
+     * @see #setPrewarmStreams(List)
+     */
+    public KinesisProducerConfiguration setPrewarmStreams(String val) {
+        List<String> streams = new ArrayList<>();
+        for (String stream : val.split(",")) {
+            if (!stream.trim().isEmpty()) {
+                streams.add(stream.trim());
+            }
+        }
+        return setPrewarmStreams(streams);
+    }
+
+    /**
+     * When pre-warming streams, also open {@link #getMinConnections()} connections to Kinesis before accepting
+     * records.
+     *
+     * <p><b>Default</b>: false
+     */
+    public KinesisProducerConfiguration setPrewarmConnections(boolean val) {
+        prewarmConnections = val;
+        return this;
+    }
+
+    /**
+     * Maximum time in milliseconds to spend pre-warming streams at startup. The native process starts accepting
+     * records after this even if pre-warming has not finished.
+     *
+     * <p><b>Default</b>: 10000
+     * <p><b>Minimum</b>: 100
+     * <p><b>Maximum (inclusive)</b>: 300000
+     */
+    public KinesisProducerConfiguration setPrewarmTimeout(long val) {
+        if (val < 100L || val > 300000L) {
+            throw new IllegalArgumentException("prewarmTimeout must be between 100 and 300000, got " + val);
+        }
+        prewarmTimeout = val;
+        return this;
+    }
+
+    /**
+     * Number of threads running the native process's internal work: aggregation, timers and handling of responses. 0
+     * picks a number based on the number of cores, up to 8.
+     *
+     * <p><b>Default</b>: 0
+     * <p><b>Minimum</b>: 0
+     * <p><b>Maximum (inclusive)</b>: 1024
+     */
+    public KinesisProducerConfiguration setExecutorThreads(int val) {
+        if (val < 0 || val > 1024) {
+            throw new IllegalArgumentException("executorThreads must be between 0 and 1024, got " + val);
+        }
+        executorThreads = val;
+        return this;
+    }
+
+    /**
+     * Give each executor thread its own event loop and run queue instead of sharing one between all threads. Work
+     * belonging to a stream stays on one thread, and idle threads take over work queued on busy ones. Reduces
+     * contention on hosts with many cores.
+     *
+     * <p><b>Default</b>: false
+     */
+    public KinesisProducerConfiguration setExecutorMultiReactor(boolean val) {
+        executorMultiReactor = val;
+        return this;
+    }
+
+    /**
+     * CPUs to run the IPC threads on: the threads reading and writing the pipes to the wrapper, and the thread
+     * handing received records to the executor. A list in the format of taskset, e.g. "0-3,8". Empty lets the OS
+     * place them. Only supported on Linux.
+     *
+     * <p><b>Default</b>: ""
+     * <p><b>Expected pattern</b>: ^(\\d+(-\\d+)?(,\\d+(-\\d+)?)*)?$
+     */
+    public KinesisProducerConfiguration setIpcThreadCpus(String val) {
+        if (!Pattern.matches("^(\\d+(-\\d+)?(,\\d+(-\\d+)?)*)?$", val)) {
+            throw new IllegalArgumentException("ipcThreadCpus must match the pattern ^(\\d+(-\\d+)?(,\\d+(-\\d+)?)*)?$, got " + val);
+        }
+        ipcThreadCpus = val;
+        return this;
+    }
+
+    /**
+     * CPUs to run the executor threads on, in the same format as ipcThreadCpus. Each thread is pinned to one CPU of
+     * the list, going round the list if there are more threads than CPUs.
+     *
+     * <p><b>Default</b>: ""
+     * <p><b>Expected pattern</b>: ^(\\d+(-\\d+)?(,\\d+(-\\d+)?)*)?$
+     */
+    public KinesisProducerConfiguration setExecutorThreadCpus(String val) {
+        if (!Pattern.matches("^(\\d+(-\\d+)?(,\\d+(-\\d+)?)*)?$", val)) {
+            throw new IllegalArgumentException("executorThreadCpus must match the pattern ^(\\d+(-\\d+)?(,\\d+(-\\d+)?)*)?$, got " + val);
+        }
+        executorThreadCpus = val;
+        return this;
+    }
+
+    /**
+     * CPUs to run the threads of the AWS SDK clients on, in the same format as ipcThreadCpus.
+     *
+     * <p><b>Default</b>: ""
+     * <p><b>Expected pattern</b>: ^(\\d+(-\\d+)?(,\\d+(-\\d+)?)*)?$
+     */
+    public KinesisProducerConfiguration setSdkThreadCpus(String val) {
+        if (!Pattern.matches("^(\\d+(-\\d+)?(,\\d+(-\\d+)?)*)?$", val)) {
+            throw new IllegalArgumentException("sdkThreadCpus must match the pattern ^(\\d+(-\\d+)?(,\\d+(-\\d+)?)*)?$, got " + val);
+        }
+        sdkThreadCpus = val;
+        return this;
+    }
+
+    /**
+     * Have threads pinned with ipcThreadCpus, executorThreadCpus and sdkThreadCpus allocate memory from the NUMA
+     * node of their CPUs. Combined with executorMultiReactor, each stream's pipeline allocates from the node of the
+     * thread it runs on.
+     *
+     * <p><b>Default</b>: false
+     */
+    public KinesisProducerConfiguration setNumaBindMemory(boolean val) {
+        numaBindMemory = val;
+        return this;
+    }
+
+    /**
+     * Maximum bytes of records held by the native process across all streams, from the time they are put until their
+     * results are returned. What happens when it is exceeded is set by memoryBudgetPolicy. 0 means no limit.
+     *
+     * <p><b>Default</b>: 0
+     * <p><b>Minimum</b>: 0
+     * <p><b>Maximum (inclusive)</b>: 9223372036854775807
+     */
+    public KinesisProducerConfiguration setMemoryBudget(long val) {
+        if (val < 0L || val > 9223372036854775807L) {
+            throw new IllegalArgumentException("memoryBudget must be between 0 and 9223372036854775807, got " + val);
+        }
+        memoryBudget = val;
+        return this;
+    }
+
+    /**
+     * What to do when memoryBudget is exceeded.
+     *
+     * <p>
+     * "fail" fails each record put while over the budget with the error code MemoryBudgetExceeded.
+     *
+     * <p>
+     * "drop_oldest" fails records of the same stream that are waiting to be sent, those closest to expiring first,
+     * to make room. New records are failed only if not enough can be dropped.
+     *
+     * <p>
+     * "backpressure" accepts all records, but holds back sending new records to the native process while over the
+     * budget, until usage has come down to 90% of it. Records added in the meantime wait in the outgoing queue; once
+     * 100,000 messages are waiting there, addUserRecord and flush block until sending resumes.
+     *
+     * <p><b>Default</b>: fail
+     * <p><b>Expected pattern</b>: fail|drop_oldest|backpressure
+     */
+    public KinesisProducerConfiguration setMemoryBudgetPolicy(String val) {
+        if (!Pattern.matches("fail|drop_oldest|backpressure", val)) {
+            throw new IllegalArgumentException("memoryBudgetPolicy must match the pattern fail|drop_oldest|backpressure, got " + val);
+        }
+        memoryBudgetPolicy = val;
+        return this;
+    }
+
+    /**
+     * Directory in which to keep a spill log per stream. While the native process holds more than spillHighWaterMark
+     * bytes of records, records put are written to the log instead of being kept in memory, and they are read back in
+     * order as memory frees up. Lets the producer ride out a stream being throttled or unreachable for minutes without
+     * holding everything in memory. Each producer needs a directory of its own. Empty disables spilling.
+     *
+     * <p><b>Default</b>: ""
+     */
+    public KinesisProducerConfiguration setSpillDir(String val) {
+        spillDir = val;
+        return this;
+    }
+
+    /**
+     * Bytes of records held in memory, across all streams, above which new records are spilled to disk. Only used if
+     * spillDir is set; should be below memoryBudget if that is set. Spilled records are read back once usage is under
+     * 90% of this.
+     *
+     * <p><b>Default</b>: 134217728
+     * <p><b>Minimum</b>: 0
+     * <p><b>Maximum (inclusive)</b>: 9223372036854775807
+     */
+    public KinesisProducerConfiguration setSpillHighWaterMark(long val) {
+        if (val < 0L || val > 9223372036854775807L) {
+            throw new IllegalArgumentException("spillHighWaterMark must be between 0 and 9223372036854775807, got " + val);
+        }
+        spillHighWaterMark = val;
+        return this;
+    }
+
+    /**
+     * Maximum disk space (bytes) taken by the spill log of each stream. Once it is full, records are kept in memory
+     * again.
+     *
+     * <p><b>Default</b>: 1073741824
+     * <p><b>Minimum</b>: 8388608
+     * <p><b>Maximum (inclusive)</b>: 9223372036854775807
+     */
+    public KinesisProducerConfiguration setSpillMaxBytes(long val) {
+        if (val < 8388608L || val > 9223372036854775807L) {
+            throw new IllegalArgumentException("spillMaxBytes must be between 8388608 and 9223372036854775807, got " + val);
+        }
+        spillMaxBytes = val;
+        return this;
+    }
+
+    /**
+     * Keep spill logs when the native process shuts down or crashes, and send the records left in them when it starts
+     * again with the same spillDir. Their results are not returned, since the process that put them is gone, so
+     * records can be sent twice if the application also retried them.
+     *
+     * <p><b>Default</b>: false
+     */
+    public KinesisProducerConfiguration setSpillKeepOnRestart(boolean val) {
+        spillKeepOnRestart = val;
+        return this;
+    }
+
+    /**
+     * Send records as soon as they clear the rate limiter and a request slot is free, instead of aggregating and
+     * collecting them. Each request holds the records that are ready when it is sent, and nothing waits for more to
+     * arrive, so recordMaxBufferedTime and the aggregation settings have no effect. Meant for low volume streams where
+     * latency matters more than throughput, usually set through a {@link StreamOverride}.
+     *
+     * <p><b>Default</b>: false
+     */
+    public KinesisProducerConfiguration setDirectSend(boolean val) {
+        directSend = val;
+        return this;
+    }
+
+    /**
+     * Maximum number of PutRecords requests in flight at once for a stream in directSend mode. Records that are ready
+     * while all are in flight are sent together when one completes.
+     *
+     * <p><b>Default</b>: 8
+     * <p><b>Minimum</b>: 1
+     * <p><b>Maximum (inclusive)</b>: 1024
+     */
+    public KinesisProducerConfiguration setDirectSendMaxInFlight(long val) {
+        if (val < 1L || val > 1024L) {
+            throw new IllegalArgumentException("directSendMaxInFlight must be between 1 and 1024, got " + val);
+        }
+        directSendMaxInFlight = val;
+        return this;
+    }
+
+    /**
+     * Let each shard's aggregator choose how long records wait, from the rate records have been arriving at, rather
+     * than always waiting recordMaxBufferedTime. Records that are unlikely to be joined by another before
+     * recordMaxBufferedTime are sent right away; otherwise they wait until the aggregated record is expected to fill,
+     * with some allowance, and never longer than recordMaxBufferedTime. Only used with aggregation.
+     *
+     * <p><b>Default</b>: false
+     */
+    public KinesisProducerConfiguration setAdaptiveLinger(boolean val) {
+        adaptiveLinger = val;
+        return this;
+    }
+
+    /**
+     * Write the body of PutRecords requests straight from the records, instead of building the SDK's request model
+     * and having the SDK serialize it. This saves copying every record twice on the way to the wire. Requests are then
+     * sent with blocking calls on the SDK's threads, as the SDK's async calls would have done.
+     *
+     * <p><b>Default</b>: false
+     */
+    public KinesisProducerConfiguration setDirectRequestEncoding(boolean val) {
+        directRequestEncoding = val;
+        return this;
+    }
+
+    /**
+     * Send PutRecords requests over the KPL's own HTTP connections instead of through the SDK's HTTP client. Requests
+     * are signed and sent by the KPL's worker threads, over up to {@link #getMaxConnections()} keep-alive connections
+     * to the Kinesis endpoint. Ignored when a proxy is configured.
+     *
+     * <p><b>Default</b>: false
+     */
+    public KinesisProducerConfiguration setNativeTransport(boolean val) {
+        nativeTransport = val;
+        return this;
+    }
+
+    /**
+     * Serialize the aggregated records of large PutRecords requests in parallel on the KPL's worker threads before the
+     * request is assembled, instead of one after the other on the thread that flushed the request. Requests with
+     * little aggregated data are not split up.
+     *
+     * <p><b>Default</b>: false
+     */
+    public KinesisProducerConfiguration setParallelSerialization(boolean val) {
+        parallelSerialization = val;
+        return this;
+    }
+
+    /**
+     * Maximum number of PutRecords requests in flight at once that contain records for the same shard. Records for a
+     * shard whose requests are all in flight are held back and sent when one of them completes, which keeps bursts
+     * from hitting one shard with several requests at a time. 0 means no limit.
+     *
+     * <p><b>Default</b>: 0
+     * <p><b>Minimum</b>: 0
+     * <p><b>Maximum (inclusive)</b>: 1024
+     */
+    public KinesisProducerConfiguration setShardMaxInFlight(long val) {
+        if (val < 0L || val > 1024L) {
+            throw new IllegalArgumentException("shardMaxInFlight must be between 0 and 1024, got " + val);
+        }
+        shardMaxInFlight = val;
+        return this;
+    }
+
     /**
      * Set the value in millis when the user submitted records will be timed out at the Java layer. Please be careful
      * around setting this value and not to set it too low which can cause high amount records timing out.
@@ -1847,6 +2573,30 @@ public class KinesisProducerConfiguration {
                 .setProxyPort(proxyPort)
                 .setProxyUserName(proxyUserName)
                 .setProxyPassword(proxyPassword)
+                .setShardMapCacheDir(shardMapCacheDir)
+                .setShardMapCacheTtl(shardMapCacheTtl)
+                .addAllPrewarmStreams(prewarmStreams)
+                .setPrewarmConnections(prewarmConnections)
+                .setPrewarmTimeout(prewarmTimeout)
+                .setExecutorThreads(executorThreads)
+                .setExecutorMultiReactor(executorMultiReactor)
+                .setIpcThreadCpus(ipcThreadCpus)
+                .setExecutorThreadCpus(executorThreadCpus)
+                .setSdkThreadCpus(sdkThreadCpus)
+                .setNumaBindMemory(numaBindMemory)
+                .setMemoryBudget(memoryBudget)
+                .setMemoryBudgetPolicy(memoryBudgetPolicy)
+                .setSpillDir(spillDir)
+                .setSpillHighWaterMark(spillHighWaterMark)
+                .setSpillMaxBytes(spillMaxBytes)
+                .setSpillKeepOnRestart(spillKeepOnRestart)
+                .setDirectSend(directSend)
+                .setDirectSendMaxInFlight(directSendMaxInFlight)
+                .setAdaptiveLinger(adaptiveLinger)
+                .setDirectRequestEncoding(directRequestEncoding)
+                .setNativeTransport(nativeTransport)
+                .setParallelSerialization(parallelSerialization)
+                .setShardMaxInFlight(shardMaxInFlight)
                 .setThreadConfig(threadingModel.threadConfig);
         //@formatter:on
         if (threadPoolSize > 0) {
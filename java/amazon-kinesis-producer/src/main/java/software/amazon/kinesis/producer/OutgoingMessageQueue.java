@@ -0,0 +1,114 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package software.amazon.kinesis.producer;
+
+import software.amazon.kinesis.producer.protobuf.Messages.Message;
+
+import java.util.concurrent.BlockingQueue;
+import java.util.concurrent.LinkedBlockingQueue;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * Messages waiting to be sent to the child process, honoring backpressure from it.
+ *
+ * While the child is paused, messages taken off the queue are held back in order. Once one message is held, every
+ * message after it is held too, so a flush barrier or configuration update never overtakes records submitted before
+ * it. Credentials and metrics requests are the exception: they don't depend on the order of records, and the child
+ * may need fresh credentials to drain the records that paused it.
+ *
+ * Outside of a pause the queue is unbounded, as the child's memory budget bounds what it accepts. During a pause,
+ * putting another ordered message blocks once the queue holds maxPausedMessages, until the child resumes or the
+ * queue is closed.
+ */
+class OutgoingMessageQueue {
+    static final int DEFAULT_MAX_PAUSED_MESSAGES = 100_000;
+    private static final long PAUSED_POLL_MILLIS = 100;
+
+    private final BlockingQueue<Message> queue = new LinkedBlockingQueue<>();
+    private final BlockingQueue<Message> held = new LinkedBlockingQueue<>();
+    private final int maxPausedMessages;
+    private volatile boolean paused = false;
+    private volatile boolean closed = false;
+
+    OutgoingMessageQueue() {
+        this(DEFAULT_MAX_PAUSED_MESSAGES);
+    }
+
+    OutgoingMessageQueue(int maxPausedMessages) {
+        this.maxPausedMessages = maxPausedMessages;
+    }
+
+    /**
+     * Adds a message to the queue, blocking while paused and full.
+     *
+     * @return false if the queue was closed, in which case the message is dropped
+     */
+    public boolean put(Message m) throws InterruptedException {
+        if (paused && isOrdered(m)) {
+            synchronized (this) {
+                while (!closed && paused && size() >= maxPausedMessages) {
+                    wait();
+                }
+            }
+        }
+        if (closed) {
+            return false;
+        }
+        queue.put(m);
+        return true;
+    }
+
+    /**
+     * Next message to send. If there are none, this method blocks until there is one while not paused, and returns
+     * null after a short wait while paused so that a resume is noticed.
+     */
+    public Message next() throws InterruptedException {
+        if (!paused && !held.isEmpty()) {
+            return held.poll();
+        }
+        Message m = paused ? queue.poll(PAUSED_POLL_MILLIS, TimeUnit.MILLISECONDS) : queue.take();
+        if (m != null && isOrdered(m) && (paused || !held.isEmpty())) {
+            held.add(m);
+            return null;
+        }
+        return m;
+    }
+
+    public boolean isPaused() {
+        return paused;
+    }
+
+    public synchronized void setPaused(boolean paused) {
+        this.paused = paused;
+        notifyAll();
+    }
+
+    /**
+     * Releases blocked and future puts, which then return false.
+     */
+    public synchronized void close() {
+        closed = true;
+        notifyAll();
+    }
+
+    public int size() {
+        return queue.size() + held.size();
+    }
+
+    private static boolean isOrdered(Message m) {
+        return !m.hasSetCredentials() && !m.hasMetricsRequest();
+    }
+}
@@ -0,0 +1,167 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+package software.amazon.kinesis.producer;
+
+import software.amazon.kinesis.producer.protobuf.Config;
+
+/**
+ * Settings that replace those of {@link KinesisProducerConfiguration} for some
+ * streams. Only the settings that are set here are replaced; each has the same
+ * meaning and limits as the setting of the same name in
+ * KinesisProducerConfiguration.
+ *
+ * <p>
+ * The stream is either a stream name, or a prefix of stream names when it
+ * ends with '*'. If several overrides match a stream, the one naming it
+ * exactly is used, or failing that the one with the longest prefix.
+ * Overrides are not merged.
+ *
+ * @see KinesisProducerConfiguration#addStreamOverride(StreamOverride)
+ */
+public class StreamOverride {
+    private final Config.StreamOverride.Builder builder = Config.StreamOverride.newBuilder();
+
+    /**
+     * @param stream
+     *            Stream name, or prefix ending with '*'.
+     */
+    public StreamOverride(String stream) {
+        if (stream == null || stream.isEmpty()) {
+            throw new IllegalArgumentException("stream must not be empty");
+        }
+        builder.setStream(stream);
+    }
+
+    public String getStream() {
+        return builder.getStream();
+    }
+
+    /**
+     * @see KinesisProducerConfiguration#setAggregationEnabled(boolean)
+     */
+    public StreamOverride setAggregationEnabled(boolean val) {
+        builder.setAggregationEnabled(val);
+        return this;
+    }
+
+    /**
+     * @see KinesisProducerConfiguration#setAggregationMaxCount(long)
+     */
+    public StreamOverride setAggregationMaxCount(long val) {
+        if (val < 1L || val > 9223372036854775807L) {
+            throw new IllegalArgumentException("aggregationMaxCount must be between 1 and 9223372036854775807, got " + val);
+        }
+        builder.setAggregationMaxCount(val);
+        return this;
+    }
+
+    /**
+     * @see KinesisProducerConfiguration#setAggregationMaxSize(long)
+     */
+    public StreamOverride setAggregationMaxSize(long val) {
+        if (val < 64L || val > 10485760L) {
+            throw new IllegalArgumentException("aggregationMaxSize must be between 64 and 10485760, got " + val);
+        }
+        builder.setAggregationMaxSize(val);
+        return this;
+    }
+
+    /**
+     * @see KinesisProducerConfiguration#setCollectionMaxCount(long)
+     */
+    public StreamOverride setCollectionMaxCount(long val) {
+        if (val < 1L || val > 500L) {
+            throw new IllegalArgumentException("collectionMaxCount must be between 1 and 500, got " + val);
+        }
+        builder.setCollectionMaxCount(val);
+        return this;
+    }
+
+    /**
+     * @see KinesisProducerConfiguration#setCollectionMaxSize(long)
+     */
+    public StreamOverride setCollectionMaxSize(long val) {
+        if (val < 52224L || val > 9223372036854775807L) {
+            throw new IllegalArgumentException("collectionMaxSize must be between 52224 and 9223372036854775807, got " + val);
+        }
+        builder.setCollectionMaxSize(val);
+        return this;
+    }
+
+    /**
+     * @see KinesisProducerConfiguration#setRateLimit(long)
+     */
+    public StreamOverride setRateLimit(long val) {
+        if (val < 1L || val > 9223372036854775807L) {
+            throw new IllegalArgumentException("rateLimit must be between 1 and 9223372036854775807, got " + val);
+        }
+        builder.setRateLimit(val);
+        return this;
+    }
+
+    /**
+     * @see KinesisProducerConfiguration#setRecordMaxBufferedTime(long)
+     */
+    public StreamOverride setRecordMaxBufferedTime(long val) {
+        if (val < 0L || val > 9223372036854775807L) {
+            throw new IllegalArgumentException("recordMaxBufferedTime must be between 0 and 9223372036854775807, got " + val);
+        }
+        builder.setRecordMaxBufferedTime(val);
+        return this;
+    }
+
+    /**
+     * @see KinesisProducerConfiguration#setRecordTtl(long)
+     */
+    public StreamOverride setRecordTtl(long val) {
+        if (val < 100L || val > 9223372036854775807L) {
+            throw new IllegalArgumentException("recordTtl must be between 100 and 9223372036854775807, got " + val);
+        }
+        builder.setRecordTtl(val);
+        return this;
+    }
+
+    /**
+     * @see KinesisProducerConfiguration#setDirectSend(boolean)
+     */
+    public StreamOverride setDirectSend(boolean val) {
+        builder.setDirectSend(val);
+        return this;
+    }
+
+    /**
+     * @see KinesisProducerConfiguration#setDirectSendMaxInFlight(long)
+     */
+    public StreamOverride setDirectSendMaxInFlight(long val) {
+        if (val < 1L || val > 1024L) {
+            throw new IllegalArgumentException("directSendMaxInFlight must be between 1 and 1024, got " + val);
+        }
+        builder.setDirectSendMaxInFlight(val);
+        return this;
+    }
+
+    /**
+     * @see KinesisProducerConfiguration#setAdaptiveLinger(boolean)
+     */
+    public StreamOverride setAdaptiveLinger(boolean val) {
+        builder.setAdaptiveLinger(val);
+        return this;
+    }
+
+    Config.StreamOverride toProtobufMessage() {
+        return builder.build();
+    }
+}
@@ -20,6 +20,7 @@ import org.junit.Test;
 import org.slf4j.Logger;
 import org.slf4j.LoggerFactory;
 import software.amazon.awssdk.auth.credentials.DefaultCredentialsProvider;
+import software.amazon.kinesis.producer.protobuf.Config;
 
 import java.io.ByteArrayOutputStream;
 import java.io.File;
@@ -27,6 +28,7 @@ import java.util.Properties;
 import java.util.UUID;
 
 import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
 import static org.junit.Assert.assertNotNull;
 
 public class KinesisProducerConfigurationTest {
@@ -141,4 +143,35 @@ public class KinesisProducerConfigurationTest {
 
         assertNotNull(cfg.getGlueSchemaRegistryCredentialsProvider());
     }
+
+    @Test
+    public void streamOverridesAreSent() {
+        KinesisProducerConfiguration cfg = new KinesisProducerConfiguration()
+                .addStreamOverride(new StreamOverride("clicks-*")
+                        .setAggregationMaxSize(1048576)
+                        .setRecordMaxBufferedTime(500))
+                .addStreamOverride(new StreamOverride("alerts")
+                        .setAggregationEnabled(false)
+                        .setRecordMaxBufferedTime(10));
+
+        Config.Configuration c = cfg.toProtobufMessage().getConfiguration();
+        assertEquals(2, c.getStreamOverridesCount());
+
+        Config.StreamOverride clicks = c.getStreamOverrides(0);
+        assertEquals("clicks-*", clicks.getStream());
+        assertEquals(1048576, clicks.getAggregationMaxSize());
+        assertEquals(500, clicks.getRecordMaxBufferedTime());
+        assertFalse(clicks.hasAggregationEnabled());
+        assertFalse(clicks.hasRecordTtl());
+
+        Config.StreamOverride alerts = c.getStreamOverrides(1);
+        assertEquals("alerts", alerts.getStream());
+        assertFalse(alerts.getAggregationEnabled());
+        assertEquals(10, alerts.getRecordMaxBufferedTime());
+    }
+
+    @Test(expected = IllegalArgumentException.class)
+    public void streamOverrideValidatesValues() {
+        new StreamOverride("alerts").setCollectionMaxCount(501);
+    }
 }
@@ -0,0 +1,144 @@
+/*
+ * Copyright 2025 Amazon.com, Inc. or its affiliates.
+ * Licensed under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package software.amazon.kinesis.producer;
+
+import com.google.protobuf.ByteString;
+import org.junit.Test;
+import software.amazon.kinesis.producer.protobuf.Messages.Flush;
+import software.amazon.kinesis.producer.protobuf.Messages.Message;
+import software.amazon.kinesis.producer.protobuf.Messages.MetricsRequest;
+import software.amazon.kinesis.producer.protobuf.Messages.PutRecord;
+
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.atomic.AtomicBoolean;
+
+import static org.junit.Assert.assertEquals;
+import static org.junit.Assert.assertFalse;
+import static org.junit.Assert.assertNull;
+import static org.junit.Assert.assertTrue;
+
+public class OutgoingMessageQueueTest {
+
+    @Test
+    public void flushBarrierStaysBehindHeldRecords() throws Exception {
+        OutgoingMessageQueue queue = new OutgoingMessageQueue();
+        queue.put(putRecord(1));
+        assertEquals(1, queue.next().getId());
+
+        queue.setPaused(true);
+        queue.put(putRecord(2));
+        queue.put(flushBarrier(3));
+        queue.put(putRecord(4));
+        assertNull(queue.next());
+        assertNull(queue.next());
+        assertNull(queue.next());
+        assertNull(queue.next());
+        assertEquals(3, queue.size());
+
+        queue.setPaused(false);
+        assertEquals(2, queue.next().getId());
+        assertEquals(3, queue.next().getId());
+        assertEquals(4, queue.next().getId());
+        assertEquals(0, queue.size());
+    }
+
+    @Test
+    public void metricsRequestsAreNotHeld() throws Exception {
+        OutgoingMessageQueue queue = new OutgoingMessageQueue();
+        queue.setPaused(true);
+        queue.put(putRecord(1));
+        queue.put(Message.newBuilder().setId(2).setMetricsRequest(MetricsRequest.newBuilder().build()).build());
+        assertNull(queue.next());
+        assertEquals(2, queue.next().getId());
+
+        queue.setPaused(false);
+        assertEquals(1, queue.next().getId());
+    }
+
+    @Test
+    public void resumeDrainsHeldMessagesBeforeNewOnes() throws Exception {
+        OutgoingMessageQueue queue = new OutgoingMessageQueue();
+        queue.setPaused(true);
+        queue.put(flushBarrier(1));
+        assertNull(queue.next());
+
+        queue.setPaused(false);
+        queue.put(putRecord(2));
+        assertEquals(1, queue.next().getId());
+        assertEquals(2, queue.next().getId());
+    }
+
+    @Test
+    public void putBlocksWhilePausedAndFull() throws Exception {
+        OutgoingMessageQueue queue = new OutgoingMessageQueue(2);
+        queue.setPaused(true);
+        assertTrue(queue.put(putRecord(1)));
+        assertTrue(queue.put(putRecord(2)));
+        assertTrue(queue.put(Message.newBuilder().setId(3).setMetricsRequest(MetricsRequest.newBuilder().build()).build()));
+
+        CountDownLatch added = new CountDownLatch(1);
+        Thread putter = new Thread(() -> {
+            try {
+                queue.put(putRecord(4));
+                added.countDown();
+            } catch (InterruptedException e) {
+                Thread.currentThread().interrupt();
+            }
+        });
+        putter.start();
+        assertFalse(added.await(200, TimeUnit.MILLISECONDS));
+
+        queue.setPaused(false);
+        assertTrue(added.await(5, TimeUnit.SECONDS));
+        putter.join();
+        assertEquals(4, queue.size());
+    }
+
+    @Test
+    public void closeReleasesBlockedPut() throws Exception {
+        OutgoingMessageQueue queue = new OutgoingMessageQueue(1);
+        queue.setPaused(true);
+        assertTrue(queue.put(putRecord(1)));
+
+        AtomicBoolean result = new AtomicBoolean(true);
+        Thread putter = new Thread(() -> {
+            try {
+                result.set(queue.put(putRecord(2)));
+            } catch (InterruptedException e) {
+                Thread.currentThread().interrupt();
+            }
+        });
+        putter.start();
+        queue.close();
+        putter.join(5000);
+        assertFalse(putter.isAlive());
+        assertFalse(result.get());
+        assertEquals(1, queue.size());
+    }
+
+    private static Message putRecord(long id) {
+        PutRecord pr = PutRecord.newBuilder()
+                .setStreamName("myStream")
+                .setPartitionKey("pk")
+                .setData(ByteString.copyFromUtf8("data"))
+                .build();
+        return Message.newBuilder().setId(id).setPutRecord(pr).build();
+    }
+
+    private static Message flushBarrier(long id) {
+        return Message.newBuilder().setId(id).setFlush(Flush.newBuilder().setFlushId(id).build()).build();
+    }
+}